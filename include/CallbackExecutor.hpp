@@ -0,0 +1,169 @@
+/**
+ * @file CallbackExecutor.hpp
+ * @brief Fixed worker pool that runs endpoint callbacks with per-endpoint
+ * ordering.
+ *
+ * By default every ProtocolEndpoint owns a dispatcher thread. Hosts that talk
+ * to many boards end up with dozens of mostly idle threads. A CallbackExecutor
+ * replaces them with a small shared pool: each endpoint registers a
+ * CallbackExecutor::Strand, and the pool guarantees that a strand is never
+ * drained by two workers at the same time, so callbacks of one endpoint keep
+ * their order while different endpoints run in parallel.
+ *
+ * Example:
+ * @code{.cpp}
+ * proto::CallbackExecutor executor(2);
+ * MyEndpoint ep1;
+ * MyEndpoint ep2;
+ * ep1.attach_executor(executor);
+ * ep2.attach_executor(executor);
+ * @endcode
+ *
+ * @warning The executor must outlive every endpoint attached to it.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace proto {
+
+class CallbackExecutor {
+ public:
+  /**
+   * @class Strand
+   * @brief Serial work queue of a single endpoint.
+   *
+   * The owner provides two hooks: @p drain processes pending work (it may stop
+   * early to let other strands run) and @p has_pending reports whether more
+   * work is waiting. post() must be called after new work was published.
+   * Destroying the strand detaches it and waits for a running drain to end.
+   */
+  class Strand {
+   public:
+    Strand(CallbackExecutor& executor, std::function<void()> drain,
+           std::function<bool()> has_pending)
+        : m_executor(executor),
+          m_drain(std::move(drain)),
+          m_has_pending(std::move(has_pending)) {}
+    ~Strand() { m_executor.detach(*this); }
+
+    Strand(const Strand&) = delete;
+    Strand(Strand&&) = delete;
+    auto operator=(const Strand&) -> Strand& = delete;
+    auto operator=(Strand&&) -> Strand& = delete;
+
+    /// @brief Schedule the strand; cheap when it is already scheduled.
+    void post() {
+      if (!m_scheduled.load()) {
+        m_executor.schedule(*this);
+      }
+    }
+
+   private:
+    friend class CallbackExecutor;
+    CallbackExecutor& m_executor;
+    std::function<void()> m_drain;
+    std::function<bool()> m_has_pending;
+    // Written under the executor mutex, read lock-free by post().
+    std::atomic<bool> m_scheduled{false};
+    bool m_active{false};
+    bool m_detached{false};
+  };
+
+  /**
+   * @brief Start the worker pool.
+   * @param THREADS Number of workers (at least one).
+   */
+  explicit CallbackExecutor(
+      const size_t THREADS = std::max(2U, std::thread::hardware_concurrency()))
+      : m_workers(std::max<size_t>(THREADS, 1)) {
+    for (auto& worker : m_workers) {
+      worker = std::thread([this] { worker_loop(); });
+    }
+  }
+
+  ~CallbackExecutor() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_running = false;
+    }
+    m_ready_cv.notify_all();
+    for (auto& worker : m_workers) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  CallbackExecutor(const CallbackExecutor&) = delete;
+  auto operator=(const CallbackExecutor&) -> CallbackExecutor& = delete;
+
+  /// @brief Number of worker threads.
+  [[nodiscard]] auto size() const -> size_t { return m_workers.size(); }
+
+ private:
+  std::mutex m_mutex;
+  std::condition_variable m_ready_cv;
+  std::condition_variable m_idle_cv;
+  std::deque<Strand*> m_ready;
+  bool m_running{true};
+  std::vector<std::thread> m_workers;
+
+  void schedule(Strand& strand) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (strand.m_scheduled.load() || strand.m_detached) {
+        return;
+      }
+      strand.m_scheduled.store(true);
+      m_ready.push_back(&strand);
+    }
+    m_ready_cv.notify_one();
+  }
+
+  // Remove the strand from the ready queue and wait until no worker runs it.
+  // Must not be called from inside the strand's own drain hook.
+  void detach(Strand& strand) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    strand.m_detached = true;
+    m_ready.erase(std::remove(m_ready.begin(), m_ready.end(), &strand),
+                  m_ready.end());
+    m_idle_cv.wait(lock, [&strand] { return !strand.m_active; });
+  }
+
+  void worker_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      m_ready_cv.wait(lock, [this] { return !m_running || !m_ready.empty(); });
+      if (!m_running) {
+        break;
+      }
+      Strand* strand = m_ready.front();
+      m_ready.pop_front();
+      strand->m_active = true;
+      lock.unlock();
+      strand->m_drain();
+      lock.lock();
+      strand->m_active = false;
+      strand->m_scheduled.store(false);
+      // Work published after the drain finished but before m_scheduled was
+      // cleared did not post the strand, so look for it here.
+      if (!strand->m_detached && strand->m_has_pending()) {
+        strand->m_scheduled.store(true);
+        m_ready.push_back(strand);
+        m_ready_cv.notify_one();
+      }
+      m_idle_cv.notify_all();
+    }
+  }
+};
+
+}  // namespace proto
@@ -0,0 +1,135 @@
+/**
+ * @file CallbackList.hpp
+ * @brief Copy-on-write list of weak callbacks, read without locks.
+ *
+ * Receive paths call their subscribers from I/O threads while users add
+ * subscribers at any time. The list is an immutable snapshot behind an atomic
+ * pointer: for_each() walks the current snapshot without taking a lock, add()
+ * and prune() publish a new snapshot under a writer mutex.
+ *
+ * A replaced snapshot is freed once no reader is inside for_each(); until then
+ * it waits in a retired list, so a writer never blocks on readers.
+ *
+ * Example:
+ * @code{.cpp}
+ * CallbackList<CallbackType> callbacks;
+ * auto delegate = callbacks.add(std::make_shared<CallbackType>(handler));
+ * callbacks.for_each([&](CallbackType& callback) { callback(data, read); });
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace proto {
+
+template <typename Callback>
+class CallbackList {
+ public:
+  using List = std::vector<std::weak_ptr<Callback>>;
+
+  CallbackList() = default;
+  ~CallbackList() {
+    delete current_.load();
+    for (const List* list : retired_) {
+      delete list;
+    }
+  }
+
+  CallbackList(const CallbackList&) = delete;
+  auto operator=(const CallbackList&) -> CallbackList& = delete;
+
+  /// @brief Publish a snapshot with @p callback added; safe during for_each().
+  void add(const std::shared_ptr<Callback>& callback) {
+    std::lock_guard lock(write_mtx_);
+    List* list = live_copy_locked();
+    list->push_back(callback);
+    publish_locked(list);
+  }
+
+  /**
+   * @brief Call @p fn for every live callback, the newest first.
+   *
+   * Lock-free: a reader only bumps a counter and loads the snapshot pointer.
+   * Expired entries are skipped and pruned after the walk.
+   */
+  template <typename Fn>
+  void for_each(Fn&& fn) {
+    readers_.fetch_add(1);
+    const List* list = current_.load();
+    bool expired = false;
+    if (list != nullptr) {
+      for (auto it = list->rbegin(); it != list->rend(); ++it) {
+        if (auto callback = it->lock()) {
+          fn(*callback);
+        } else {
+          expired = true;
+        }
+      }
+    }
+    readers_.fetch_sub(1);
+    if (expired) {
+      prune();
+    }
+  }
+
+  /// @brief Publish a snapshot without expired entries; add() drops them too.
+  void prune() {
+    // другой писатель уже публикует список; хватит и следующего прохода
+    std::unique_lock lock(write_mtx_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return;
+    }
+    if (current_.load() != nullptr) {
+      publish_locked(live_copy_locked());
+    }
+  }
+
+  /// @brief Number of entries in the current snapshot, expired ones included.
+  [[nodiscard]] auto size() const -> size_t {
+    readers_.fetch_add(1);
+    const List* list = current_.load();
+    const size_t SIZE = list != nullptr ? list->size() : 0;
+    readers_.fetch_sub(1);
+    return SIZE;
+  }
+
+  [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+ private:
+  std::atomic<const List*> current_{nullptr};
+  mutable std::atomic<unsigned> readers_{0};
+  std::mutex write_mtx_;
+  std::vector<const List*> retired_;  // guarded by write_mtx_
+
+  auto live_copy_locked() const -> List* {
+    auto* list = new List();
+    if (const List* old = current_.load()) {
+      list->reserve(old->size() + 1);
+      for (const auto& callback : *old) {
+        if (!callback.expired()) {
+          list->push_back(callback);
+        }
+      }
+    }
+    return list;
+  }
+
+  // Both sides are sequentially consistent: a reader that increments
+  // readers_ after the writer saw zero also loads the new snapshot, so
+  // every retired one is unreachable.
+  void publish_locked(const List* list) {
+    retired_.push_back(current_.exchange(list));
+    if (readers_.load() == 0) {
+      for (const List* old : retired_) {
+        delete old;
+      }
+      retired_.clear();
+    }
+  }
+};
+}  // namespace proto
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <type_traits>
 
 #include "CustomSpan.hpp"
 
@@ -12,3 +13,17 @@ class ICrc {
   virtual auto calc(CustomSpan<uint8_t>) -> uint32_t = 0;
   virtual auto append(uint32_t, CustomSpan<uint8_t>) -> uint32_t = 0;
 };
+
+/**
+ * @brief Accumulator a frame's first append() starts from.
+ *
+ * TCrc::INITIAL when the policy declares one (CRC-16/MODBUS starts at
+ * 0xFFFF), otherwise 0, which suits CRC-32 style policies that invert the
+ * register inside append().
+ */
+template <typename TCrc, typename = void>
+struct CrcInitial : std::integral_constant<uint32_t, 0> {};
+
+template <typename TCrc>
+struct CrcInitial<TCrc, std::void_t<decltype(TCrc::INITIAL)>>
+    : std::integral_constant<uint32_t, TCrc::INITIAL> {};
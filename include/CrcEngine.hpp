@@ -0,0 +1,288 @@
+/**
+ * @file CrcEngine.hpp
+ * @brief Table-driven CRC for any parameter set of the Rocksoft model
+ * (width, polynomial, init, input/output reflection, final xor), resolved
+ * entirely at compile time.
+ *
+ * The tables are constexpr data generated by the compiler, one copy per
+ * parameter set, and the engine has no state and no virtual functions. As
+ * the TCrc of RxContainer/TxContainer every call is inlined:
+ *
+ * @code{.cpp}
+ * using Crc16Xmodem = CrcEngine<16, 0x1021, 0x0000, false, false, 0x0000>;
+ * using Rx = proto::RxContainer<Fields, Crc16Xmodem>;
+ * @endcode
+ *
+ * Values passed to and returned by append() are finished CRCs: a frame
+ * starts from INITIAL (the CRC of no bytes), and append(append(INITIAL, a),
+ * b) equals the CRC of a followed by b. combine() gets the same value from
+ * the CRCs of a and b alone, so pieces of a buffer can be checksummed apart,
+ * e.g. on several threads (see CrcParallel.hpp).
+ */
+
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "CustomSpan.hpp"
+
+namespace crc_engine_detail {
+/// @brief Low @p width bits of @p value in reverse order.
+constexpr auto reflect(uint32_t value, const unsigned width) -> uint32_t {
+  uint32_t result = 0;
+  for (unsigned i = 0; i < width; ++i) {
+    result = result << 1 | (value & 1U);
+    value >>= 1;
+  }
+  return result;
+}
+
+/// @brief Bytes per table-driven step: one 64-bit word for registers up to
+/// 16 bits, two for 32-bit ones, where the extra lookups still pay off.
+constexpr auto default_slices(const unsigned width) -> size_t {
+  return width > 16 ? 16 : 8;
+}
+}  // namespace crc_engine_detail
+
+/**
+ * @tparam WIDTH    CRC width in bits, 8..32.
+ * @tparam POLY     Generator polynomial, normal (MSB-first) notation.
+ * @tparam INIT     Register value before the first byte, normal notation.
+ * @tparam REF_IN   Bytes enter LSB first.
+ * @tparam REF_OUT  Register is reflected before the final xor.
+ * @tparam XOR_OUT  Value xored into the result.
+ * @tparam SLICES   Bytes per step of the main loop, i.e. number of 256-entry
+ *                  tables; 1 keeps a single table for small targets.
+ */
+template <unsigned WIDTH, uint32_t POLY, uint32_t INIT, bool REF_IN,
+          bool REF_OUT, uint32_t XOR_OUT,
+          size_t SLICES = crc_engine_detail::default_slices(WIDTH)>
+class CrcEngine {
+  static_assert(WIDTH >= 8 && WIDTH <= 32, "CRC width must be 8..32 bits");
+
+ public:
+  /// Smallest unsigned type holding the register.
+  using Reg = std::conditional_t<
+      WIDTH <= 8, uint8_t, std::conditional_t<WIDTH <= 16, uint16_t, uint32_t>>;
+  static constexpr unsigned REG_BITS = sizeof(Reg) * CHAR_BIT;
+  static constexpr uint32_t MASK =
+      WIDTH == 32 ? UINT32_MAX : (uint32_t{1} << WIDTH) - 1;
+
+  static_assert(SLICES == 1 || SLICES >= sizeof(Reg),
+                "a step must cover the whole register");
+
+  /// CRC of no bytes: the value a frame's first append() starts from.
+  static constexpr uint32_t INITIAL =
+      ((REF_OUT ? crc_engine_detail::reflect(INIT, WIDTH) : INIT) ^ XOR_OUT) &
+      MASK;
+
+  /// @brief Nothing to reset: the accumulator is the argument of append().
+  void reset() {}
+
+  auto calc(const CustomSpan<uint8_t> DATA) const -> uint32_t {
+    return compute(INITIAL, DATA.data(), DATA.size());
+  }
+
+  auto append(const uint32_t CRC, const CustomSpan<uint8_t> DATA) const
+      -> uint32_t {
+    return compute(CRC, DATA.data(), DATA.size());
+  }
+
+  /// @brief Continue the finished CRC @p crc over @p size bytes.
+  static constexpr auto compute(const uint32_t CRC, const uint8_t* data,
+                                size_t size) -> uint32_t {
+    Reg reg = to_reg(CRC);
+    if constexpr (SLICES > 1) {
+      for (; size >= SLICES; size -= SLICES, data += SLICES) {
+        reg = step(reg, data, std::make_index_sequence<SLICES>{});
+      }
+    }
+    for (; size > 0; --size) {
+      reg = byte_step(reg, *data++);
+    }
+    return from_reg(reg);
+  }
+
+  static constexpr auto compute(const uint8_t* data, const size_t SIZE)
+      -> uint32_t {
+    return compute(INITIAL, data, SIZE);
+  }
+
+  /**
+   * @brief CRC of A followed by B from CRC(A), CRC(B) and the length of B,
+   * without touching the bytes: zlib's crc32_combine() for any parameter set.
+   *
+   * Shifting the register over LEN_B zero bytes is a multiplication by
+   * x^(8 * LEN_B) mod POLY, taken from precomputed powers x^(2^k), so the
+   * cost is O(log LEN_B) multiplications of WIDTH steps each.
+   */
+  static constexpr auto combine(const uint32_t CRC_A, const uint32_t CRC_B,
+                                size_t len_b) -> uint32_t {
+    // регистр аффинно зависит от начального значения: B уже посчитан от
+    // INIT, поэтому сдвигается только разность регистра A и INIT
+    uint32_t shifted = to_poly(CRC_A) ^ (INIT & MASK);
+    for (size_t k = 3; len_b != 0 && shifted != 0; len_b >>= 1, ++k) {
+      if ((len_b & 1U) != 0U) {
+        shifted = multiply(shifted, X2N[k]);
+      }
+    }
+    return from_poly(shifted ^ to_poly(CRC_B));
+  }
+
+ private:
+  using Table = std::array<Reg, UINT8_MAX + 1>;
+  using Tables = std::array<Table, SLICES>;
+
+  // The register is kept the way the table loop wants it: reflected in the
+  // low bits for REF_IN, otherwise left-aligned in Reg so the next byte's
+  // index is always its top 8 bits.
+  static constexpr unsigned SHIFT = REF_IN ? 0 : REG_BITS - WIDTH;
+
+  static constexpr auto make_tables() -> Tables {
+    Tables tables{};
+    for (uint32_t i = 0; i <= UINT8_MAX; ++i) {
+      uint32_t reg = 0;
+      if constexpr (REF_IN) {
+        const uint32_t POLY_R = crc_engine_detail::reflect(POLY, WIDTH);
+        reg = i;
+        for (int j = CHAR_BIT; j > 0; --j) {
+          reg = (reg & 1U) != 0U ? (reg >> 1) ^ POLY_R : reg >> 1;
+        }
+      } else {
+        const uint32_t TOP = uint32_t{1} << (REG_BITS - 1);
+        const uint32_t POLY_L = (POLY & MASK) << SHIFT;
+        reg = i << (REG_BITS - CHAR_BIT);
+        for (int j = CHAR_BIT; j > 0; --j) {
+          reg = (reg & TOP) != 0U ? (reg << 1) ^ POLY_L : reg << 1;
+        }
+      }
+      tables[0][i] = static_cast<Reg>(reg);
+    }
+    for (size_t k = 1; k < SLICES; ++k) {
+      for (size_t i = 0; i <= UINT8_MAX; ++i) {
+        const Reg PREV = tables[k - 1][i];
+        tables[k][i] = byte_step_with(tables[0], PREV, 0);
+      }
+    }
+    return tables;
+  }
+
+  static constexpr auto byte_step_with(const Table& table, const Reg REG,
+                                       const uint8_t BYTE) -> Reg {
+    if constexpr (REF_IN) {
+      return static_cast<Reg>((uint32_t{REG} >> CHAR_BIT) ^
+                              table[(REG ^ BYTE) & UINT8_MAX]);
+    } else {
+      return static_cast<Reg>(
+          (uint32_t{REG} << CHAR_BIT) ^
+          table[((uint32_t{REG} >> (REG_BITS - CHAR_BIT)) ^ BYTE) &
+                UINT8_MAX]);
+    }
+  }
+
+  // Byte J of a step, with the register folded into the first bytes
+  template <size_t J>
+  static constexpr auto slice_byte(const Reg REG, const uint8_t* data)
+      -> uint8_t {
+    if constexpr (J >= sizeof(Reg)) {
+      return data[J];
+    } else if constexpr (REF_IN) {
+      return static_cast<uint8_t>(data[J] ^ uint32_t{REG} >> (CHAR_BIT * J));
+    } else {
+      return static_cast<uint8_t>(
+          data[J] ^ uint32_t{REG} >> (REG_BITS - CHAR_BIT * (J + 1)));
+    }
+  }
+
+  // Развёрнуто на этапе компиляции: все SLICES обращений независимы
+  template <size_t... J>
+  static constexpr auto step(const Reg REG, const uint8_t* data,
+                             std::index_sequence<J...> /*unused*/) -> Reg {
+    return static_cast<Reg>(
+        (uint32_t{TABLES[SLICES - 1 - J][slice_byte<J>(REG, data)]} ^ ...));
+  }
+
+  static constexpr auto byte_step(const Reg REG, const uint8_t BYTE) -> Reg {
+    return byte_step_with(TABLES[0], REG, BYTE);
+  }
+
+  // Finished CRC <-> loop register
+  static constexpr auto to_reg(uint32_t crc) -> Reg {
+    crc = (crc ^ XOR_OUT) & MASK;
+    if constexpr (REF_IN != REF_OUT) {
+      crc = crc_engine_detail::reflect(crc, WIDTH);
+    }
+    return static_cast<Reg>(crc << SHIFT);
+  }
+
+  static constexpr auto from_reg(const Reg REG) -> uint32_t {
+    uint32_t crc = uint32_t{REG} >> SHIFT;
+    if constexpr (REF_IN != REF_OUT) {
+      crc = crc_engine_detail::reflect(crc, WIDTH);
+    }
+    return (crc ^ XOR_OUT) & MASK;
+  }
+
+  // Finished CRC <-> register in normal notation, where zero bytes shift
+  // it as a polynomial: r -> r * x^8 mod POLY
+  static constexpr auto to_poly(uint32_t crc) -> uint32_t {
+    crc = (crc ^ XOR_OUT) & MASK;
+    return REF_OUT ? crc_engine_detail::reflect(crc, WIDTH) : crc;
+  }
+
+  static constexpr auto from_poly(uint32_t reg) -> uint32_t {
+    reg = REF_OUT ? crc_engine_detail::reflect(reg, WIDTH) : reg;
+    return (reg ^ XOR_OUT) & MASK;
+  }
+
+  static constexpr auto times_x(const uint32_t VALUE) -> uint32_t {
+    const bool CARRY = ((VALUE >> (WIDTH - 1)) & 1U) != 0U;
+    const uint32_t SHIFTED = (VALUE << 1) & MASK;
+    return CARRY ? SHIFTED ^ (POLY & MASK) : SHIFTED;
+  }
+
+  // a * b mod POLY, Horner over the bits of a from the top
+  static constexpr auto multiply(const uint32_t A, const uint32_t B)
+      -> uint32_t {
+    uint32_t product = 0;
+    for (unsigned i = WIDTH; i > 0; --i) {
+      product = times_x(product);
+      if (((A >> (i - 1)) & 1U) != 0U) {
+        product ^= B;
+      }
+    }
+    return product;
+  }
+
+  // X2N[k] = x^(2^k) mod POLY; combine() needs k up to 3 + bits of size_t
+  using Powers = std::array<uint32_t, 3 + sizeof(size_t) * CHAR_BIT>;
+
+  static constexpr auto make_powers() -> Powers {
+    Powers powers{};
+    powers[0] = times_x(1);
+    for (size_t k = 1; k < powers.size(); ++k) {
+      powers[k] = multiply(powers[k - 1], powers[k - 1]);
+    }
+    return powers;
+  }
+
+  static constexpr Tables TABLES = make_tables();
+  static constexpr Powers X2N = make_powers();
+};
+
+/// CRC-32/ISO-HDLC (zlib, Ethernet): same values as CrcSoft.
+using Crc32IsoHdlc =
+    CrcEngine<32, 0x04C11DB7, 0xFFFFFFFF, true, true, 0xFFFFFFFF>;
+/// CRC-16/MODBUS: same values as Crc16Modbus.
+using Crc16ModbusEngine = CrcEngine<16, 0x8005, 0xFFFF, true, true, 0x0000>;
+/// CRC-16/XMODEM, the CRC of XMODEM/YMODEM blocks.
+using Crc16Xmodem = CrcEngine<16, 0x1021, 0x0000, false, false, 0x0000>;
+/// CRC-16/IBM-3740, often called CRC-16/CCITT-FALSE.
+using Crc16Ccitt = CrcEngine<16, 0x1021, 0xFFFF, false, false, 0x0000>;
+/// CRC-8/SMBUS.
+using Crc8Smbus = CrcEngine<8, 0x07, 0x00, false, false, 0x00>;
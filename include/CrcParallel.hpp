@@ -0,0 +1,74 @@
+/**
+ * @file CrcParallel.hpp
+ * @brief CRC of a large buffer (firmware image, capture file) on several
+ * threads: each thread checksums one contiguous chunk and the partial CRCs
+ * are joined with TCrc::combine().
+ *
+ * Works with every policy that has a static combine(): CrcSoft, Crc16Modbus
+ * and any CrcEngine.
+ *
+ * @code{.cpp}
+ * const uint32_t CRC =
+ *     crc_parallel_calc<CrcSoft>({image.data(), image.size()});
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Crc.hpp"
+#include "CustomSpan.hpp"
+
+/// Smallest chunk worth a thread of its own: below it starting the thread
+/// costs more than checksumming the bytes.
+constexpr size_t CRC_PARALLEL_MIN_CHUNK = 256U << 10U;
+
+/**
+ * @brief Same value as TCrc().calc(DATA), computed on up to @p threads
+ * threads (0: one per hardware thread), the calling one included.
+ *
+ * Buffers shorter than two CRC_PARALLEL_MIN_CHUNK run on the calling thread
+ * alone.
+ */
+template <typename TCrc>
+auto crc_parallel_calc(const CustomSpan<uint8_t> DATA, size_t threads = 0)
+    -> uint32_t {
+  if (threads == 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  threads = std::clamp<size_t>(DATA.size() / CRC_PARALLEL_MIN_CHUNK, 1,
+                               threads);
+  const size_t CHUNK = DATA.size() / threads;
+  auto chunk = [&](const size_t INDEX) {
+    // последний кусок забирает остаток от деления
+    const size_t BEGIN = INDEX * CHUNK;
+    return DATA.subspan(BEGIN, INDEX + 1 == threads ? DATA.size() - BEGIN
+                                                    : CHUNK);
+  };
+
+  std::vector<uint32_t> parts(threads);
+  auto work = [&](const size_t INDEX) {
+    TCrc crc;
+    parts[INDEX] = crc.append(CrcInitial<TCrc>::value, chunk(INDEX));
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (size_t i = 1; i < threads; ++i) {
+    workers.emplace_back(work, i);
+  }
+  work(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  uint32_t crc = parts[0];
+  for (size_t i = 1; i < threads; ++i) {
+    crc = TCrc::combine(crc, parts[i], chunk(i).size());
+  }
+  return crc;
+}
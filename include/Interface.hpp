@@ -5,7 +5,9 @@
 #include <memory>
 #include <string>
 
+#include "CallbackList.hpp"
 #include "CustomSpan.hpp"
+#include "InterfaceStats.hpp"
 
 namespace proto::interface {
 using CallbackType =
@@ -21,19 +23,44 @@ class IInterface {
   virtual auto write(CustomSpan<uint8_t> buffer,
                      std::chrono::milliseconds timeout = 1s) -> bool = 0;
 
+  /**
+   * @brief Frame boundary: push out anything the interface buffered.
+   *
+   * TxContainer calls it after the last field of every frame. Interfaces that
+   * write straight through keep the default no-op.
+   */
+  virtual auto flush() -> bool { return true; }
+
   virtual auto is_open() -> bool = 0;
   virtual auto open() -> bool = 0;
   virtual auto close() -> bool = 0;
+  /**
+   * @brief Subscribe to received bytes; safe while the interface is open.
+   *
+   * The callback stays registered while the returned Delegate lives.
+   *
+   * The interface must outlive every subscriber that can still be called
+   * from it or write to it. A delivery in progress walks a callback snapshot
+   * owned by the interface, so destroying the interface first is a
+   * use-after-free rather than a silent drop: declare interfaces before the
+   * endpoints that use them.
+   */
   [[nodiscard]] virtual auto add_receive_callback(const CallbackType &callback)
       -> Delegate {
     auto callback_ = std::make_shared<CallbackType>(callback);
-    m_callbacks.push_back(callback_);
+    m_callbacks.add(callback_);
     return callback_;
   }
 
+  /// @brief I/O counters; snapshot() is safe from any thread.
+  [[nodiscard]] auto stats() -> InterfaceStats & { return m_stats; }
+
  protected:
   std::string m_name;
-  std::vector<std::weak_ptr<CallbackType>> m_callbacks;
+  /// Read lock-free by the receive paths via for_each().
+  CallbackList<CallbackType> m_callbacks;
+  /// Updated by implementations at each OS read/write and open.
+  InterfaceStats m_stats;
 
  private:
   virtual auto read(uint8_t *buffer, size_t count) -> int = 0;
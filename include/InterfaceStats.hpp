@@ -0,0 +1,258 @@
+/**
+ * @file InterfaceStats.hpp
+ * @brief Always-on I/O counters of an IInterface and optional histograms.
+ *
+ * Counters are relaxed atomics bumped by the I/O threads; receive and send
+ * counters live on separate cache lines because different threads update
+ * them. snapshot() copies everything without stopping those threads, so a
+ * monitoring agent can poll it at any rate.
+ *
+ * Histograms of read sizes and write latencies cost a clock read per write
+ * and are off until enable_histograms() is called.
+ *
+ * Example:
+ * @code{.cpp}
+ * uart.stats().enable_histograms();
+ * const auto SNAP = uart.stats().snapshot();
+ * printf("in %llu B, p99 write %llu ns\n", SNAP.m_bytes_in,
+ *        SNAP.m_write_latency_ns.percentile(0.99));
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace proto::interface {
+
+/**
+ * @brief Log-linear histogram: 16 buckets per power of two.
+ *
+ * Values below 16 are exact, larger ones land in buckets at most 1/16 wide
+ * relative to their value, so percentiles are within ~6%.
+ */
+class LogLinearHistogram {
+ public:
+  static constexpr unsigned SUB_BITS = 4;
+  static constexpr uint64_t SUB_BUCKETS = 1U << SUB_BITS;
+  static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+  static constexpr auto index(const uint64_t VALUE) -> size_t {
+    if (VALUE < SUB_BUCKETS) {
+      return static_cast<size_t>(VALUE);
+    }
+    unsigned top = 63;
+    while ((VALUE >> top) == 0) {
+      --top;
+    }
+    const unsigned SHIFT = top - SUB_BITS;
+    return (SHIFT + 1) * SUB_BUCKETS +
+           static_cast<size_t>((VALUE >> SHIFT) & (SUB_BUCKETS - 1));
+  }
+
+  /// @brief Smallest value that falls into bucket @p INDEX.
+  static constexpr auto lower_bound(const size_t INDEX) -> uint64_t {
+    if (INDEX < SUB_BUCKETS) {
+      return INDEX;
+    }
+    const size_t SHIFT = INDEX / SUB_BUCKETS - 1;
+    return (SUB_BUCKETS + INDEX % SUB_BUCKETS) << SHIFT;
+  }
+
+  void record(const uint64_t VALUE) {
+    counts_[index(VALUE)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto counts() const -> std::vector<uint64_t> {
+    std::vector<uint64_t> counts(BUCKETS);
+    for (size_t i = 0; i < BUCKETS; ++i) {
+      counts[i] = counts_[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, BUCKETS> counts_{};
+};
+
+/// @brief Copy of a LogLinearHistogram; empty when histograms are off.
+struct HistogramSnapshot {
+  std::vector<uint64_t> m_counts;
+
+  [[nodiscard]] auto total() const -> uint64_t {
+    uint64_t total = 0;
+    for (const uint64_t COUNT : m_counts) {
+      total += COUNT;
+    }
+    return total;
+  }
+
+  /// @brief Lower bound of the bucket holding quantile @p Q in [0, 1].
+  [[nodiscard]] auto percentile(const double Q) const -> uint64_t {
+    const uint64_t TOTAL = total();
+    if (TOTAL == 0) {
+      return 0;
+    }
+    const auto RANK =
+        static_cast<uint64_t>(Q * static_cast<double>(TOTAL - 1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts.size(); ++i) {
+      seen += m_counts[i];
+      if (seen > RANK) {
+        return LogLinearHistogram::lower_bound(i);
+      }
+    }
+    return LogLinearHistogram::lower_bound(m_counts.size() - 1);
+  }
+};
+
+struct InterfaceStatsSnapshot {
+  uint64_t m_bytes_in{0};
+  uint64_t m_bytes_out{0};
+  uint64_t m_read_calls{0};   //!< Reads handed to the OS, empty ones included.
+  uint64_t m_write_calls{0};  //!< Writes handed to the OS.
+  uint64_t m_short_writes{0};  //!< Writes that took only part of the data.
+  uint64_t m_eagain{0};        //!< Reads and writes that hit EAGAIN.
+  uint64_t m_reconnects{0};    //!< Opens after the first one.
+  HistogramSnapshot m_read_sizes;
+  HistogramSnapshot m_write_latency_ns;  //!< Per IInterface::write() call.
+};
+
+class InterfaceStats {
+ public:
+  InterfaceStats() = default;
+  InterfaceStats(const InterfaceStats&) = delete;
+  auto operator=(const InterfaceStats&) -> InterfaceStats& = delete;
+  ~InterfaceStats() { delete histograms_.load(); }
+
+  /// @brief A read returned @p COUNT bytes; 0 is an empty read.
+  void on_read(const size_t COUNT) {
+    rx_.m_read_calls.fetch_add(1, std::memory_order_relaxed);
+    if (COUNT > 0) {
+      rx_.m_bytes_in.fetch_add(COUNT, std::memory_order_relaxed);
+      if (auto* histograms = histograms_.load(std::memory_order_acquire)) {
+        histograms->m_read_sizes.record(COUNT);
+      }
+    }
+  }
+
+  void on_read_eagain() {
+    rx_.m_read_calls.fetch_add(1, std::memory_order_relaxed);
+    rx_.m_eagain.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// @brief One write to the OS took @p WRITTEN of @p REQUESTED bytes.
+  void on_write(const size_t REQUESTED, const size_t WRITTEN) {
+    tx_.m_write_calls.fetch_add(1, std::memory_order_relaxed);
+    tx_.m_bytes_out.fetch_add(WRITTEN, std::memory_order_relaxed);
+    if (WRITTEN > 0 && WRITTEN < REQUESTED) {
+      tx_.m_short_writes.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void on_write_eagain() {
+    tx_.m_write_calls.fetch_add(1, std::memory_order_relaxed);
+    tx_.m_eagain.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_open() {
+    if (opened_.exchange(true, std::memory_order_relaxed)) {
+      tx_.m_reconnects.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Times one IInterface::write() call while histograms are on.
+   *
+   * @code{.cpp}
+   * auto timer = m_stats.write_timer();
+   * @endcode
+   */
+  class WriteTimer {
+   public:
+    explicit WriteTimer(LogLinearHistogram* histogram) : histogram_(histogram) {
+      if (histogram_ != nullptr) {
+        start_ = std::chrono::steady_clock::now();
+      }
+    }
+    WriteTimer(const WriteTimer&) = delete;
+    auto operator=(const WriteTimer&) -> WriteTimer& = delete;
+    ~WriteTimer() {
+      if (histogram_ != nullptr) {
+        histogram_->record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_)
+                .count()));
+      }
+    }
+
+   private:
+    LogLinearHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  [[nodiscard]] auto write_timer() -> WriteTimer {
+    auto* histograms = histograms_.load(std::memory_order_acquire);
+    return WriteTimer(histograms != nullptr ? &histograms->m_write_latency
+                                            : nullptr);
+  }
+
+  /// @brief Start (or keep) recording histograms; allocates them once.
+  void enable_histograms() {
+    if (histograms_.load(std::memory_order_acquire) != nullptr) {
+      return;
+    }
+    auto* histograms = new Histograms();
+    Histograms* expected = nullptr;
+    if (!histograms_.compare_exchange_strong(expected, histograms,
+                                             std::memory_order_acq_rel)) {
+      delete histograms;  // другой поток успел первым
+    }
+  }
+
+  [[nodiscard]] auto snapshot() const -> InterfaceStatsSnapshot {
+    InterfaceStatsSnapshot snap;
+    snap.m_bytes_in = rx_.m_bytes_in.load(std::memory_order_relaxed);
+    snap.m_read_calls = rx_.m_read_calls.load(std::memory_order_relaxed);
+    snap.m_bytes_out = tx_.m_bytes_out.load(std::memory_order_relaxed);
+    snap.m_write_calls = tx_.m_write_calls.load(std::memory_order_relaxed);
+    snap.m_short_writes = tx_.m_short_writes.load(std::memory_order_relaxed);
+    snap.m_eagain = rx_.m_eagain.load(std::memory_order_relaxed) +
+                    tx_.m_eagain.load(std::memory_order_relaxed);
+    snap.m_reconnects = tx_.m_reconnects.load(std::memory_order_relaxed);
+    if (const auto* histograms = histograms_.load(std::memory_order_acquire)) {
+      snap.m_read_sizes.m_counts = histograms->m_read_sizes.counts();
+      snap.m_write_latency_ns.m_counts = histograms->m_write_latency.counts();
+    }
+    return snap;
+  }
+
+ private:
+  struct alignas(64) Receive {
+    std::atomic<uint64_t> m_bytes_in{0};
+    std::atomic<uint64_t> m_read_calls{0};
+    std::atomic<uint64_t> m_eagain{0};
+  };
+  struct alignas(64) Send {
+    std::atomic<uint64_t> m_bytes_out{0};
+    std::atomic<uint64_t> m_write_calls{0};
+    std::atomic<uint64_t> m_short_writes{0};
+    std::atomic<uint64_t> m_eagain{0};
+    std::atomic<uint64_t> m_reconnects{0};
+  };
+  struct Histograms {
+    LogLinearHistogram m_read_sizes;
+    LogLinearHistogram m_write_latency;
+  };
+
+  Receive rx_;
+  Send tx_;
+  std::atomic<bool> opened_{false};
+  // Never freed before the stats: I/O threads keep using the pointer.
+  std::atomic<Histograms*> histograms_{nullptr};
+};
+}  // namespace proto::interface
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -30,7 +31,11 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
+#include "CallbackExecutor.hpp"
+#include "CustomSpan.hpp"
+#include "RxQueuePolicy.hpp"
 #include "prototypes/container/RxContainer.hpp"
 #include "prototypes/container/TxContainer.hpp"
 
@@ -42,6 +47,8 @@ namespace proto {
  * @tparam RxFields Protocol RX field set.
  * @tparam TxFields Protocol TX field set.
  * @tparam Crc      CRC type for integrity.
+ * @tparam Projection Snapshot policy: AllFields (default) or
+ * FieldProjection<...> to copy only the fields consumers read.
  *
  * Responsibilities:
  *   - Handles RX/TX containers.
@@ -52,8 +59,16 @@ namespace proto {
  *
  * Lifecycle:
  *   - Construct, wire interfaces, use send/wait methods, query snapshot.
+ *
+ * Callback delivery:
+ *   - By default each endpoint owns a dispatcher thread.
+ *   - Many endpoints can share a CallbackExecutor instead (see
+ * attach_executor()).
+ *   - Snapshots go either one by one to set_receive_callback() or in groups
+ * to set_batch_callback().
  */
-template <class RxFields, class TxFields, class Crc = CrcSoft>
+template <class RxFields, class TxFields, class Crc = CrcSoft,
+          class Projection = AllFields>
 class ProtocolEndpoint {
  public:
   /** @brief RX container type for inbound protocol frames. */
@@ -61,7 +76,9 @@ class ProtocolEndpoint {
   /** @brief TX container type for outbound protocol frames. */
   using TxCont = proto::TxContainer<TxFields, Crc>;
   using ReceiveType = typename RxCont::ReturnType;
-  using RxFieldsSnapshot = typename RxCont::NamedReturnTuple;
+  using RxFieldsSnapshot = typename Projection::template Snapshot<RxCont>;
+  /** @brief Receives every snapshot drained in one wakeup. */
+  using BatchCallback = std::function<void(CustomSpan<RxFieldsSnapshot>)>;
 
   /**
    * @brief Construct endpoint and install a permanent RX callback that
@@ -80,32 +97,92 @@ class ProtocolEndpoint {
     m_deque_thread = std::thread([this] {
       std::unique_lock<std::mutex> lock(m_queue_mutex);
       while (true) {
-        m_queue_cv.wait(lock,
-                        [this] { return !m_running || !m_rx_queue.empty(); });
-        if (!m_running) {
+        m_queue_cv.wait(lock, [this] {
+          return !m_running || m_strand || has_pending_locked();
+        });
+        if (!m_running || m_strand) {
           break;
         }
-        auto val = std::move(m_rx_queue.front());
-        // вызываем без мьютекса
-        lock.unlock();
-        if (m_user_callback) {
-          m_user_callback(std::move(val));
-          m_rx_queue.pop_front();
+        // Let a batch fill up until it is full or its oldest snapshot hits
+        // the latency bound.
+        if (m_batch_callback && m_rx_queue.size() < m_max_batch) {
+          m_queue_cv.wait_until(
+              lock, m_batch_started + m_batch_latency, [this] {
+                return !m_running || m_strand || !m_batch_callback ||
+                       m_rx_queue.size() >= m_max_batch;
+              });
+          if (!m_running || m_strand) {
+            break;
+          }
         }
-        lock.lock();
+        dispatch(lock);
       }
     });
   }
+
+  /**
+   * @brief Construct endpoint that delivers callbacks on a shared executor
+   * instead of its own dispatcher thread.
+   * @param executor Worker pool; must outlive the endpoint.
+   */
+  explicit ProtocolEndpoint(CallbackExecutor& executor, bool debug = false) {
+    set_debug(debug);
+    m_rx_delegate = m_rx.add_receive_callback(m_rx_callback);
+    attach_executor(executor);
+  }
+
   ~ProtocolEndpoint() {
+    m_rx_if_cb.reset();  // интерфейс больше не начинает новых доставок
     {
       std::lock_guard<std::mutex> lock(m_queue_mutex);
       m_running = false;  // если не atomic — тем более делать под мьютексом
     }
     m_queue_cv.notify_all();
+    m_space_cv.notify_all();
 
     if (m_deque_thread.joinable()) {
       m_deque_thread.join();
     }
+    // Rx callbacks that saw m_running may still post to the strand.
+    while (m_rx_active.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+    std::unique_ptr<CallbackExecutor::Strand> strand;
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      strand = std::move(m_strand);
+    }
+    // ~Strand waits for a running drain, which takes m_queue_mutex
+    strand.reset();
+  }
+
+  /**
+   * @brief Move callback delivery from the dedicated thread to @p executor.
+   *
+   * The dedicated dispatcher thread is stopped; snapshots already queued are
+   * delivered by the executor. Callbacks of this endpoint never run
+   * concurrently with each other and keep their order.
+   *
+   * @param executor Worker pool; must outlive the endpoint.
+   * @warning Call once, before traffic starts, and not from a callback.
+   */
+  void attach_executor(CallbackExecutor& executor) {
+    auto strand = std::make_unique<CallbackExecutor::Strand>(
+        executor, [this] { dispatch_pending(); },
+        [this] {
+          std::lock_guard<std::mutex> lock(m_queue_mutex);
+          return has_pending_locked();
+        });
+    CallbackExecutor::Strand* raw = strand.get();
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      m_strand = std::move(strand);
+    }
+    m_queue_cv.notify_all();
+    if (m_deque_thread.joinable()) {
+      m_deque_thread.join();
+    }
+    raw->post();
   }
 
   void set_debug(const bool VALUE) {
@@ -119,6 +196,12 @@ class ProtocolEndpoint {
    * Sets up RX and TX containers to use the provided interfaces.
    * The RX callback feeds incoming byte chunks to rx_.Fill.
    *
+   * Both interfaces must outlive the endpoint. Its dispatcher thread may
+   * still answer through @p tx_if until the destructor has joined it, and
+   * @p rx_if's receive path runs the callback until then. With members,
+   * declare the interfaces before the endpoint so they are destroyed after
+   * it; the other order is a use-after-free.
+   *
    * @param rx_if Interface for receiving data.
    * @param tx_if Interface for transmitting data.
    */
@@ -132,6 +215,8 @@ class ProtocolEndpoint {
   }
   static constexpr std::chrono::duration RECEIVE_TIMEOUT =
       std::chrono::milliseconds{1000};
+  static constexpr std::chrono::milliseconds DEFAULT_BLOCK_TIMEOUT{100};
+  static constexpr size_t DEFAULT_MAX_BATCH = 64;
   template <typename... Infos>
   auto request(Infos&&... infos) -> RxFieldsSnapshot {
     m_received = false;
@@ -153,9 +238,79 @@ class ProtocolEndpoint {
 
   void set_receive_callback(
       std::function<void(RxFieldsSnapshot&&)> user_callback) {
-    m_user_callback = user_callback;
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      m_user_callback = std::move(user_callback);
+    }
+    notify_consumer();
+  }
+
+  /**
+   * @brief Deliver received snapshots in batches instead of one by one.
+   *
+   * Each call gets up to @p MAX_BATCH snapshots in arrival order. The span is
+   * only valid during the call; snapshots may be moved out of it. While a
+   * batch callback is set it replaces the per-snapshot receive callback; pass
+   * nullptr to go back.
+   *
+   * @param callback    Batch consumer, or nullptr.
+   * @param MAX_BATCH   Largest batch handed over in one call.
+   * @param MAX_LATENCY How long the dispatcher thread may hold the oldest
+   * queued snapshot to collect a fuller batch. Zero delivers whatever is
+   * queued at wakeup. Endpoints on a CallbackExecutor never delay and treat
+   * any value as zero.
+   */
+  void set_batch_callback(
+      BatchCallback callback, const size_t MAX_BATCH = DEFAULT_MAX_BATCH,
+      const std::chrono::microseconds MAX_LATENCY =
+          std::chrono::microseconds{0}) {
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      m_batch_callback = std::move(callback);
+      m_max_batch = std::max<size_t>(MAX_BATCH, 1);
+      m_batch_latency = MAX_LATENCY;
+    }
+    notify_consumer();
+  }
+
+  /**
+   * @brief Set the maximum number of snapshots buffered for the user callback.
+   * @param CAPACITY Queue capacity; ignored by OverflowPolicy::GROW. With 0
+   * nothing is queued: every snapshot is dropped and counted, whatever the
+   * other policies say.
+   */
+  void set_queue_capacity(const size_t CAPACITY) {
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      m_max_deque_size = CAPACITY;
+    }
+    m_space_cv.notify_all();
+  }
+
+  /**
+   * @brief Choose what happens when a frame arrives and the queue is full.
+   * @param POLICY        Overflow policy.
+   * @param BLOCK_TIMEOUT Longest time the producer (the interface reader
+   * thread) waits for space with OverflowPolicy::BLOCK before the snapshot is
+   * dropped.
+   */
+  void set_overflow_policy(
+      const OverflowPolicy POLICY,
+      const std::chrono::milliseconds BLOCK_TIMEOUT = DEFAULT_BLOCK_TIMEOUT) {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_overflow_policy = POLICY;
+    m_block_timeout = BLOCK_TIMEOUT;
   }
 
+  /**
+   * @brief Receive queue counters; lock-free, may be polled from any thread.
+   */
+  [[nodiscard]] auto get_queue_stats() const -> RxQueueStats {
+    return m_queue_counters.snapshot();
+  }
+
+  void reset_queue_stats() { m_queue_counters.reset(); }
+
   RxCont m_rx;
   TxCont m_tx;
 
@@ -168,10 +323,143 @@ class ProtocolEndpoint {
   std::mutex m_queue_mutex;
   std::condition_variable m_cv;
   std::condition_variable m_queue_cv;
+  std::condition_variable m_space_cv;
   bool m_received{false};
   std::deque<RxFieldsSnapshot> m_rx_queue;
   interface::Delegate m_rx_if_cb;
   size_t m_max_deque_size = 100;
+  OverflowPolicy m_overflow_policy{OverflowPolicy::DROP_OLDEST};
+  std::chrono::milliseconds m_block_timeout{DEFAULT_BLOCK_TIMEOUT};
+  RxQueueCounters m_queue_counters;
+  BatchCallback m_batch_callback;
+  size_t m_max_batch{DEFAULT_MAX_BATCH};
+  std::chrono::microseconds m_batch_latency{0};
+  // Arrival time of the oldest snapshot in a non-empty queue.
+  std::chrono::steady_clock::time_point m_batch_started;
+  // Reused by the consumer only; keeps its capacity between batches.
+  std::vector<RxFieldsSnapshot> m_batch;
+  // Set when callbacks are delivered by a shared executor.
+  std::unique_ptr<CallbackExecutor::Strand> m_strand;
+  // Rx callbacks past the m_running check; the destructor waits for them.
+  std::atomic<size_t> m_rx_active{0};
+
+  /// Deliveries (snapshots or batches) per executor run before yielding to
+  /// other endpoints.
+  static constexpr size_t MAX_DISPATCH_PER_RUN = 64;
+
+  /// @note Called with m_queue_mutex held.
+  [[nodiscard]] auto has_pending_locked() const -> bool {
+    return !m_rx_queue.empty() && (m_user_callback || m_batch_callback);
+  }
+
+  /**
+   * @brief Deliver one snapshot or one batch, whichever callback is set.
+   * @note Called with m_queue_mutex held by @p lock; returns with it held.
+   */
+  void dispatch(std::unique_lock<std::mutex>& lock) {
+    if (!has_pending_locked()) {
+      return;
+    }
+    if (m_batch_callback) {
+      dispatch_batch(lock);
+    } else {
+      dispatch_one(lock);
+    }
+  }
+
+  /**
+   * @brief Pop one snapshot and hand it to the user callback without holding
+   * the queue lock.
+   * @note Called with m_queue_mutex held by @p lock; returns with it held.
+   */
+  void dispatch_one(std::unique_lock<std::mutex>& lock) {
+    auto val = std::move(m_rx_queue.front());
+    m_rx_queue.pop_front();
+    m_space_cv.notify_one();
+    // вызываем без мьютекса
+    lock.unlock();
+    m_user_callback(std::move(val));
+    lock.lock();
+  }
+
+  /**
+   * @brief Move up to m_max_batch snapshots out of the queue and hand them to
+   * the batch callback without holding the queue lock.
+   * @note Called with m_queue_mutex held by @p lock; returns with it held.
+   */
+  void dispatch_batch(std::unique_lock<std::mutex>& lock) {
+    const size_t COUNT = std::min(m_rx_queue.size(), m_max_batch);
+    m_batch.clear();
+    for (size_t i = 0; i < COUNT; ++i) {
+      m_batch.push_back(std::move(m_rx_queue.front()));
+      m_rx_queue.pop_front();
+    }
+    m_space_cv.notify_all();
+    lock.unlock();
+    m_batch_callback(CustomSpan<RxFieldsSnapshot>(m_batch.data(), COUNT));
+    lock.lock();
+  }
+
+  // Executor hook: deliver a bounded number of snapshots, then yield.
+  void dispatch_pending() {
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    for (size_t i = 0; i < MAX_DISPATCH_PER_RUN && m_running &&
+                       has_pending_locked();
+         ++i) {
+      dispatch(lock);
+    }
+  }
+
+  // Wake whoever delivers callbacks. Must be called without m_queue_mutex.
+  void notify_consumer() {
+    CallbackExecutor::Strand* strand = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      strand = m_strand.get();
+    }
+    if (strand != nullptr) {
+      strand->post();
+    } else {
+      m_queue_cv.notify_all();
+    }
+  }
+
+  /**
+   * @brief Apply the overflow policy before a new snapshot is queued.
+   * @return false if the new snapshot must be dropped.
+   * @note Called with m_queue_mutex held by @p lock.
+   */
+  auto make_room(std::unique_lock<std::mutex>& lock) -> bool {
+    if (m_rx_queue.size() < m_max_deque_size) {
+      return true;
+    }
+    if (m_max_deque_size == 0 && m_overflow_policy != OverflowPolicy::GROW) {
+      // no queue: nothing older to drop and no space to wait for
+      m_queue_counters.on_dropped();
+      return false;
+    }
+    switch (m_overflow_policy) {
+      case OverflowPolicy::DROP_OLDEST:
+        m_rx_queue.pop_front();
+        m_queue_counters.on_dropped();
+        return true;
+      case OverflowPolicy::BLOCK:
+        if (m_space_cv.wait_for(lock, m_block_timeout, [this] {
+              return !m_running || m_rx_queue.size() < m_max_deque_size;
+            }) &&
+            m_running) {
+          return true;
+        }
+        m_queue_counters.on_dropped();
+        return false;
+      case OverflowPolicy::GROW:
+        return true;
+      case OverflowPolicy::DROP_NEWEST:
+      default:
+        m_queue_counters.on_dropped();
+        return false;
+    }
+  }
 
   // One-shot extractor installed by wait_once to pull typed DATA_FIELD while Rx
   // buffer is valid.
@@ -185,20 +473,39 @@ class ProtocolEndpoint {
       container.for_each_type([&](auto& field) { field.print(); });
     }
     if (m_inflight_cb) {
-      m_inflight_cb(container.get_named_copies());
+      m_inflight_cb(Projection::copy(container));
       m_inflight_cb = nullptr;
+      m_received = true;
+      m_cv.notify_all();
     } else {
       std::unique_lock<std::mutex> lock(m_queue_mutex);
-      m_rx_queue.emplace_back(container.get_named_copies());
-      if (m_rx_queue.size() > m_max_deque_size) {
-        // TODO должна быть запись в лог что были потеряны данные
-        m_rx_queue.pop_front();
+      if (!m_running) {
+        return;  // endpoint is being destroyed
+      }
+      if (make_room(lock)) {
+        if (m_rx_queue.empty()) {
+          m_batch_started = std::chrono::steady_clock::now();
+        }
+        m_rx_queue.emplace_back(Projection::copy(container));
+        m_queue_counters.on_enqueued(m_rx_queue.size());
       }
+      CallbackExecutor::Strand* strand = m_strand.get();
+      // A dispatcher thread collecting a batch only cares about the first
+      // snapshot and a full batch; skip the wakeups in between.
+      const bool WAKE = !m_batch_callback || m_rx_queue.size() == 1 ||
+                        m_rx_queue.size() >= m_max_batch;
+      m_rx_active.fetch_add(1, std::memory_order_relaxed);
       lock.unlock();
-      m_queue_cv.notify_all();
+      if (strand != nullptr) {
+        strand->post();
+      } else if (WAKE) {
+        m_queue_cv.notify_all();
+      }
+      m_received = true;
+      m_cv.notify_all();
+      // последнее обращение к endpoint: дальше деструктор может его удалить
+      m_rx_active.fetch_sub(1, std::memory_order_release);
     }
-    m_received = true;
-    m_cv.notify_all();
   }};
 };
 
@@ -25,6 +25,7 @@
 #include <deque>
 #include <functional>
 
+#include "RxQueuePolicy.hpp"
 #include "prototypes/container/RxContainer.hpp"
 #include "prototypes/container/TxContainer.hpp"
 
@@ -36,6 +37,8 @@ namespace proto {
  * @tparam RxFields Protocol RX field set.
  * @tparam TxFields Protocol TX field set.
  * @tparam Crc      CRC type for integrity.
+ * @tparam Projection Snapshot policy: AllFields (default) or
+ * FieldProjection<...> to copy only the fields consumers read.
  *
  * Responsibilities:
  *   - Handles RX/TX containers.
@@ -47,7 +50,8 @@ namespace proto {
  * Lifecycle:
  *   - Construct, wire interfaces, use send/wait methods, query snapshot.
  */
-template <class RxFields, class TxFields, class Crc = CrcSoft>
+template <class RxFields, class TxFields, class Crc = CrcSoft,
+          class Projection = AllFields>
 class ProtocolNoSysEndpoint {
  public:
   /** @brief RX container type for inbound protocol frames. */
@@ -55,7 +59,7 @@ class ProtocolNoSysEndpoint {
   /** @brief TX container type for outbound protocol frames. */
   using TxCont = proto::TxContainer<TxFields, Crc>;
   using ReceiveType = typename RxCont::ReturnType;
-  using RxFieldsSnapshot = typename RxCont::NamedReturnTuple;
+  using RxFieldsSnapshot = typename Projection::template Snapshot<RxCont>;
   std::deque<RxFieldsSnapshot> m_rx_queue;
   size_t m_max_deque_size = 100;
 
@@ -86,18 +90,48 @@ class ProtocolNoSysEndpoint {
     return m_tx.send_packet(std::forward<Infos>(infos)...);
   }
 
-  void receive(CustomSpan<uint8_t> data) { m_rx.fill(data); }
+  void receive(CustomSpan<uint8_t> data) {
+    size_t read = 0;
+    m_rx.fill(data, read);
+  }
 
   void set_receive_callback(
       std::function<void(RxFieldsSnapshot&&)> user_callback) {
     m_user_callback = user_callback;
   }
 
+  /**
+   * @brief Set the maximum number of snapshots kept in m_rx_queue.
+   * @param CAPACITY Queue capacity; ignored by OverflowPolicy::GROW. With 0
+   * nothing is queued: every snapshot is dropped and counted.
+   */
+  void set_queue_capacity(const size_t CAPACITY) {
+    m_max_deque_size = CAPACITY;
+  }
+
+  /**
+   * @brief Choose what happens when a frame arrives and m_rx_queue is full.
+   * @note Without an OS there is nobody to free space while the producer
+   * waits, so OverflowPolicy::BLOCK behaves as OverflowPolicy::DROP_NEWEST.
+   */
+  void set_overflow_policy(const OverflowPolicy POLICY) {
+    m_overflow_policy = POLICY;
+  }
+
+  /// @brief Receive queue counters.
+  [[nodiscard]] auto get_queue_stats() const -> RxQueueStats {
+    return m_queue_counters.snapshot();
+  }
+
+  void reset_queue_stats() { m_queue_counters.reset(); }
+
   RxCont m_rx;
   TxCont m_tx;
 
  protected:
   std::function<void(RxFieldsSnapshot&&)> m_user_callback;
+  OverflowPolicy m_overflow_policy{OverflowPolicy::DROP_OLDEST};
+  RxQueueCounters m_queue_counters;
 
   // Stored delegates to honor [[nodiscard]] on AddReceiveCallback
   typename RxCont::Delegate m_rx_delegate{};
@@ -107,13 +141,26 @@ class ProtocolNoSysEndpoint {
       container.for_each_type([&](auto& field) { field.print(); });
     }
     if (m_user_callback) {
-      m_user_callback(container.get_named_copies());
+      m_user_callback(Projection::copy(container));
     } else {
-      m_rx_queue.emplace_back(container.get_named_copies());
-      if (m_rx_queue.size() > m_max_deque_size) {
-        // TODO должна быть запись в лог что были потеряны данные
-        m_rx_queue.pop_front();
+      if (m_rx_queue.size() >= m_max_deque_size) {
+        switch (m_overflow_policy) {
+          case OverflowPolicy::DROP_OLDEST:
+            m_queue_counters.on_dropped();
+            if (m_rx_queue.empty()) {
+              return;  // capacity 0: nothing older to drop
+            }
+            m_rx_queue.pop_front();
+            break;
+          case OverflowPolicy::GROW:
+            break;
+          default:
+            m_queue_counters.on_dropped();
+            return;
+        }
       }
+      m_rx_queue.emplace_back(Projection::copy(container));
+      m_queue_counters.on_enqueued(m_rx_queue.size());
     }
   }};
 };
@@ -0,0 +1,189 @@
+/**
+ * @file ProtocolStaticEndpoint.hpp
+ * @brief Heap-free protocol endpoint for bare-metal targets.
+ *
+ * ProtocolStaticEndpoint is the allocation-free sibling of
+ * ProtocolNoSysEndpoint. Received snapshots go to a ring sized at compile time
+ * or straight to a plain function pointer, so after construction neither
+ * receive() nor send() touch the heap.
+ *
+ * Usage:
+ *   - Pick a snapshot projection whose fields are trivially copyable (pointer
+ * fields such as a prefix are copied into std::vector and are rejected).
+ *   - Feed bytes with receive(), typically from the UART ISR or main loop.
+ *   - Either install a sink with set_receive_sink() or drain the ring with
+ * poll().
+ *
+ * Example:
+ * @code{.cpp}
+ * using Ep = proto::ProtocolStaticEndpoint<
+ *     Rx, Tx, 8, CrcSoft,
+ *     proto::FieldProjection<FieldName::TYPE_FIELD, FieldName::DATA_FIELD>>;
+ * Ep ep;
+ * ep.m_tx.set_interface(uart);
+ * ep.receive({bytes, count});
+ * Ep::RxFieldsSnapshot snap;
+ * while (ep.poll(snap)) { handle(snap); }
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "RxQueuePolicy.hpp"
+#include "prototypes/container/RxContainer.hpp"
+#include "prototypes/container/TxContainer.hpp"
+
+namespace proto {
+
+/**
+ * @brief True if copying the snapshot never allocates: every value is
+ * trivially copyable (a std::variant of such types included).
+ */
+template <class Snapshot>
+struct IsHeapFreeSnapshot;
+
+template <class... Named>
+struct IsHeapFreeSnapshot<std::tuple<Named...>>
+    : std::bool_constant<(
+          std::is_trivially_copyable_v<decltype(Named::m_value)> && ...)> {};
+
+/**
+ * @brief Protocol endpoint without heap use after construction.
+ *
+ * @tparam RxFields   Protocol RX field set.
+ * @tparam TxFields   Protocol TX field set.
+ * @tparam CAPACITY   Number of snapshots kept in the receive ring.
+ * @tparam Crc        CRC type for integrity.
+ * @tparam Projection Snapshot policy; the resulting snapshot must be heap-free.
+ *
+ * The RX/TX containers, their callback and the ring are set up in the
+ * constructor; that is the only place memory is allocated.
+ *
+ * @warning Not thread-safe and not reentrant. If receive() runs in an ISR,
+ * poll() in the main loop must be called with that interrupt masked.
+ */
+template <class RxFields, class TxFields, size_t CAPACITY, class Crc = CrcSoft,
+          class Projection = AllFields>
+class ProtocolStaticEndpoint {
+ public:
+  /** @brief RX container type for inbound protocol frames. */
+  using RxCont = proto::RxContainer<RxFields, Crc>;
+  /** @brief TX container type for outbound protocol frames. */
+  using TxCont = proto::TxContainer<TxFields, Crc>;
+  using RxFieldsSnapshot = typename Projection::template Snapshot<RxCont>;
+  /**
+   * @brief Plain function sink called for every received snapshot.
+   * @param context Pointer passed to set_receive_sink().
+   */
+  using Sink = void (*)(void* context, const RxFieldsSnapshot& snapshot);
+
+  static_assert(CAPACITY > 0, "Receive ring needs at least one slot");
+  static_assert(IsHeapFreeSnapshot<RxFieldsSnapshot>::value,
+                "Snapshot copies would allocate; use a FieldProjection without "
+                "pointer or vector fields");
+
+  ProtocolStaticEndpoint() {
+    m_rx_delegate = m_rx.add_receive_callback(m_rx_callback);
+  }
+
+  ProtocolStaticEndpoint(const ProtocolStaticEndpoint&) = delete;
+  auto operator=(const ProtocolStaticEndpoint&)
+      -> ProtocolStaticEndpoint& = delete;
+
+  template <typename... Infos>
+  auto send(Infos&&... infos) -> size_t {
+    return m_tx.send_packet(std::forward<Infos>(infos)...);
+  }
+
+  /// @brief Feed received bytes to the parser.
+  void receive(CustomSpan<uint8_t> data) {
+    size_t read = 0;
+    m_rx.fill(data, read);
+  }
+
+  /**
+   * @brief Deliver snapshots to @p sink instead of the ring.
+   * @param sink    Function to call, or nullptr to go back to the ring.
+   * @param context Opaque pointer handed back to @p sink.
+   */
+  void set_receive_sink(const Sink sink, void* context = nullptr) {
+    m_sink = sink;
+    m_sink_context = context;
+  }
+
+  /**
+   * @brief Pop the oldest queued snapshot.
+   * @return false if the ring is empty.
+   */
+  auto poll(RxFieldsSnapshot& out) -> bool {
+    if (m_count == 0) {
+      return false;
+    }
+    out = m_ring[m_head];
+    m_head = (m_head + 1) % CAPACITY;
+    --m_count;
+    return true;
+  }
+
+  [[nodiscard]] auto size() const -> size_t { return m_count; }
+  static constexpr auto capacity() -> size_t { return CAPACITY; }
+
+  /**
+   * @brief Choose what happens when a frame arrives and the ring is full.
+   * @note The ring cannot grow and nothing can free space while receive()
+   * runs, so BLOCK and GROW behave as DROP_NEWEST.
+   */
+  void set_overflow_policy(const OverflowPolicy POLICY) {
+    m_overflow_policy = POLICY;
+  }
+
+  /// @brief Receive ring counters.
+  [[nodiscard]] auto get_queue_stats() const -> RxQueueStats {
+    return m_queue_counters.snapshot();
+  }
+
+  void reset_queue_stats() { m_queue_counters.reset(); }
+
+  RxCont m_rx;
+  TxCont m_tx;
+
+ protected:
+  std::array<RxFieldsSnapshot, CAPACITY> m_ring{};
+  size_t m_head{0};
+  size_t m_count{0};
+  Sink m_sink{nullptr};
+  void* m_sink_context{nullptr};
+  OverflowPolicy m_overflow_policy{OverflowPolicy::DROP_OLDEST};
+  RxQueueCounters m_queue_counters;
+
+  void push(const RxCont& container) {
+    if (m_count == CAPACITY) {
+      m_queue_counters.on_dropped();
+      if (m_overflow_policy != OverflowPolicy::DROP_OLDEST) {
+        return;
+      }
+      m_head = (m_head + 1) % CAPACITY;
+      --m_count;
+    }
+    m_ring[(m_head + m_count) % CAPACITY] = Projection::copy(container);
+    ++m_count;
+    m_queue_counters.on_enqueued(m_count);
+  }
+
+  // Stored delegate to honor [[nodiscard]] on add_receive_callback
+  typename RxCont::Delegate m_rx_delegate{};
+  typename RxCont::CallbackType m_rx_callback{[this](RxCont& container) {
+    if (m_sink != nullptr) {
+      m_sink(m_sink_context, Projection::copy(container));
+    } else {
+      push(container);
+    }
+  }};
+};
+
+}  // namespace proto
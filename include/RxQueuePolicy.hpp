@@ -0,0 +1,78 @@
+/**
+ * @file RxQueuePolicy.hpp
+ * @brief Overflow policy and loss counters for endpoint receive queues.
+ *
+ * Endpoints buffer parsed frames (snapshots) in a bounded queue before handing
+ * them to user code. This header defines what happens when that queue is full
+ * (@ref proto::OverflowPolicy) and a set of lock-free counters that can be
+ * polled from any thread to detect data loss (@ref proto::RxQueueCounters).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace proto {
+
+/**
+ * @enum OverflowPolicy
+ * @brief Behaviour of an endpoint receive queue that reached its capacity.
+ */
+enum class OverflowPolicy : uint8_t {
+  DROP_OLDEST,  //!< Discard the oldest queued snapshot (default).
+  DROP_NEWEST,  //!< Discard the snapshot that is being enqueued.
+  BLOCK,        //!< Block the producer until space is available or timeout.
+                //!< ProtocolNoSysEndpoint has no consumer thread to wait
+                //!< for and treats it as DROP_NEWEST.
+  GROW          //!< Ignore the capacity and keep growing the queue.
+};
+
+/**
+ * @struct RxQueueStats
+ * @brief Plain snapshot of receive queue counters.
+ */
+struct RxQueueStats {
+  uint64_t m_enqueued{};  //!< Snapshots accepted into the queue.
+  uint64_t m_dropped{};   //!< Snapshots lost because the queue was full.
+  size_t m_high_water{};  //!< Largest queue size observed.
+};
+
+/**
+ * @class RxQueueCounters
+ * @brief Atomic counters updated by the producer and polled by monitoring.
+ *
+ * All updates use relaxed ordering: the counters are statistics and do not
+ * synchronize any other data. Reading them never takes the queue lock.
+ */
+class RxQueueCounters {
+ public:
+  void on_enqueued(const size_t QUEUE_SIZE) {
+    m_enqueued.fetch_add(1, std::memory_order_relaxed);
+    if (QUEUE_SIZE > m_high_water.load(std::memory_order_relaxed)) {
+      m_high_water.store(QUEUE_SIZE, std::memory_order_relaxed);
+    }
+  }
+
+  void on_dropped() { m_dropped.fetch_add(1, std::memory_order_relaxed); }
+
+  [[nodiscard]] auto snapshot() const -> RxQueueStats {
+    return {m_enqueued.load(std::memory_order_relaxed),
+            m_dropped.load(std::memory_order_relaxed),
+            m_high_water.load(std::memory_order_relaxed)};
+  }
+
+  void reset() {
+    m_enqueued.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_high_water.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<uint64_t> m_enqueued{0};
+  std::atomic<uint64_t> m_dropped{0};
+  std::atomic<size_t> m_high_water{0};
+};
+
+}  // namespace proto
@@ -109,8 +109,12 @@ class FieldContainer {
    * @brief Construct a FieldContainer.
    *
    * Default constructor initializes all fields and CRC to default state.
+   * Offsets of all field buffers are registered up front, so filling or
+   * sending frames later never inserts into m_offsets (no allocation).
    */
-  FieldContainer() = default;
+  FieldContainer() {
+    for_each_type([this](auto& field) { m_offsets[field.BASE] = 0; });
+  }
 
   /**
    * @brief Tuple type with concrete field instances for this container.
@@ -366,6 +370,47 @@ class FieldContainer {
             normalize_value(std::get<Is>(tup).get_copy())}...};
   }
 
+  /**
+   * @brief Index of the field with the given FieldName in FieldsTuple.
+   * @return SIZE if there is no such field.
+   */
+  template <FieldName NAME, std::size_t Index = 0>
+  static constexpr auto index_of() -> std::size_t {
+    if constexpr (Index >= std::tuple_size_v<FieldsTuple>) {
+      return Index;
+    } else if constexpr (std::tuple_element_t<Index, FieldsTuple>::NAME ==
+                         NAME) {
+      return Index;
+    } else {
+      return index_of<NAME, Index + 1>();
+    }
+  }
+
+  // Tuple of named values for the selected fields only, in the given order
+  template <FieldName... NAMES>
+  using ProjectedTuple = std::tuple<NamedValue<
+      NAMES, _field_copy_t<std::tuple_element_t<index_of<NAMES>(),
+                                                FieldsTuple>>>...>;
+
+  /**
+   * @brief Copy only the selected fields and return a tuple of named values.
+   *
+   * Cheaper than get_named_copies() when a consumer needs a few fields of a
+   * large frame; the result works with meta::get_named<>() the same way.
+   *
+   * @tparam NAMES Fields to copy; each must exist in the container.
+   */
+  template <FieldName... NAMES>
+  [[nodiscard]] auto get_projected_copies() const -> ProjectedTuple<NAMES...> {
+    static_assert((has_field<NAMES>() && ...),
+                  "Projected field is not part of the container");
+    const auto& tup = this->m_fields;
+    return ProjectedTuple<NAMES...>{
+        NamedValue<NAMES, _field_copy_t<std::tuple_element_t<index_of<NAMES>(),
+                                                             FieldsTuple>>>{
+            normalize_value(std::get<index_of<NAMES>()>(tup).get_copy())}...};
+  }
+
  protected:
   /**
    * @brief Debug flag for enabling/disabling protocol debug output.
@@ -428,4 +473,44 @@ class FieldContainer {
   }
 };
 
+/**
+ * @brief Snapshot policy that copies every field of a frame (the default).
+ *
+ * Endpoints use a snapshot policy to turn a received container into the value
+ * handed to user callbacks.
+ */
+struct AllFields {
+  template <class Container>
+  using Snapshot = typename Container::NamedReturnTuple;
+
+  template <class Container>
+  static auto copy(const Container& CONTAINER) -> Snapshot<Container> {
+    return CONTAINER.get_named_copies();
+  }
+};
+
+/**
+ * @brief Snapshot policy that copies only the listed fields.
+ *
+ * Example:
+ * @code{.cpp}
+ * using Ep = ProtocolEndpoint<Rx, Tx, CrcSoft,
+ *     FieldProjection<FieldName::TYPE_FIELD, FieldName::DATA_FIELD>>;
+ * @endcode
+ *
+ * @tparam NAMES Fields kept in the snapshot.
+ */
+template <FieldName... NAMES>
+struct FieldProjection {
+  static_assert(sizeof...(NAMES) > 0, "Projection must keep at least a field");
+
+  template <class Container>
+  using Snapshot = typename Container::template ProjectedTuple<NAMES...>;
+
+  template <class Container>
+  static auto copy(const Container& CONTAINER) -> Snapshot<Container> {
+    return CONTAINER.template get_projected_copies<NAMES...>();
+  }
+};
+
 }  // namespace proto
\ No newline at end of file
@@ -416,6 +416,8 @@ class RxContainer : public FieldContainer<Fields, TCrc> {
    * @requirements TCrc must expose:
    *   - void Reset();
    *   - uint32_t Append(uint32_t, Span<uint8_t>);
+   *   - optionally `static constexpr uint32_t INITIAL`, the value the first
+   *     append starts from (0 otherwise), see CrcInitial.
    *
    * @remarks The CRC width is inferred from the CRC_FIELD storage type when
    * pretty-printing debug values.
@@ -425,7 +427,7 @@ class RxContainer : public FieldContainer<Fields, TCrc> {
     auto crc_in_field =
         *container.template get<FieldName::CRC_FIELD>().get_ptr();
     using crc_type = decltype(crc_in_field);
-    uint32_t crc = 0;
+    uint32_t crc = CrcInitial<TCrc>::value;
     container.m_crc.reset();
 
     container.for_each_type([&](auto& field) {
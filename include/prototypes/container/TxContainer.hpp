@@ -205,6 +205,9 @@ class TxContainer final : public FieldContainer<Fields, TCrc> {
         interface_->write({field.begin(), field.get_size()});
       }
     });
+    if (interface_) {
+      interface_->flush();
+    }
     return total_size;
   }
   /**
@@ -279,7 +282,8 @@ class TxContainer final : public FieldContainer<Fields, TCrc> {
    * @return MatchStatus::MATCH
    *
    * @remark TCrc must expose `Reset()` and
-   *         `Append(uint32_t, Span<uint8_t>) -> uint32_t`.
+   *         `Append(uint32_t, Span<uint8_t>) -> uint32_t`. The first append
+   *         starts from CrcInitial<TCrc> (TCrc::INITIAL if declared, else 0).
    */
   static auto set_crc(void* obj) -> MatchStatus {
     auto& container = *static_cast<TxContainer<Fields, TCrc>*>(obj);
@@ -287,7 +291,7 @@ class TxContainer final : public FieldContainer<Fields, TCrc> {
     container.m_crc.reset();
     // using crc_type =
     //     typename std::remove_reference_t<decltype(crc_field)>::FieldType;
-    uint32_t crc = 0;
+    uint32_t crc = CrcInitial<TCrc>::value;
     container.for_each_type([&](auto& field) {
       using FieldType = std::remove_reference_t<decltype(field)>;
       if constexpr (has_flag(FieldType::FLAGS, FieldFlags::IS_IN_CRC)) {
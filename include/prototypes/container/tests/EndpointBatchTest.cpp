@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <NamedTuple.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CallbackExecutor.hpp"
+#include "Prototypes.hpp"
+#include "libraries/interfaces/Echo.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+using namespace std::chrono_literals;
+
+// Batched delivery of received snapshots: order, batch size limit, latency
+// bound and both dispatch paths (dedicated thread and shared executor).
+
+class EndpointBatchSuite : public testing::Test {
+ protected:
+  static inline uint8_t rx_buffer_[256]{};
+  static inline uint8_t tx_buffer_[256]{};
+
+  using Endpoint = SympleProtocol<rx_buffer_, tx_buffer_>;
+  using Snapshot = Endpoint::RxFieldsSnapshot;
+
+  Endpoint protocol_;
+  interface::EchoInterface interface_{};
+  dataType payload_{1, 2, 3, 4.f, 5.0};
+
+  std::mutex mutex_;
+  std::vector<uint32_t> received_;
+  std::vector<size_t> batches_;
+  std::atomic<size_t> count_{0};
+
+  void SetUp() override {
+    interface_.open();
+    protocol_.set_interfaces(interface_, interface_);
+    protocol_.set_queue_capacity(1U << 16U);
+  }
+
+  void send_frames(const size_t COUNT) {
+    for (size_t i = 0; i < COUNT; ++i) {
+      payload_.u32 = static_cast<uint32_t>(i);
+      protocol_.send(make_field_info<FieldName::DATA_FIELD>(&payload_));
+    }
+  }
+
+  auto collector() -> Endpoint::BatchCallback {
+    return [this](CustomSpan<Snapshot> batch) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batches_.push_back(batch.size());
+      for (auto& snap : batch) {
+        received_.push_back(meta::get_named<FieldName::DATA_FIELD>(snap).u32);
+      }
+      count_ += batch.size();
+    };
+  }
+
+  auto wait_for(const size_t EXPECTED) -> bool {
+    const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+    while (count_ < EXPECTED && std::chrono::steady_clock::now() < DEADLINE) {
+      std::this_thread::sleep_for(1ms);
+    }
+    return count_ == EXPECTED;
+  }
+
+  void expect_in_order(const size_t COUNT) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT_EQ(received_.size(), COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+      EXPECT_EQ(received_[i], i);
+    }
+  }
+};
+
+TEST_F(EndpointBatchSuite, DeliversQueuedSnapshotsInBatches) {
+  send_frames(10);
+  protocol_.set_batch_callback(collector(), 4);
+
+  ASSERT_TRUE(wait_for(10));
+  expect_in_order(10);
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_EQ(batches_, (std::vector<size_t>{4, 4, 2}));
+}
+
+TEST_F(EndpointBatchSuite, RespectsMaxBatch) {
+  protocol_.set_batch_callback(collector(), 16, 50ms);
+  send_frames(200);
+
+  ASSERT_TRUE(wait_for(200));
+  expect_in_order(200);
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_LT(batches_.size(), 200U);
+  for (const auto SIZE : batches_) {
+    EXPECT_LE(SIZE, 16U);
+  }
+}
+
+TEST_F(EndpointBatchSuite, LatencyBoundFlushesPartialBatch) {
+  protocol_.set_batch_callback(collector(), 1000, 20ms);
+  const auto START = std::chrono::steady_clock::now();
+  send_frames(3);
+
+  ASSERT_TRUE(wait_for(3));
+  const auto ELAPSED = std::chrono::steady_clock::now() - START;
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_EQ(batches_, (std::vector<size_t>{3}));
+  EXPECT_GE(ELAPSED, 15ms);
+}
+
+TEST_F(EndpointBatchSuite, ResetToPerSnapshotCallback) {
+  protocol_.set_batch_callback(collector(), 8);
+  protocol_.set_batch_callback(nullptr);
+  protocol_.set_receive_callback([this](Snapshot&& /*snap*/) { ++count_; });
+  send_frames(5);
+
+  ASSERT_TRUE(wait_for(5));
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_TRUE(batches_.empty());
+}
+
+TEST_F(EndpointBatchSuite, WorksOnExecutor) {
+  // The executor has to outlive the endpoint, so use a local one here.
+  CallbackExecutor executor(2);
+  Endpoint endpoint;
+  interface::EchoInterface interface{};
+  interface.open();
+  endpoint.set_interfaces(interface, interface);
+  endpoint.set_queue_capacity(1U << 16U);
+  endpoint.attach_executor(executor);
+  endpoint.set_batch_callback(collector(), 32, 10ms);
+  for (uint32_t i = 0; i < 300; ++i) {
+    payload_.u32 = i;
+    endpoint.send(make_field_info<FieldName::DATA_FIELD>(&payload_));
+  }
+
+  ASSERT_TRUE(wait_for(300));
+  expect_in_order(300);
+}
+
+/**
+ * @test Burst of BURST frames delivered one by one versus in batches. Reports
+ * callback invocations and the time until the last snapshot was consumed.
+ */
+TEST_F(EndpointBatchSuite, BurstBenchmark) {
+  constexpr size_t BURST = 500;
+  std::printf("\n%-14s | %11s | %12s\n", "mode", "invocations", "deliver (us)");
+
+  for (const size_t MAX_BATCH : {size_t{0}, size_t{16}, size_t{64}}) {
+    Endpoint endpoint;
+    interface::EchoInterface interface{};
+    interface.open();
+    endpoint.set_interfaces(interface, interface);
+    endpoint.set_queue_capacity(BURST);
+
+    std::atomic<size_t> delivered{0};
+    std::atomic<size_t> invocations{0};
+    if (MAX_BATCH == 0) {
+      endpoint.set_receive_callback([&](Snapshot&& /*snap*/) {
+        ++invocations;
+        ++delivered;
+      });
+    } else {
+      endpoint.set_batch_callback(
+          [&](CustomSpan<Snapshot> batch) {
+            ++invocations;
+            delivered += batch.size();
+          },
+          MAX_BATCH, 1ms);
+    }
+
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BURST; ++i) {
+      payload_.u32 = static_cast<uint32_t>(i);
+      endpoint.send(make_field_info<FieldName::DATA_FIELD>(&payload_));
+    }
+    const auto DEADLINE = START + 5s;
+    while (delivered < BURST && std::chrono::steady_clock::now() < DEADLINE) {
+      std::this_thread::yield();
+    }
+    const auto END = std::chrono::steady_clock::now();
+    ASSERT_EQ(delivered, BURST);
+
+    char mode[16];
+    std::snprintf(mode, sizeof(mode), "batch(%zu)", MAX_BATCH);
+    std::printf(
+        "%-14s | %11zu | %12lld\n", MAX_BATCH == 0 ? "per-snapshot" : mode,
+        invocations.load(),
+        static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(END - START)
+                .count()));
+  }
+}
+}  // namespace
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <NamedTuple.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "CallbackExecutor.hpp"
+#include "Prototypes.hpp"
+#include "libraries/interfaces/Echo.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+using namespace std::chrono_literals;
+
+// All endpoints in this file share one pair of frame buffers. That is safe
+// because frames are produced from a single thread and EchoInterface parses
+// each frame completely before the next one is built.
+uint8_t rx_buffer_[256]{};
+uint8_t tx_buffer_[256]{};
+
+// SympleProtocol does not inherit constructors, so use the base directly.
+using Endpoint = ProtocolEndpoint<SympleFields<rx_buffer_>::proto_fields,
+                                  SympleFields<tx_buffer_>::proto_fields>;
+
+struct Node {
+  // The interface is declared first so it outlives the endpoint.
+  interface::EchoInterface m_interface{};
+  Endpoint m_endpoint;
+  std::atomic<size_t> m_count{0};
+  std::atomic<bool> m_in_order{true};
+
+  /// Without arguments the endpoint starts its own dispatcher thread; with
+  /// a CallbackExecutor it runs on that pool from construction.
+  template <typename... Args>
+  explicit Node(Args&... args) : m_endpoint(args...) {
+    m_interface.open();
+    m_endpoint.set_interfaces(m_interface, m_interface);
+    m_endpoint.set_queue_capacity(1U << 16U);
+    m_endpoint.set_receive_callback([this](auto&& snap) {
+      const auto VALUE = meta::get_named<FieldName::DATA_FIELD>(snap).u32;
+      if (VALUE != m_count) {
+        m_in_order = false;
+      }
+      ++m_count;
+    });
+  }
+
+  void send(const uint32_t VALUE) {
+    dataType payload{};
+    payload.u32 = VALUE;
+    m_endpoint.send(make_field_info<FieldName::DATA_FIELD>(&payload));
+  }
+};
+
+auto wait_all(const std::vector<std::unique_ptr<Node>>& nodes,
+              const size_t EXPECTED) -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + 20s;
+  for (const auto& node : nodes) {
+    while (node->m_count < EXPECTED) {
+      if (std::chrono::steady_clock::now() > DEADLINE) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+  }
+  return true;
+}
+
+TEST(CallbackExecutorTest, KeepsPerEndpointOrder) {
+  CallbackExecutor executor(3);
+  std::vector<std::unique_ptr<Node>> nodes;
+  for (int i = 0; i < 8; ++i) {
+    nodes.push_back(std::make_unique<Node>());
+    nodes.back()->m_endpoint.attach_executor(executor);
+  }
+  constexpr uint32_t FRAMES = 500;
+  for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+    for (auto& node : nodes) {
+      node->send(frame);
+    }
+  }
+  ASSERT_TRUE(wait_all(nodes, FRAMES));
+  for (auto& node : nodes) {
+    EXPECT_TRUE(node->m_in_order);
+    EXPECT_EQ(node->m_count, FRAMES);
+  }
+}
+
+TEST(CallbackExecutorTest, QueuedSnapshotsSurviveAttach) {
+  CallbackExecutor executor(1);  // outlives the endpoint
+  Node node;
+  node.m_endpoint.set_receive_callback(nullptr);
+  node.send(0);
+  node.send(1);
+  node.m_endpoint.attach_executor(executor);
+  std::atomic<size_t> count{0};
+  node.m_endpoint.set_receive_callback([&](auto&& /*snap*/) { ++count; });
+  const auto DEADLINE = std::chrono::steady_clock::now() + 1s;
+  while (count < 2 && std::chrono::steady_clock::now() < DEADLINE) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_EQ(count, 2U);
+}
+
+TEST(CallbackExecutorTest, EndpointCanBeDestroyedWhileBusy) {
+  CallbackExecutor executor(2);
+  for (int round = 0; round < 20; ++round) {
+    auto node = std::make_unique<Node>();
+    node->m_endpoint.attach_executor(executor);
+    node->m_endpoint.set_receive_callback(
+        [](auto&& /*snap*/) { std::this_thread::sleep_for(50us); });
+    for (uint32_t frame = 0; frame < 50; ++frame) {
+      node->send(frame);
+    }
+    node.reset();  // detaches while callbacks may still be running
+  }
+  SUCCEED();
+}
+
+TEST(CallbackExecutorTest, EndpointConstructedOnExecutor) {
+  CallbackExecutor executor(1);
+  interface::EchoInterface interface{};
+  Endpoint endpoint(executor);
+  interface.open();
+  endpoint.set_interfaces(interface, interface);
+  std::atomic<size_t> count{0};
+  endpoint.set_receive_callback([&](auto&& /*snap*/) { ++count; });
+  dataType payload{};
+  endpoint.send(make_field_info<FieldName::DATA_FIELD>(&payload));
+  const auto DEADLINE = std::chrono::steady_clock::now() + 1s;
+  while (count < 1 && std::chrono::steady_clock::now() < DEADLINE) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_EQ(count, 1U);
+}
+
+/**
+ * @test Scaling benchmark: N endpoints with a dedicated thread each versus N
+ * endpoints on a shared pool. Reports setup time and end-to-end delivery time
+ * for FRAMES frames per endpoint.
+ */
+TEST(CallbackExecutorTest, ScalingBenchmark) {
+  constexpr uint32_t FRAMES = 100;
+  constexpr size_t POOL = 4;
+  std::printf("\n%10s | %-9s | %12s | %12s | %14s\n", "endpoints", "mode",
+              "setup (us)", "deliver (us)", "frames/s");
+  for (const size_t COUNT : {1U, 4U, 16U, 64U, 256U}) {
+    for (const bool SHARED : {false, true}) {
+      std::unique_ptr<CallbackExecutor> executor;
+      std::vector<std::unique_ptr<Node>> nodes;
+
+      const auto SETUP_START = std::chrono::steady_clock::now();
+      if (SHARED) {
+        executor = std::make_unique<CallbackExecutor>(POOL);
+      }
+      for (size_t i = 0; i < COUNT; ++i) {
+        // на пуле эндпоинт ни разу не запускает собственный поток
+        nodes.push_back(SHARED ? std::make_unique<Node>(*executor)
+                               : std::make_unique<Node>());
+      }
+      const auto START = std::chrono::steady_clock::now();
+      for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+        for (auto& node : nodes) {
+          node->send(frame);
+        }
+      }
+      ASSERT_TRUE(wait_all(nodes, FRAMES));
+      const auto END = std::chrono::steady_clock::now();
+
+      using std::chrono::duration_cast;
+      using std::chrono::microseconds;
+      const auto SETUP_US =
+          duration_cast<microseconds>(START - SETUP_START).count();
+      const auto DELIVER_US = duration_cast<microseconds>(END - START).count();
+      const double RATE = static_cast<double>(COUNT * FRAMES) * 1e6 /
+                          static_cast<double>(std::max<int64_t>(DELIVER_US, 1));
+      std::printf("%10zu | %-9s | %12lld | %12lld | %14.0f\n", COUNT,
+                  SHARED ? "pool(4)" : "thread",
+                  static_cast<long long>(SETUP_US),
+                  static_cast<long long>(DELIVER_US), RATE);
+      for (auto& node : nodes) {
+        EXPECT_TRUE(node->m_in_order);
+      }
+    }
+  }
+}
+}  // namespace
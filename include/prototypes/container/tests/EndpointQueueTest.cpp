@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+
+#include <NamedTuple.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "ProtocolNoSysEndpoint.hpp"
+#include "Prototypes.hpp"
+#include "libraries/interfaces/Echo.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+using namespace std::chrono_literals;
+
+// This file exercises the receive queue of ProtocolEndpoint: capacity,
+// overflow policies and the loss counters. No user callback is installed
+// unless a test needs one, so snapshots stay queued and counts are exact.
+
+class EndpointQueueSuite : public testing::Test {
+ protected:
+  static inline uint8_t rx_buffer_[256]{};
+  static inline uint8_t tx_buffer_[256]{};
+
+  SympleProtocol<rx_buffer_, tx_buffer_> protocol_;
+  interface::EchoInterface interface_{};
+  dataType payload_{1, 2, 3, 4.f, 5.0};
+
+  void SetUp() override {
+    interface_.open();
+    protocol_.set_interfaces(interface_, interface_);
+  }
+
+  void send_frames(const size_t COUNT) {
+    for (size_t i = 0; i < COUNT; ++i) {
+      payload_.u32 = static_cast<uint32_t>(i);
+      protocol_.send(make_field_info<FieldName::DATA_FIELD>(&payload_));
+    }
+  }
+};
+
+TEST_F(EndpointQueueSuite, DropOldestIsDefault) {
+  protocol_.set_queue_capacity(10);
+  send_frames(15);
+
+  const auto STATS = protocol_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 15U);
+  EXPECT_EQ(STATS.m_dropped, 5U);
+  EXPECT_EQ(STATS.m_high_water, 10U);
+}
+
+TEST_F(EndpointQueueSuite, DropOldestKeepsNewestFrames) {
+  protocol_.set_queue_capacity(3);
+  send_frames(5);
+
+  std::vector<uint32_t> received;
+  std::atomic<size_t> count{0};
+  protocol_.set_receive_callback([&](auto&& snap) {
+    received.push_back(meta::get_named<FieldName::DATA_FIELD>(snap).u32);
+    ++count;
+  });
+  const auto DEADLINE = std::chrono::steady_clock::now() + 1s;
+  while (count < 3 && std::chrono::steady_clock::now() < DEADLINE) {
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_EQ(count, 3U);
+  EXPECT_EQ(received, (std::vector<uint32_t>{2, 3, 4}));
+}
+
+TEST_F(EndpointQueueSuite, DropNewest) {
+  protocol_.set_queue_capacity(4);
+  protocol_.set_overflow_policy(OverflowPolicy::DROP_NEWEST);
+  send_frames(10);
+
+  const auto STATS = protocol_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 4U);
+  EXPECT_EQ(STATS.m_dropped, 6U);
+  EXPECT_EQ(STATS.m_high_water, 4U);
+}
+
+TEST_F(EndpointQueueSuite, GrowIgnoresCapacity) {
+  protocol_.set_queue_capacity(4);
+  protocol_.set_overflow_policy(OverflowPolicy::GROW);
+  send_frames(20);
+
+  const auto STATS = protocol_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 20U);
+  EXPECT_EQ(STATS.m_dropped, 0U);
+  EXPECT_EQ(STATS.m_high_water, 20U);
+}
+
+TEST_F(EndpointQueueSuite, BlockTimesOutAndDrops) {
+  protocol_.set_queue_capacity(2);
+  protocol_.set_overflow_policy(OverflowPolicy::BLOCK, 20ms);
+
+  const auto START = std::chrono::steady_clock::now();
+  send_frames(4);
+  const auto ELAPSED = std::chrono::steady_clock::now() - START;
+
+  const auto STATS = protocol_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 2U);
+  EXPECT_EQ(STATS.m_dropped, 2U);
+  EXPECT_GE(ELAPSED, 40ms);
+}
+
+TEST_F(EndpointQueueSuite, BlockWaitsForConsumer) {
+  protocol_.set_queue_capacity(1);
+  protocol_.set_overflow_policy(OverflowPolicy::BLOCK, 1s);
+  std::atomic<size_t> count{0};
+  protocol_.set_receive_callback([&](auto&& /*snap*/) {
+    std::this_thread::sleep_for(1ms);
+    ++count;
+  });
+  send_frames(20);
+
+  const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+  while (count < 20 && std::chrono::steady_clock::now() < DEADLINE) {
+    std::this_thread::sleep_for(1ms);
+  }
+  const auto STATS = protocol_.get_queue_stats();
+  EXPECT_EQ(count, 20U);
+  EXPECT_EQ(STATS.m_enqueued, 20U);
+  EXPECT_EQ(STATS.m_dropped, 0U);
+  EXPECT_LE(STATS.m_high_water, 1U);
+}
+
+/// @test Capacity 0 queues nothing; BLOCK does not wait for space that can
+/// never appear.
+TEST_F(EndpointQueueSuite, ZeroCapacityDropsEveryFrame) {
+  protocol_.set_queue_capacity(0);
+  for (const auto POLICY : {OverflowPolicy::DROP_OLDEST,
+                            OverflowPolicy::DROP_NEWEST, OverflowPolicy::BLOCK}) {
+    protocol_.reset_queue_stats();
+    protocol_.set_overflow_policy(POLICY, 1s);
+    const auto START = std::chrono::steady_clock::now();
+    send_frames(3);
+    EXPECT_LT(std::chrono::steady_clock::now() - START, 500ms);
+
+    const auto STATS = protocol_.get_queue_stats();
+    EXPECT_EQ(STATS.m_enqueued, 0U);
+    EXPECT_EQ(STATS.m_dropped, 3U);
+  }
+}
+
+TEST_F(EndpointQueueSuite, ResetStats) {
+  send_frames(3);
+  protocol_.reset_queue_stats();
+  const auto STATS = protocol_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 0U);
+  EXPECT_EQ(STATS.m_dropped, 0U);
+  EXPECT_EQ(STATS.m_high_water, 0U);
+}
+
+// The same policies on the bare-metal endpoint, which fills its queue from
+// receive() on the caller's thread
+class NoSysQueueSuite : public testing::Test {
+ protected:
+  static inline uint8_t rx_buffer_[256]{};
+  static inline uint8_t tx_buffer_[256]{};
+
+  ProtocolNoSysEndpoint<SympleFields<rx_buffer_>::proto_fields,
+                        SympleFields<tx_buffer_>::proto_fields>
+      endpoint_;
+  interface::EchoInterface interface_{};
+  interface::Delegate loop_;
+  dataType payload_{1, 2, 3, 4.f, 5.0};
+
+  void SetUp() override {
+    interface_.open();
+    endpoint_.m_tx.set_interface(interface_);
+    loop_ = interface_.add_receive_callback(
+        [this](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          endpoint_.receive(data);
+        });
+  }
+
+  void send_frames(const size_t COUNT) {
+    for (size_t i = 0; i < COUNT; ++i) {
+      payload_.u32 = static_cast<uint32_t>(i);
+      endpoint_.send(make_field_info<FieldName::DATA_FIELD>(&payload_));
+    }
+  }
+
+  auto queued() const -> std::vector<uint32_t> {
+    std::vector<uint32_t> values;
+    for (const auto& snap : endpoint_.m_rx_queue) {
+      values.push_back(meta::get_named<FieldName::DATA_FIELD>(snap).u32);
+    }
+    return values;
+  }
+};
+
+TEST_F(NoSysQueueSuite, DropOldestIsDefault) {
+  endpoint_.set_queue_capacity(3);
+  send_frames(5);
+
+  const auto STATS = endpoint_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 5U);
+  EXPECT_EQ(STATS.m_dropped, 2U);
+  EXPECT_EQ(STATS.m_high_water, 3U);
+  EXPECT_EQ(queued(), (std::vector<uint32_t>{2, 3, 4}));
+}
+
+TEST_F(NoSysQueueSuite, DropNewest) {
+  endpoint_.set_queue_capacity(3);
+  endpoint_.set_overflow_policy(OverflowPolicy::DROP_NEWEST);
+  send_frames(5);
+
+  const auto STATS = endpoint_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 3U);
+  EXPECT_EQ(STATS.m_dropped, 2U);
+  EXPECT_EQ(STATS.m_high_water, 3U);
+  EXPECT_EQ(queued(), (std::vector<uint32_t>{0, 1, 2}));
+}
+
+/// @test Nothing can drain the queue while receive() waits, so BLOCK drops
+/// the incoming frame at once, like DROP_NEWEST.
+TEST_F(NoSysQueueSuite, BlockActsAsDropNewest) {
+  endpoint_.set_queue_capacity(3);
+  endpoint_.set_overflow_policy(OverflowPolicy::BLOCK);
+
+  const auto START = std::chrono::steady_clock::now();
+  send_frames(5);
+  const auto ELAPSED = std::chrono::steady_clock::now() - START;
+
+  const auto STATS = endpoint_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 3U);
+  EXPECT_EQ(STATS.m_dropped, 2U);
+  EXPECT_EQ(STATS.m_high_water, 3U);
+  EXPECT_EQ(queued(), (std::vector<uint32_t>{0, 1, 2}));
+  EXPECT_LT(ELAPSED, 500ms);
+}
+
+TEST_F(NoSysQueueSuite, ZeroCapacityDropsEveryFrame) {
+  endpoint_.set_queue_capacity(0);
+  send_frames(3);
+
+  const auto STATS = endpoint_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 0U);
+  EXPECT_EQ(STATS.m_dropped, 3U);
+  EXPECT_TRUE(queued().empty());
+}
+
+TEST_F(NoSysQueueSuite, GrowIgnoresCapacity) {
+  endpoint_.set_queue_capacity(3);
+  endpoint_.set_overflow_policy(OverflowPolicy::GROW);
+  send_frames(10);
+
+  const auto STATS = endpoint_.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 10U);
+  EXPECT_EQ(STATS.m_dropped, 0U);
+  EXPECT_EQ(STATS.m_high_water, 10U);
+}
+}  // namespace
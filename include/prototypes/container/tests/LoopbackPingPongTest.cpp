@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <NamedTuple.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "Prototypes.hpp"
+#include "TestHelpers.hpp"
+#include "libraries/interfaces/Echo.hpp"
+#include "libraries/interfaces/Loopback.hpp"
+#include "libraries/interfaces/Mux.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+using namespace std::chrono_literals;
+
+// PingPongTest over a LoopbackPair: the host endpoint sits on m_a, a board
+// on m_b echoes every byte back from its own receiver thread. Requests,
+// parsing and replies run on three threads, as they would against hardware.
+
+uint8_t rx_buffer_[256]{};
+uint8_t tx_buffer_[256]{};
+uint8_t rx_buffer_2_[256]{};
+uint8_t tx_buffer_2_[256]{};
+
+TEST(LoopbackPingPongTest, RequestsSurviveRandomChunks) {
+  interface::LoopbackOptions options;
+  options.m_max_chunk = 7;
+  options.m_random_chunks = true;
+  interface::LoopbackPair link(options);
+  EchoPeer board(link.m_b);
+  SympleProtocol<rx_buffer_, tx_buffer_> host;
+  host.set_interfaces(link.m_a, link.m_a);
+
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  for (uint32_t i = 0; i < 100; ++i) {
+    payload.u32 = i;
+    auto reply = host.request(make_field_info<FieldName::DATA_FIELD>(&payload));
+    ASSERT_EQ(meta::get_named<FieldName::DATA_FIELD>(reply).u32, i);
+  }
+}
+
+/**
+ * @test Two protocols share one link through a ChannelMux; each parser only
+ * sees its own channel, so neither has to resync on the other's frames.
+ */
+TEST(LoopbackPingPongTest, ProtocolsShareLinkThroughMux) {
+  interface::LoopbackOptions options;
+  options.m_max_chunk = 7;
+  options.m_random_chunks = true;
+  interface::LoopbackPair link(options);
+  interface::ChannelMux host_mux(link.m_a);
+  interface::ChannelMux board_mux(link.m_b);
+  EchoPeer control_board(board_mux.channel(1));
+  EchoPeer telemetry_board(board_mux.channel(2));
+
+  SympleProtocol<rx_buffer_, tx_buffer_> control;
+  control.set_interfaces(host_mux.channel(1), host_mux.channel(1));
+  SympleProtocol<rx_buffer_2_, tx_buffer_2_> telemetry;
+  telemetry.set_interfaces(host_mux.channel(2), host_mux.channel(2));
+
+  auto run = [](auto& host, const uint32_t BASE) {
+    dataType payload{1, 2, 3, 4.f, 5.0};
+    for (uint32_t i = 0; i < 200; ++i) {
+      payload.u32 = BASE + i;
+      auto reply =
+          host.request(make_field_info<FieldName::DATA_FIELD>(&payload));
+      ASSERT_EQ(meta::get_named<FieldName::DATA_FIELD>(reply).u32, BASE + i);
+    }
+  };
+  std::thread telemetry_thread([&] { run(telemetry, 1'000'000); });
+  run(control, 0);
+  telemetry_thread.join();
+  EXPECT_EQ(board_mux.resyncs(), 0U);
+  EXPECT_EQ(host_mux.resyncs(), 0U);
+}
+
+/**
+ * @test Round-trip latency (request() waits for each reply) and pipelined
+ * throughput (frames sent back to back, replies counted by the receive
+ * callback). EchoInterface runs the whole chain on the sender's stack and is
+ * listed for comparison; it cannot overlap sending with receiving.
+ */
+TEST(LoopbackPingPongTest, RoundTripBenchmark) {
+  constexpr size_t ROUND_TRIPS = 2000;
+  constexpr size_t FRAMES = 20000;
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  const auto DATA = make_field_info<FieldName::DATA_FIELD>(&payload);
+
+  std::printf("\n%-10s | %12s | %14s\n", "link", "rtt us", "frames/s");
+  for (const bool LOOPBACK : {false, true}) {
+    interface::EchoInterface echo;
+    echo.open();
+    interface::LoopbackPair link;
+    EchoPeer board(link.m_b);
+    interface::IInterface& port =
+        LOOPBACK ? static_cast<interface::IInterface&>(link.m_a) : echo;
+
+    SympleProtocol<rx_buffer_, tx_buffer_> host;
+    host.set_interfaces(port, port);
+    host.set_overflow_policy(OverflowPolicy::BLOCK);
+
+    const auto RTT_START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ROUND_TRIPS; ++i) {
+      host.request(DATA);
+    }
+    const std::chrono::duration<double, std::micro> RTT =
+        std::chrono::steady_clock::now() - RTT_START;
+
+    std::atomic<size_t> replies{0};
+    host.set_receive_callback([&replies](auto&& /*snap*/) { ++replies; });
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < FRAMES; ++i) {
+      host.send(DATA);
+    }
+    ASSERT_TRUE(wait_count(replies, FRAMES, 5s));
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    std::printf("%-10s | %12.2f | %14.0f\n", LOOPBACK ? "loopback" : "echo",
+                RTT.count() / ROUND_TRIPS,
+                static_cast<double>(FRAMES) / ELAPSED.count());
+  }
+}
+}  // namespace
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <NamedTuple.hpp>
+#include <chrono>
+#include <cstdio>
+#include <variant>
+
+#include "Prototypes.hpp"
+#include "libraries/interfaces/Echo.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+
+// Snapshot projection: an endpoint parameterized with FieldProjection copies
+// only the listed fields into the snapshots it hands out.
+
+uint8_t rx_full_[256]{};
+uint8_t rx_projected_[256]{};
+uint8_t tx_buffer_[256]{};
+
+using TypeAndData =
+    FieldProjection<FieldName::TYPE_FIELD, FieldName::DATA_FIELD>;
+
+using FullEndpoint = ComplexProtocol<rx_full_, tx_buffer_>;
+using ProjectedEndpoint =
+    ProtocolEndpoint<ComplexFields<rx_projected_>::proto_fields,
+                     ComplexFields<tx_buffer_>::proto_fields, CrcSoft,
+                     TypeAndData>;
+
+static_assert(std::tuple_size_v<FullEndpoint::RxFieldsSnapshot> == 6);
+static_assert(std::tuple_size_v<ProjectedEndpoint::RxFieldsSnapshot> == 2);
+static_assert(sizeof(ProjectedEndpoint::RxFieldsSnapshot) <
+              sizeof(FullEndpoint::RxFieldsSnapshot));
+
+TEST(ProjectionTest, RequestReturnsProjectedSnapshot) {
+  ProjectedEndpoint projected;
+  interface::EchoInterface interface{};
+  interface.open();
+  projected.set_interfaces(interface, interface);
+
+  dataType2 payload{};
+  payload.u8 = 42;
+  auto snap =
+      projected.request(make_field_info<FieldName::DATA_FIELD>(&payload));
+
+  EXPECT_EQ(meta::get_named<FieldName::TYPE_FIELD>(snap),
+            ComplexFields<rx_projected_>::Packets::kPacket2);
+  const auto& data = meta::get_named<FieldName::DATA_FIELD>(snap);
+  ASSERT_TRUE(std::holds_alternative<dataType2>(data));
+  EXPECT_EQ(std::get<dataType2>(data), payload);
+}
+
+TEST(ProjectionTest, ContainerProjectionFollowsRequestedOrder) {
+  using Rx = ProjectedEndpoint::RxCont;
+  using Reordered = Rx::ProjectedTuple<FieldName::DATA_FIELD,
+                                       FieldName::LEN_FIELD>;
+  static_assert(std::tuple_element_t<0, Reordered>::NAME ==
+                FieldName::DATA_FIELD);
+  static_assert(std::tuple_element_t<1, Reordered>::NAME ==
+                FieldName::LEN_FIELD);
+  static_assert(Rx::index_of<FieldName::CRC_FIELD>() == Rx::SIZE - 1);
+  static_assert(Rx::index_of<FieldName::SOURCE_FIELD>() == Rx::SIZE);
+  SUCCEED();
+}
+
+/**
+ * @test Copy cost of a full snapshot versus a TYPE+DATA projection of the same
+ * received container.
+ */
+TEST(ProjectionTest, CopyBenchmark) {
+  FullEndpoint full;
+  interface::EchoInterface interface{};
+  interface.open();
+  full.set_interfaces(interface, interface);
+  dataType2 payload{};
+  (void)full.request(make_field_info<FieldName::DATA_FIELD>(&payload));
+
+  constexpr int ITERATIONS = 200000;
+  const auto& rx = full.m_rx;
+  auto measure = [&](auto&& copy) {
+    const auto START = std::chrono::steady_clock::now();
+    // volatile keeps the optimizer from dropping the copies
+    volatile size_t sink = 0;
+    for (int i = 0; i < ITERATIONS; ++i) {
+      auto snap = copy();
+      sink = sink + meta::get_named<FieldName::TYPE_FIELD>(snap) +
+             meta::get_named<FieldName::DATA_FIELD>(snap).index();
+    }
+    const auto END = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(END - START).count() /
+           ITERATIONS;
+  };
+
+  const double FULL_NS = measure([&] { return AllFields::copy(rx); });
+  const double PROJECTED_NS = measure([&] { return TypeAndData::copy(rx); });
+  std::printf("\nsnapshot copy: full %.1f ns, TYPE+DATA %.1f ns\n", FULL_NS,
+              PROJECTED_NS);
+}
+}  // namespace
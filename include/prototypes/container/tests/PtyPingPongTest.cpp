@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <NamedTuple.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "Prototypes.hpp"
+#include "Pty.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+using namespace std::chrono_literals;
+
+// The host endpoint talks through UartLinuxInterface on the slave side of a
+// pty; the master side echoes every byte back. Frames cross the tty line
+// discipline twice per round trip, as with a real device on a serial port.
+
+uint8_t rx_buffer_[256]{};
+uint8_t tx_buffer_[256]{};
+
+TEST(PtyPingPongTest, RequestThroughLineDiscipline) {
+  interface::PtyPair pty;
+  ASSERT_TRUE(pty.m_uart.is_open());
+  EchoPeer device(pty.m_device);
+  SympleProtocol<rx_buffer_, tx_buffer_> host;
+  host.set_interfaces(pty.m_uart, pty.m_uart);
+
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  for (uint32_t i = 0; i < 50; ++i) {
+    payload.u32 = i;
+    auto reply = host.request(make_field_info<FieldName::DATA_FIELD>(&payload));
+    ASSERT_EQ(meta::get_named<FieldName::DATA_FIELD>(reply).u32, i);
+  }
+}
+
+/**
+ * @test Round-trip latency (request() waits for every reply) and pipelined
+ * frame rate (frames sent back to back, replies counted in the receive
+ * callback) through the kernel tty path, for the threaded port with the
+ * default and low-latency read profiles, for the epoll reactor, and with
+ * tcdrain() per frame instead of per write.
+ */
+TEST(PtyPingPongTest, EndToEndBenchmark) {
+  constexpr size_t ROUND_TRIPS = 1000;
+  constexpr size_t FRAMES = 10000;
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  const auto DATA = make_field_info<FieldName::DATA_FIELD>(&payload);
+
+  enum class Mode : uint8_t { DEFAULT, LOW_LATENCY, REACTOR, PER_FRAME };
+  struct Row {
+    const char* m_name;
+    Mode m_mode;
+  };
+  constexpr Row ROWS[] = {{"default", Mode::DEFAULT},
+                          {"low-latency", Mode::LOW_LATENCY},
+                          {"reactor", Mode::REACTOR},
+                          {"drain/frame", Mode::PER_FRAME}};
+
+  std::printf("\n%-12s | %12s | %12s\n", "port", "rtt us", "frames/s");
+  for (const auto& ROW : ROWS) {
+    interface::EpollReactor reactor;
+    std::unique_ptr<interface::PtyPair> pty;
+    if (ROW.m_mode == Mode::REACTOR) {
+      pty = std::make_unique<interface::PtyPair>(reactor);
+    } else if (ROW.m_mode == Mode::LOW_LATENCY) {
+      pty = std::make_unique<interface::PtyPair>(
+          115200, interface::UartReadProfile::low_latency());
+    } else {
+      pty = std::make_unique<interface::PtyPair>();
+    }
+    if (ROW.m_mode == Mode::PER_FRAME) {
+      pty->m_uart.set_drain_policy(interface::DrainPolicy::PER_FRAME);
+    }
+    EchoPeer device(pty->m_device);
+    SympleProtocol<rx_buffer_, tx_buffer_> host;
+    host.set_interfaces(pty->m_uart, pty->m_uart);
+    host.set_overflow_policy(OverflowPolicy::BLOCK);
+
+    const auto RTT_START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ROUND_TRIPS; ++i) {
+      host.request(DATA);
+    }
+    const std::chrono::duration<double, std::micro> RTT =
+        std::chrono::steady_clock::now() - RTT_START;
+
+    std::atomic<size_t> replies{0};
+    host.set_receive_callback([&replies](auto&& /*snap*/) { ++replies; });
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < FRAMES; ++i) {
+      host.send(DATA);
+    }
+    ASSERT_TRUE(wait_count(replies, FRAMES));
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    std::printf("%-12s | %12.1f | %12.0f\n", ROW.m_name,
+                RTT.count() / ROUND_TRIPS,
+                static_cast<double>(FRAMES) / ELAPSED.count());
+  }
+}
+}  // namespace
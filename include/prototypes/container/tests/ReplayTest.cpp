@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <NamedTuple.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "Prototypes.hpp"
+#include "TestHelpers.hpp"
+#include "libraries/interfaces/Capture.hpp"
+#include "libraries/interfaces/Loopback.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+using namespace std::chrono_literals;
+
+// A host session over a LoopbackPair is recorded through CaptureInterface;
+// the captured RX stream is then fed to a fresh endpoint by ReplayInterface.
+
+uint8_t rx_buffer_[256]{};
+uint8_t tx_buffer_[256]{};
+
+// Records @p FRAMES echoed PingPong frames into @p path.
+void record_session(const std::string& path, const size_t FRAMES) {
+  interface::LoopbackOptions options;
+  options.m_max_chunk = 7;  // odd chunk boundaries survive the replay
+  options.m_random_chunks = true;
+  interface::LoopbackPair link(options);
+  EchoPeer board(link.m_b);
+  interface::CaptureInterface capture(link.m_a, path);
+  ASSERT_TRUE(capture.open());
+
+  SympleProtocol<rx_buffer_, tx_buffer_> host;
+  host.set_interfaces(capture, capture);
+  host.set_overflow_policy(OverflowPolicy::BLOCK);
+  std::atomic<size_t> replies{0};
+  host.set_receive_callback([&replies](auto&& /*snap*/) { ++replies; });
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  for (uint32_t i = 0; i < FRAMES; ++i) {
+    payload.u32 = i;
+    host.send(make_field_info<FieldName::DATA_FIELD>(&payload));
+  }
+  ASSERT_TRUE(wait_count(replies, FRAMES));
+  ASSERT_TRUE(capture.close());
+  ASSERT_EQ(capture.dropped(), 0U);
+}
+
+TEST(ReplayTest, ReplayedFramesParseInOrder) {
+  const std::string PATH =
+      "/tmp/protolib_replay_" + std::to_string(getpid()) + ".cap";
+  constexpr size_t FRAMES = 200;
+  record_session(PATH, FRAMES);
+
+  interface::ReplayOptions options;
+  options.m_pacing = interface::ReplayPacing::MAX_SPEED;
+  interface::ReplayInterface replay(options);
+  ASSERT_TRUE(replay.load(PATH));
+  SympleProtocol<rx_buffer_, tx_buffer_> host;
+  host.set_interfaces(replay, replay);
+  host.set_overflow_policy(OverflowPolicy::BLOCK);
+  std::atomic<size_t> received{0};
+  std::atomic<bool> in_order{true};
+  host.set_receive_callback([&received, &in_order](auto&& snap) {
+    const auto VALUE = meta::get_named<FieldName::DATA_FIELD>(snap).u32;
+    in_order = in_order && VALUE == received;
+    ++received;
+  });
+  ASSERT_TRUE(replay.open());
+  ASSERT_TRUE(replay.wait_done(5s));
+  ASSERT_TRUE(wait_count(received, FRAMES));
+  EXPECT_TRUE(in_order);
+  std::remove(PATH.c_str());
+}
+
+/**
+ * @test Parser throughput on recorded traffic: the same capture replayed at
+ * full speed several times, so runs are comparable between builds.
+ */
+TEST(ReplayTest, ReplayThroughputBenchmark) {
+  const std::string PATH =
+      "/tmp/protolib_replay_bench_" + std::to_string(getpid()) + ".cap";
+  constexpr size_t FRAMES = 5000;
+  constexpr size_t PASSES = 20;
+  record_session(PATH, FRAMES);
+
+  interface::ReplayOptions options;
+  options.m_pacing = interface::ReplayPacing::MAX_SPEED;
+  options.m_repeat = PASSES;
+  interface::ReplayInterface replay(options);
+  ASSERT_TRUE(replay.load(PATH));
+  SympleProtocol<rx_buffer_, tx_buffer_> host;
+  host.set_interfaces(replay, replay);
+  host.set_overflow_policy(OverflowPolicy::BLOCK);
+  std::atomic<size_t> received{0};
+  host.set_receive_callback([&received](auto&& /*snap*/) { ++received; });
+
+  const auto START = std::chrono::steady_clock::now();
+  ASSERT_TRUE(replay.open());
+  ASSERT_TRUE(replay.wait_done(60s));
+  ASSERT_TRUE(wait_count(received, FRAMES * PASSES));
+  const std::chrono::duration<double> ELAPSED =
+      std::chrono::steady_clock::now() - START;
+  std::printf("\nreplay: %zu frames, %.0f frames/s, %.1f MiB/s\n",
+              FRAMES * PASSES,
+              static_cast<double>(FRAMES * PASSES) / ELAPSED.count(),
+              static_cast<double>(replay.delivered()) / (1U << 20U) /
+                  ELAPSED.count());
+  std::remove(PATH.c_str());
+}
+}  // namespace
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <NamedTuple.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "Prototypes.hpp"
+#include "TestHelpers.hpp"
+#include "libraries/interfaces/Datagram.hpp"
+#include "libraries/interfaces/Loopback.hpp"
+#include "libraries/interfaces/Socket.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+using namespace std::chrono_literals;
+
+// The host endpoint connects to a socket whose server side echoes every
+// byte back, standing in for a board behind a ser2net-style gateway.
+
+uint8_t rx_buffer_[256]{};
+uint8_t tx_buffer_[256]{};
+
+struct EchoServer {
+  interface::StreamSocketInterface m_socket;
+  EchoPeer m_echo{m_socket};
+
+  explicit EchoServer(const int FD) { m_socket.adopt(FD); }
+  EchoServer(interface::UringReactor& reactor, const int FD)
+      : m_socket(reactor) {
+    m_socket.adopt(FD);
+  }
+};
+
+// A connected client with its echo server.
+struct Connection {
+  interface::StreamListener m_listener;
+  interface::StreamSocketInterface m_client;
+  std::unique_ptr<EchoServer> m_server;
+
+  explicit Connection(const bool TCP,
+                      const interface::SocketOptions& options = {},
+                      interface::UringReactor* reactor = nullptr)
+      : m_client(reactor != nullptr
+                     ? interface::StreamSocketInterface(*reactor, options)
+                     : interface::StreamSocketInterface(options)) {
+    const std::string PATH =
+        "/tmp/protolib_pingpong_" + std::to_string(getpid());
+    if (TCP) {
+      m_listener.listen_tcp();
+      m_client.connect_tcp("127.0.0.1", m_listener.port());
+    } else {
+      m_listener.listen_unix(PATH);
+      m_client.connect_unix(PATH);
+    }
+    const int FD = m_listener.accept(1s);
+    m_server = reactor != nullptr ? std::make_unique<EchoServer>(*reactor, FD)
+                                  : std::make_unique<EchoServer>(FD);
+  }
+};
+
+TEST(SocketPingPongTest, RequestOverTcp) {
+  Connection link(true);
+  ASSERT_TRUE(link.m_client.is_open());
+  SympleProtocol<rx_buffer_, tx_buffer_> host;
+  host.set_interfaces(link.m_client, link.m_client);
+
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  for (uint32_t i = 0; i < 50; ++i) {
+    payload.u32 = i;
+    auto reply = host.request(make_field_info<FieldName::DATA_FIELD>(&payload));
+    ASSERT_EQ(meta::get_named<FieldName::DATA_FIELD>(reply).u32, i);
+  }
+}
+
+// Every datagram reaches RxContainer::fill() as its own chunk.
+TEST(SocketPingPongTest, RequestOverUdp) {
+  interface::DatagramInterface board;
+  ASSERT_TRUE(board.bind());
+  EchoPeer echo(board);
+  interface::DatagramInterface link;
+  ASSERT_TRUE(link.connect("127.0.0.1", board.port()));
+  SympleProtocol<rx_buffer_, tx_buffer_> host;
+  host.set_interfaces(link, link);
+
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  for (uint32_t i = 0; i < 50; ++i) {
+    payload.u32 = i;
+    auto reply = host.request(make_field_info<FieldName::DATA_FIELD>(&payload));
+    ASSERT_EQ(meta::get_named<FieldName::DATA_FIELD>(reply).u32, i);
+  }
+}
+
+/**
+ * @test Round-trip latency and pipelined frame rate of PingPong requests over
+ * TCP (with and without TCP_NODELAY, and with both ends on UringReactor), a
+ * Unix socket, and the in-memory LoopbackPair as the baseline.
+ */
+TEST(SocketPingPongTest, TransportBenchmark) {
+  constexpr size_t ROUND_TRIPS = 1000;
+  constexpr size_t FRAMES = 20000;
+  dataType payload{1, 2, 3, 4.f, 5.0};
+  const auto DATA = make_field_info<FieldName::DATA_FIELD>(&payload);
+
+  enum class Mode : uint8_t { LOOPBACK, UNIX, TCP, TCP_NAGLE, TCP_URING };
+  struct Row {
+    const char* m_name;
+    Mode m_mode;
+  };
+  constexpr Row ROWS[] = {{"loopback", Mode::LOOPBACK},
+                          {"unix", Mode::UNIX},
+                          {"tcp", Mode::TCP},
+                          {"tcp nagle", Mode::TCP_NAGLE},
+                          {"tcp uring", Mode::TCP_URING}};
+
+  std::printf("\n%-10s | %10s | %12s\n", "transport", "rtt us", "frames/s");
+  for (const auto& ROW : ROWS) {
+    if (ROW.m_mode == Mode::TCP_URING &&
+        !interface::UringReactor::is_supported()) {
+      continue;
+    }
+    std::unique_ptr<interface::UringReactor> reactor;
+    std::unique_ptr<interface::LoopbackPair> loopback;
+    std::unique_ptr<EchoPeer> board;
+    std::unique_ptr<Connection> connection;
+    interface::IInterface* port = nullptr;
+    if (ROW.m_mode == Mode::LOOPBACK) {
+      loopback = std::make_unique<interface::LoopbackPair>();
+      board = std::make_unique<EchoPeer>(loopback->m_b);
+      port = &loopback->m_a;
+    } else {
+      interface::SocketOptions options;
+      options.m_no_delay = ROW.m_mode != Mode::TCP_NAGLE;
+      if (ROW.m_mode == Mode::TCP_URING) {
+        reactor = std::make_unique<interface::UringReactor>();
+      }
+      connection = std::make_unique<Connection>(ROW.m_mode != Mode::UNIX,
+                                                options, reactor.get());
+      port = &connection->m_client;
+    }
+
+    SympleProtocol<rx_buffer_, tx_buffer_> host;
+    host.set_interfaces(*port, *port);
+    host.set_overflow_policy(OverflowPolicy::BLOCK);
+
+    const auto RTT_START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ROUND_TRIPS; ++i) {
+      host.request(DATA);
+    }
+    const std::chrono::duration<double, std::micro> RTT =
+        std::chrono::steady_clock::now() - RTT_START;
+
+    std::atomic<size_t> replies{0};
+    host.set_receive_callback([&replies](auto&& /*snap*/) { ++replies; });
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < FRAMES; ++i) {
+      host.send(DATA);
+    }
+    ASSERT_TRUE(wait_count(replies, FRAMES));
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    std::printf("%-10s | %10.1f | %12.0f\n", ROW.m_name,
+                RTT.count() / ROUND_TRIPS,
+                static_cast<double>(FRAMES) / ELAPSED.count());
+  }
+}
+}  // namespace
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <NamedTuple.hpp>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+#include "ProtocolStaticEndpoint.hpp"
+#include "TestFields.hpp"
+
+// Global allocation hook: counts operator new calls while g_counting is set.
+// It lives in its own test binary so it does not affect the other suites.
+namespace {
+std::atomic<bool> g_counting{false};
+std::atomic<size_t> g_allocations{0};
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+  if (g_counting.load(std::memory_order_relaxed)) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size) -> void* { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+using namespace proto;
+using namespace proto::test;
+
+uint8_t rx_buffer_[256]{};
+uint8_t tx_buffer_[256]{};
+
+// Captures written bytes in a fixed array, standing in for a UART driver.
+class BufferInterface final : public interface::IInterface {
+ public:
+  BufferInterface() : IInterface("buffer interface") {}
+
+  auto write(CustomSpan<uint8_t> buffer,
+             std::chrono::milliseconds /*timeout*/) -> bool override {
+    for (const auto BYTE : buffer) {
+      m_bytes[m_size++] = BYTE;
+    }
+    return true;
+  }
+  auto is_open() -> bool override { return true; }
+  auto open() -> bool override { return true; }
+  auto close() -> bool override { return true; }
+
+  [[nodiscard]] auto frame() -> CustomSpan<uint8_t> {
+    return {m_bytes.data(), m_size};
+  }
+  void clear() { m_size = 0; }
+
+ private:
+  std::array<uint8_t, 256> m_bytes{};
+  size_t m_size{0};
+
+  auto read(uint8_t* /*buffer*/, size_t /*count*/) -> int override {
+    return 0;
+  }
+};
+
+// The prefix (ID_FIELD) is a pointer field and would be copied into a
+// std::vector, so the snapshot keeps only LEN and DATA.
+using LenAndData =
+    FieldProjection<FieldName::LEN_FIELD, FieldName::DATA_FIELD>;
+template <size_t CAPACITY>
+using Endpoint =
+    ProtocolStaticEndpoint<SympleFields<rx_buffer_>::proto_fields,
+                           SympleFields<tx_buffer_>::proto_fields, CAPACITY,
+                           CrcSoft, LenAndData>;
+
+static_assert(
+    !IsHeapFreeSnapshot<Endpoint<1>::RxCont::NamedReturnTuple>::value,
+    "Full snapshot copies the prefix into a vector");
+static_assert(IsHeapFreeSnapshot<Endpoint<1>::RxFieldsSnapshot>::value);
+
+class StaticEndpointSuite : public testing::Test {
+ protected:
+  BufferInterface interface_;
+  dataType payload_{1, 2, 3, 4.f, 5.0};
+
+  template <class Ep>
+  void loop_frame(Ep& endpoint, const uint32_t VALUE) {
+    interface_.clear();
+    payload_.u32 = VALUE;
+    endpoint.send(make_field_info<FieldName::DATA_FIELD>(&payload_));
+    endpoint.receive(interface_.frame());
+  }
+
+  static auto count_allocations(const std::function<void()>& body) -> size_t {
+    g_allocations = 0;
+    g_counting = true;
+    body();
+    g_counting = false;
+    return g_allocations;
+  }
+};
+
+TEST_F(StaticEndpointSuite, AllocationHookWorks) {
+  // volatile keeps the compiler from eliding the allocation
+  static void* volatile sink = nullptr;
+  const size_t ALLOCATIONS = count_allocations([] {
+    sink = ::operator new(16);
+    ::operator delete(sink);
+  });
+  EXPECT_EQ(ALLOCATIONS, 1U);
+}
+
+TEST_F(StaticEndpointSuite, FillAndSendDoNotAllocate) {
+  Endpoint<8> endpoint;
+  endpoint.m_tx.set_interface(interface_);
+
+  size_t received = 0;
+  bool in_order = true;
+  const size_t ALLOCATIONS = count_allocations([&] {
+    for (uint32_t i = 0; i < 100; ++i) {
+      loop_frame(endpoint, i);
+      Endpoint<8>::RxFieldsSnapshot snap;
+      while (endpoint.poll(snap)) {
+        in_order &= meta::get_named<FieldName::DATA_FIELD>(snap).u32 == i;
+        ++received;
+      }
+    }
+  });
+  EXPECT_EQ(ALLOCATIONS, 0U);
+  EXPECT_EQ(received, 100U);
+  EXPECT_TRUE(in_order);
+}
+
+TEST_F(StaticEndpointSuite, SinkDoesNotAllocate) {
+  Endpoint<1> endpoint;
+  endpoint.m_tx.set_interface(interface_);
+  uint32_t last = 0;
+  endpoint.set_receive_sink(
+      [](void* context, const Endpoint<1>::RxFieldsSnapshot& snap) {
+        *static_cast<uint32_t*>(context) =
+            meta::get_named<FieldName::DATA_FIELD>(snap).u32;
+      },
+      &last);
+
+  const size_t ALLOCATIONS = count_allocations([&] {
+    for (uint32_t i = 1; i <= 50; ++i) {
+      loop_frame(endpoint, i);
+    }
+  });
+  EXPECT_EQ(ALLOCATIONS, 0U);
+  EXPECT_EQ(last, 50U);
+  EXPECT_EQ(endpoint.size(), 0U);
+}
+
+TEST_F(StaticEndpointSuite, RingDropsOldest) {
+  Endpoint<4> endpoint;
+  endpoint.m_tx.set_interface(interface_);
+  for (uint32_t i = 0; i < 6; ++i) {
+    loop_frame(endpoint, i);
+  }
+
+  const auto STATS = endpoint.get_queue_stats();
+  EXPECT_EQ(STATS.m_enqueued, 6U);
+  EXPECT_EQ(STATS.m_dropped, 2U);
+  EXPECT_EQ(STATS.m_high_water, 4U);
+
+  Endpoint<4>::RxFieldsSnapshot snap;
+  for (uint32_t expected = 2; expected < 6; ++expected) {
+    ASSERT_TRUE(endpoint.poll(snap));
+    EXPECT_EQ(meta::get_named<FieldName::DATA_FIELD>(snap).u32, expected);
+  }
+  EXPECT_FALSE(endpoint.poll(snap));
+}
+
+TEST_F(StaticEndpointSuite, RingDropsNewest) {
+  Endpoint<4> endpoint;
+  endpoint.m_tx.set_interface(interface_);
+  endpoint.set_overflow_policy(OverflowPolicy::DROP_NEWEST);
+  for (uint32_t i = 0; i < 6; ++i) {
+    loop_frame(endpoint, i);
+  }
+
+  EXPECT_EQ(endpoint.get_queue_stats().m_dropped, 2U);
+  Endpoint<4>::RxFieldsSnapshot snap;
+  for (uint32_t expected = 0; expected < 4; ++expected) {
+    ASSERT_TRUE(endpoint.poll(snap));
+    EXPECT_EQ(meta::get_named<FieldName::DATA_FIELD>(snap).u32, expected);
+  }
+}
+}  // namespace
@@ -0,0 +1,43 @@
+/**
+ * @file TestHelpers.hpp
+ * @brief Echo peer and reply counter shared by the end-to-end endpoint tests.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "Interface.hpp"
+
+namespace proto::test {
+
+/// @brief Writes every received chunk straight back, standing in for a board.
+struct EchoPeer {
+  interface::Delegate m_delegate;
+
+  explicit EchoPeer(interface::IInterface& port) {
+    m_delegate = port.add_receive_callback(
+        [&port](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          port.write(data, std::chrono::seconds(1));
+          port.flush();
+        });
+  }
+};
+
+/// @brief Wait until @p count reaches @p expected; false on timeout.
+inline auto wait_count(const std::atomic<size_t>& count, const size_t EXPECTED,
+                       const std::chrono::milliseconds TIMEOUT =
+                           std::chrono::seconds(10)) -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  while (count < EXPECTED) {
+    if (std::chrono::steady_clock::now() > DEADLINE) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  return true;
+}
+}  // namespace proto::test
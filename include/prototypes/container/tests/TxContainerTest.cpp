@@ -5,6 +5,7 @@
 #include <functional>
 #include <type_traits>
 
+#include "CrcEngine.hpp"
 #include "Prototypes.hpp"
 
 using namespace proto;
@@ -25,6 +26,10 @@ class TxContainerSuite : public testing::Test {
   static inline uint8_t rx_simple_[256] = {};
   static inline uint8_t rx_complex_[256] = {};
 
+  // Buffers for containers parameterized with CrcEngine
+  static inline uint8_t tx_engine_[256] = {};
+  static inline uint8_t rx_engine_[256] = {};
+
   // Protocols (we instantiate both RX/TX templates, but only use TX here)
   using SimpleProto = SympleProtocol<tx_simple_, tx_simple_>;
   using ComplexProto = ComplexProtocol<tx_complex_, tx_complex_>;
@@ -237,4 +242,30 @@ TEST_F(TxContainerSuite, Complex_FrameIsContiguousFromIdBase) {
   EXPECT_LE(max_end, n);
 }
 
+// ----------------------------------------------------------------------------
+// CrcEngine as TCrc: the CRC written by TX is the engine's CRC of the
+// IS_IN_CRC bytes, and RX with the same engine accepts the frame.
+// ----------------------------------------------------------------------------
+TEST_F(TxContainerSuite, CrcEngineAsPolicy) {
+  TxContainer<SympleFields<tx_engine_>::proto_fields, Crc16Xmodem> tx;
+  RxContainer<SympleFields<rx_engine_>::proto_fields, Crc16Xmodem> rx;
+  const dataType payload{5, 6, 7, 8.f, 1.4142135623730951};
+
+  const size_t n = tx.send_packet(
+      proto::make_field_info<FieldName::DATA_FIELD>(&payload, sizeof(payload)));
+  ASSERT_GT(n, 0u);
+
+  uint32_t expect_crc = Crc16Xmodem::INITIAL;
+  tx.for_each_type([&](auto& fld) {
+    using F = std::decay_t<decltype(fld)>;
+    if constexpr ((F::FLAGS & FieldFlags::IS_IN_CRC) != FieldFlags::NOTHING) {
+      expect_crc = Crc16Xmodem::compute(
+          expect_crc, reinterpret_cast<const uint8_t*>(fld.get_ptr()),
+          fld.get_size());
+    }
+  });
+  EXPECT_EQ(*tx.get<FieldName::CRC_FIELD>().get_ptr(), expect_crc);
+  EXPECT_TRUE(RoundtripToRx(rx, tx)) << "RX rejected a CrcEngine frame";
+}
+
 }  // namespace
@@ -1,20 +1,105 @@
 #include "Crc16Modbus.hpp"
 
+#include <climits>
+
+#include "CrcEngine.hpp"
+
+namespace {
+constexpr uint16_t POLY_R = 0xA001;
+constexpr size_t ROWS = 4;
+using SliceTables = std::array<std::array<uint16_t, UINT8_MAX + 1>, ROWS>;
+
+constexpr std::array<uint16_t, 16> NIBBLE_TABLE = {
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400};
+
+// TABLES[0] — обычная байтовая таблица, TABLES[k][b] — CRC байта b и k
+// нулевых байтов за ним: четыре обращения продвигают CRC на четыре байта
+constexpr auto make_slice_tables() -> SliceTables {
+  SliceTables tables{};
+  for (uint32_t i = 0; i <= UINT8_MAX; ++i) {
+    uint32_t crr = i;
+    for (int j = CHAR_BIT; j > 0; --j) {
+      crr = (crr & 1U) != 0U ? (crr >> 1) ^ POLY_R : (crr >> 1);
+    }
+    tables[0][i] = static_cast<uint16_t>(crr);
+  }
+  for (size_t k = 1; k < ROWS; ++k) {
+    for (size_t i = 0; i <= UINT8_MAX; ++i) {
+      const uint16_t PREV = tables[k - 1][i];
+      tables[k][i] = PREV >> CHAR_BIT ^ tables[0][PREV & UINT8_MAX];
+    }
+  }
+  return tables;
+}
+
+constexpr SliceTables TABLES = make_slice_tables();
+static_assert(TABLES[0][1] == 0xC0C1U, "reflected CRC-16/MODBUS table");
+static_assert(TABLES[0][UINT8_MAX] == 0x4040U, "reflected CRC-16/MODBUS table");
+
+inline auto bytewise(uint32_t crc, const uint8_t *ptr, size_t count)
+    -> uint32_t {
+  while (count > 0) {
+    crc = crc >> CHAR_BIT ^ TABLES[0][(crc ^ *ptr++) & UINT8_MAX];
+    count--;
+  }
+  return crc;
+}
+
+inline auto slice4(uint32_t crc, const uint8_t *ptr, size_t count)
+    -> uint32_t {
+  const auto &t = TABLES;
+  for (; count >= 4; count -= 4, ptr += 4) {
+    // 16-битный регистр накладывается на первые два байта слова
+    const uint32_t WORD =
+        (static_cast<uint32_t>(ptr[0]) | static_cast<uint32_t>(ptr[1]) << 8 |
+         static_cast<uint32_t>(ptr[2]) << 16 |
+         static_cast<uint32_t>(ptr[3]) << 24) ^
+        crc;
+    crc = t[3][WORD & 0xFF] ^ t[2][(WORD >> 8) & 0xFF] ^
+          t[1][(WORD >> 16) & 0xFF] ^ t[0][WORD >> 24];
+  }
+  return bytewise(crc, ptr, count);
+}
+}  // namespace
+
 auto Crc16Modbus::calc(const CustomSpan<uint8_t> DATA) -> uint32_t {
-  reset();
-  return append(crc_, DATA);
+  return append(INITIAL, DATA);
 }
 
 auto Crc16Modbus::append(const uint32_t CRC, const CustomSpan<uint8_t> DATA)
     -> uint32_t {
-  (void)CRC;
+  if (DATA.size() >= SLICE_THRESHOLD) {
+    return append_slice4(CRC, DATA);
+  }
+  return append_bytewise(CRC, DATA);
+}
+
+void Crc16Modbus::reset() {}
+
+auto Crc16Modbus::append_nibble(const uint32_t CRC,
+                                const CustomSpan<uint8_t> DATA) -> uint32_t {
+  uint16_t crc = CRC & UINT16_MAX;
   const uint8_t *dataPtr = DATA.data();
   for (size_t i = 0; i < DATA.size(); i++) {
     const uint8_t CHAR = *dataPtr++;
-    crc_ = CRC_TABLES[(CHAR ^ crc_) & 15] ^ crc_ >> 4;
-    crc_ = CRC_TABLES[(CHAR >> 4 ^ crc_) & 15] ^ crc_ >> 4;
+    crc = NIBBLE_TABLE[(CHAR ^ crc) & 15] ^ crc >> 4;
+    crc = NIBBLE_TABLE[(CHAR >> 4 ^ crc) & 15] ^ crc >> 4;
   }
-  return crc_;
+  return crc;
+}
+
+auto Crc16Modbus::append_bytewise(const uint32_t CRC,
+                                  const CustomSpan<uint8_t> DATA) -> uint32_t {
+  return bytewise(CRC & UINT16_MAX, DATA.data(), DATA.size());
 }
 
-void Crc16Modbus::reset() { crc_ = UINT16_MAX; }
\ No newline at end of file
+auto Crc16Modbus::append_slice4(const uint32_t CRC,
+                                const CustomSpan<uint8_t> DATA) -> uint32_t {
+  return slice4(CRC & UINT16_MAX, DATA.data(), DATA.size());
+}
+
+auto Crc16Modbus::combine(const uint32_t CRC_A, const uint32_t CRC_B,
+                          const size_t LEN_B) -> uint32_t {
+  return Crc16ModbusEngine::combine(CRC_A, CRC_B, LEN_B);
+}
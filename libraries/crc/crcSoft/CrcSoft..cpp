@@ -1,28 +1,230 @@
 #include "CrcSoft.hpp"
 
-void CrcSoft::reset() {}
+#include "CrcEngine.hpp"
 
-auto CrcSoft::calc(const CustomSpan<uint8_t> DATA) -> uint32_t {
-  uint32_t crc = 0;
-  crc = ~crc;
-  size_t count = DATA.size();
-  const uint8_t *ptr = DATA.data();
-  while (count > 0) {
-    const uint32_t VAL = *ptr++;
-    crc = crc >> CHAR_BIT ^ crc32r_table_[(crc ^ VAL) & UINT8_MAX];
-    count--;
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRC_SOFT_CLMUL 1
+#endif
+
+namespace {
+constexpr size_t ROWS = 16;
+using Table = std::array<uint32_t, UINT8_MAX + 1>;
+using SliceTables = std::array<Table, ROWS>;
+
+// TABLES[0] is the classic reflected table; TABLES[k][b] is the CRC of byte
+// b followed by k zero bytes, so 16 lookups advance the CRC by 16 bytes.
+constexpr auto make_slice_tables() -> SliceTables {
+  SliceTables tables{};
+  for (uint32_t i = 0; i <= UINT8_MAX; ++i) {
+    uint32_t crr = i;
+    for (int j = CHAR_BIT; j > 0; --j) {
+      crr = (crr & 1U) != 0U ? (crr >> 1) ^ CRC32_POLY_R : (crr >> 1);
+    }
+    tables[0][i] = crr;
   }
-  return ~crc;
+  for (size_t k = 1; k < ROWS; ++k) {
+    for (size_t i = 0; i <= UINT8_MAX; ++i) {
+      const uint32_t PREV = tables[k - 1][i];
+      tables[k][i] = PREV >> CHAR_BIT ^ tables[0][PREV & UINT8_MAX];
+    }
+  }
+  return tables;
 }
 
-auto CrcSoft::append(uint32_t crc, const CustomSpan<uint8_t> DATA) -> uint32_t {
-  crc = ~crc;
-  size_t count = DATA.size();
-  const uint8_t *ptr = DATA.data();
+// Считаются компилятором и лежат в .rodata: одна копия на процесс,
+// конструктор CrcSoft ничего не строит
+constexpr SliceTables TABLES = make_slice_tables();
+static_assert(TABLES[0][1] == 0x77073096U, "reflected CRC-32 table");
+static_assert(TABLES[0][UINT8_MAX] == 0x2D02EF8DU, "reflected CRC-32 table");
+
+// Little-endian load; compilers turn it into one mov on x86 and ARM
+inline auto load32(const uint8_t *ptr) -> uint32_t {
+  return static_cast<uint32_t>(ptr[0]) | static_cast<uint32_t>(ptr[1]) << 8 |
+         static_cast<uint32_t>(ptr[2]) << 16 |
+         static_cast<uint32_t>(ptr[3]) << 24;
+}
+
+inline auto bytewise(uint32_t crc, const uint8_t *ptr, size_t count)
+    -> uint32_t {
   while (count > 0) {
-    const uint32_t VAL = *ptr++;
-    crc = crc >> CHAR_BIT ^ crc32r_table_[(crc ^ VAL) & UINT8_MAX];
+    crc = crc >> CHAR_BIT ^ TABLES[0][(crc ^ *ptr++) & UINT8_MAX];
     count--;
   }
-  return ~crc;
+  return crc;
+}
+
+// crc — регистр без инверсии, как внутри цикла append()
+inline auto slice8(uint32_t crc, const uint8_t *ptr, size_t count)
+    -> uint32_t {
+  const auto &t = TABLES;
+  for (; count >= 8; count -= 8, ptr += 8) {
+    const uint32_t ONE = load32(ptr) ^ crc;
+    const uint32_t TWO = load32(ptr + 4);
+    crc = t[7][ONE & 0xFF] ^ t[6][(ONE >> 8) & 0xFF] ^
+          t[5][(ONE >> 16) & 0xFF] ^ t[4][ONE >> 24] ^ t[3][TWO & 0xFF] ^
+          t[2][(TWO >> 8) & 0xFF] ^ t[1][(TWO >> 16) & 0xFF] ^ t[0][TWO >> 24];
+  }
+  return bytewise(crc, ptr, count);
+}
+
+inline auto slice16(uint32_t crc, const uint8_t *ptr, size_t count)
+    -> uint32_t {
+  const auto &t = TABLES;
+  for (; count >= 16; count -= 16, ptr += 16) {
+    const uint32_t ONE = load32(ptr) ^ crc;
+    const uint32_t TWO = load32(ptr + 4);
+    const uint32_t THREE = load32(ptr + 8);
+    const uint32_t FOUR = load32(ptr + 12);
+    crc = t[15][ONE & 0xFF] ^ t[14][(ONE >> 8) & 0xFF] ^
+          t[13][(ONE >> 16) & 0xFF] ^ t[12][ONE >> 24] ^ t[11][TWO & 0xFF] ^
+          t[10][(TWO >> 8) & 0xFF] ^ t[9][(TWO >> 16) & 0xFF] ^
+          t[8][TWO >> 24] ^ t[7][THREE & 0xFF] ^ t[6][(THREE >> 8) & 0xFF] ^
+          t[5][(THREE >> 16) & 0xFF] ^ t[4][THREE >> 24] ^ t[3][FOUR & 0xFF] ^
+          t[2][(FOUR >> 8) & 0xFF] ^ t[1][(FOUR >> 16) & 0xFF] ^
+          t[0][FOUR >> 24];
+  }
+  return slice8(crc, ptr, count);  // хвост 8..15 байт — по 8
+}
+
+#ifdef CRC_SOFT_CLMUL
+// Folding with carry-less multiplication after Intel's "Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ": four 128-bit lanes
+// fold 64 bytes per step, then are folded into one, reduced to 64 bits and
+// Barrett-reduced to the CRC. Constants are x^(k) mod P in the reflected
+// domain for the polynomial 0xEDB88320. @p count >= 64, multiple of 16.
+#define CRC_SOFT_CLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+
+CRC_SOFT_CLMUL_TARGET inline auto load(const uint8_t *at) -> __m128i {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(at));
+}
+
+// acc * x^(128 or 512) mod P, plus the next block
+CRC_SOFT_CLMUL_TARGET inline auto fold(const __m128i ACC, const __m128i KEYS,
+                                       const __m128i NEXT) -> __m128i {
+  const __m128i LOW = _mm_clmulepi64_si128(ACC, KEYS, 0x00);
+  const __m128i HIGH = _mm_clmulepi64_si128(ACC, KEYS, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(HIGH, LOW), NEXT);
+}
+
+CRC_SOFT_CLMUL_TARGET auto clmul_fold(uint32_t crc, const uint8_t *ptr,
+                                      size_t count) -> uint32_t {
+  alignas(16) static const uint64_t K1K2[] = {0x0154442bd4, 0x01c6e41596};
+  alignas(16) static const uint64_t K3K4[] = {0x01751997d0, 0x00ccaa009e};
+  alignas(16) static const uint64_t K5K0[] = {0x0163cd6124, 0x0000000000};
+  alignas(16) static const uint64_t POLY[] = {0x01db710641, 0x01f7011641};
+
+  __m128i x1 =
+      _mm_xor_si128(load(ptr), _mm_cvtsi32_si128(static_cast<int>(crc)));
+  __m128i x2 = load(ptr + 16);
+  __m128i x3 = load(ptr + 32);
+  __m128i x4 = load(ptr + 48);
+  ptr += 64;
+  count -= 64;
+
+  __m128i keys = _mm_load_si128(reinterpret_cast<const __m128i *>(K1K2));
+  for (; count >= 64; count -= 64, ptr += 64) {
+    x1 = fold(x1, keys, load(ptr));
+    x2 = fold(x2, keys, load(ptr + 16));
+    x3 = fold(x3, keys, load(ptr + 32));
+    x4 = fold(x4, keys, load(ptr + 48));
+  }
+
+  // четыре полосы сворачиваются в одну, затем остаток по 16 байт
+  keys = _mm_load_si128(reinterpret_cast<const __m128i *>(K3K4));
+  x1 = fold(x1, keys, x2);
+  x1 = fold(x1, keys, x3);
+  x1 = fold(x1, keys, x4);
+  for (; count >= 16; count -= 16, ptr += 16) {
+    x1 = fold(x1, keys, load(ptr));
+  }
+
+  // 128 -> 64 бит
+  const __m128i MASK32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, keys, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  keys = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(K5K0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, MASK32), keys, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // редукция Барретта до 32 бит
+  keys = _mm_load_si128(reinterpret_cast<const __m128i *>(POLY));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, MASK32), keys, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, MASK32), keys, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+#endif
+
+auto detect_clmul() -> bool {
+#ifdef CRC_SOFT_CLMUL
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#else
+  return false;
+#endif
+}
+
+// Выбор ядра один раз за процесс
+const bool HAS_CLMUL = detect_clmul();
+
+inline auto large(uint32_t crc, const uint8_t *ptr, size_t count) -> uint32_t {
+#ifdef CRC_SOFT_CLMUL
+  if (HAS_CLMUL) {
+    const size_t FOLDED = count & ~static_cast<size_t>(15);
+    crc = clmul_fold(crc, ptr, FOLDED);
+    ptr += FOLDED;
+    count -= FOLDED;
+  }
+#endif
+  return slice16(crc, ptr, count);
+}
+}  // namespace
+
+void CrcSoft::reset() {}
+
+auto CrcSoft::calc(const CustomSpan<uint8_t> DATA) -> uint32_t {
+  return append(0, DATA);
+}
+
+auto CrcSoft::append(const uint32_t CRC, const CustomSpan<uint8_t> DATA)
+    -> uint32_t {
+  if (DATA.size() >= CLMUL_THRESHOLD) {
+    return append_clmul(CRC, DATA);
+  }
+  if (DATA.size() >= SLICE_THRESHOLD) {
+    return append_slice16(CRC, DATA);
+  }
+  return append_bytewise(CRC, DATA);
+}
+
+auto CrcSoft::append_bytewise(const uint32_t CRC,
+                              const CustomSpan<uint8_t> DATA) -> uint32_t {
+  return ~bytewise(~CRC, DATA.data(), DATA.size());
+}
+
+auto CrcSoft::append_slice8(const uint32_t CRC, const CustomSpan<uint8_t> DATA)
+    -> uint32_t {
+  return ~slice8(~CRC, DATA.data(), DATA.size());
+}
+
+auto CrcSoft::append_slice16(const uint32_t CRC,
+                             const CustomSpan<uint8_t> DATA) -> uint32_t {
+  return ~slice16(~CRC, DATA.data(), DATA.size());
+}
+
+auto CrcSoft::append_clmul(const uint32_t CRC, const CustomSpan<uint8_t> DATA)
+    -> uint32_t {
+  if (DATA.size() < CLMUL_THRESHOLD) {
+    return append_slice16(CRC, DATA);
+  }
+  return ~large(~CRC, DATA.data(), DATA.size());
+}
+
+auto CrcSoft::has_clmul() -> bool { return HAS_CLMUL; }
+
+auto CrcSoft::combine(const uint32_t CRC_A, const uint32_t CRC_B,
+                      const size_t LEN_B) -> uint32_t {
+  return Crc32IsoHdlc::combine(CRC_A, CRC_B, LEN_B);
 }
@@ -10,26 +10,50 @@
 
 class CrcSoft : public ICrc {
  public:
-  CrcSoft() : ICrc("crc32 arm module") {
-    for (int i = 0; i < 256; ++i) {
-      uint32_t CRR = i;
-      uint32_t CHAR = i << 24;
-      for (int j = CHAR_BIT; j > 0; --j) {
-        CHAR =
-            (CHAR & 0x80000000) != 0U ? (CHAR << 1) ^ CRC32_POLY : (CHAR << 1);
-        CRR = (CRR & 0x00000001) != 0U ? (CRR >> 1) ^ CRC32_POLY_R : (CRR >> 1);
-      }
-      crc32_table_[i] = CHAR;
-      crc32r_table_[i] = CRR;
-    }
-  }
+  /// Tables are compile-time constants shared by all instances, so an
+  /// instance is just the ICrc base and costs nothing to construct.
+  CrcSoft() : ICrc("crc32 arm module") {}
+
+  /// Inputs of at least this many bytes take the slicing-by-16 path.
+  static constexpr size_t SLICE_THRESHOLD = 16;
+  /// From this size on, append() folds with PCLMULQDQ when the CPU has it.
+  static constexpr size_t CLMUL_THRESHOLD = 64;
+
   void reset() override;
 
   auto calc(CustomSpan<uint8_t> /*unused*/) -> uint32_t override;
   auto append(uint32_t crc, CustomSpan<uint8_t> /*unused*/)
       -> uint32_t override;
 
- private:
-  std::array<uint32_t, UINT8_MAX + 1> crc32_table_{};
-  std::array<uint32_t, UINT8_MAX + 1> crc32r_table_{};
+  /// @brief One table lookup per byte; what append() uses for short inputs.
+  static auto append_bytewise(uint32_t crc, CustomSpan<uint8_t> data)
+      -> uint32_t;
+
+  /**
+   * @brief Slicing-by-8/16: 8 or 16 bytes per step through 8 or 16 tables
+   * (constexpr, shared by all instances).
+   *
+   * Same result as append(); exposed for benchmarks.
+   */
+  static auto append_slice8(uint32_t crc, CustomSpan<uint8_t> data)
+      -> uint32_t;
+  static auto append_slice16(uint32_t crc, CustomSpan<uint8_t> data)
+      -> uint32_t;
+
+  /**
+   * @brief Carry-less multiply folding on x86 CPUs with PCLMULQDQ and
+   * SSE4.1, chosen once at startup; slicing-by-16 elsewhere and for the
+   * last 0..15 bytes.
+   */
+  static auto append_clmul(uint32_t crc, CustomSpan<uint8_t> data)
+      -> uint32_t;
+  /// @brief Whether append_clmul() runs the PCLMULQDQ kernel on this CPU.
+  static auto has_clmul() -> bool;
+
+  /**
+   * @brief CRC of A followed by B from CRC(A), CRC(B) and the length of B
+   * (zlib's crc32_combine), for checksumming a buffer in parallel pieces.
+   */
+  static auto combine(uint32_t crc_a, uint32_t crc_b, size_t len_b)
+      -> uint32_t;
 };
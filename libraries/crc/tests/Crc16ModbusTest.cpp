@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Crc16Modbus.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using proto::test::pattern;
+
+TEST(Crc16ModbusTest, CheckValue) {
+  Crc16Modbus crc;
+  const char* TEXT = "123456789";
+  const CustomSpan<uint8_t> DATA(reinterpret_cast<const uint8_t*>(TEXT), 9);
+  EXPECT_EQ(crc.calc(DATA), 0x4B37U);
+  EXPECT_EQ(crc.append(Crc16Modbus::INITIAL, DATA), 0x4B37U);
+  EXPECT_EQ(Crc16Modbus::append_nibble(Crc16Modbus::INITIAL, DATA), 0x4B37U);
+  EXPECT_EQ(CrcInitial<Crc16Modbus>::value, 0xFFFFU);
+}
+
+/// @test A board frame captured from the Lacte test: the CRC covers LEN,
+/// TYPE and DATA and is sent high byte first.
+TEST(Crc16ModbusTest, LacteFrame) {
+  const uint8_t FRAME[] = {0xff, 0xaa, 0x0d, 0x02, 0x32, 0xff,
+                           0xd8, 0x05, 0x47, 0x50, 0x35, 0x32,
+                           0x30, 0x64, 0x24, 0x57, 0x9e, 0xad};
+  Crc16Modbus crc;
+  EXPECT_EQ(crc.calc({FRAME + 2, sizeof(FRAME) - 4}), 0x9EADU);
+}
+
+/**
+ * @test The table kernels match the original nibble loop for every length
+ * up to 100 and every starting value class, and append() is stateless: the
+ * same call gives the same result however often it is repeated, and a frame
+ * split at arbitrary points chains to the CRC of the whole.
+ */
+TEST(Crc16ModbusTest, KernelsMatchNibble) {
+  Crc16Modbus crc;
+  const auto DATA = pattern(100 + 4);
+  for (const uint32_t START : {0x0000U, 0xFFFFU, 0x1234U}) {
+    for (size_t offset = 0; offset < 4; ++offset) {
+      for (size_t size = 0; size <= 100; ++size) {
+        const CustomSpan<uint8_t> SPAN(DATA.data() + offset, size);
+        const uint32_t EXPECTED = Crc16Modbus::append_nibble(START, SPAN);
+        ASSERT_EQ(Crc16Modbus::append_bytewise(START, SPAN), EXPECTED) << size;
+        ASSERT_EQ(Crc16Modbus::append_slice4(START, SPAN), EXPECTED) << size;
+        ASSERT_EQ(crc.append(START, SPAN), EXPECTED) << size;
+        ASSERT_EQ(crc.append(START, SPAN), EXPECTED) << size;
+      }
+    }
+  }
+
+  const auto BIG = pattern(5'000);
+  const uint32_t WHOLE = crc.calc({BIG.data(), BIG.size()});
+  uint32_t chained = Crc16Modbus::INITIAL;
+  size_t done = 0;
+  for (size_t step = 1; done < BIG.size(); step = step * 3 % 97 + 1) {
+    const size_t COUNT = std::min(step, BIG.size() - done);
+    chained = crc.append(chained, {BIG.data() + done, COUNT});
+    done += COUNT;
+  }
+  EXPECT_EQ(chained, WHOLE);
+}
+
+/// @test combine() gives the CRC of the whole from the CRCs of two pieces.
+TEST(Crc16ModbusTest, Combine) {
+  Crc16Modbus crc;
+  const auto DATA = pattern(10'000);
+  const uint32_t WHOLE = crc.calc({DATA.data(), DATA.size()});
+  for (const size_t SPLIT : {0, 1, 3, 255, 4096, 9'999, 10'000}) {
+    const uint32_t HEAD = crc.calc({DATA.data(), SPLIT});
+    const uint32_t TAIL = crc.calc({DATA.data() + SPLIT, DATA.size() - SPLIT});
+    EXPECT_EQ(Crc16Modbus::combine(HEAD, TAIL, DATA.size() - SPLIT), WHOLE)
+        << SPLIT;
+  }
+}
+
+/**
+ * @test CRC of a Lacte frame the way RxContainer::check_crc computes it:
+ * one append per IS_IN_CRC field (LEN 1, TIME 4, TYPE 1, DATA n bytes).
+ */
+TEST(Crc16ModbusTest, LacteFrameBenchmark) {
+  Crc16Modbus crc;
+  const auto DATA = pattern(255);
+  constexpr size_t FRAMES = 200'000;
+
+  auto measure = [&](const size_t SIZE, auto&& fn) {
+    const size_t FIELDS[] = {1, 4, 1, SIZE};
+    uint32_t value = 0;
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < FRAMES; ++i) {
+      uint32_t frame = Crc16Modbus::INITIAL ^ (value & 1U);
+      const uint8_t* ptr = DATA.data();
+      for (const size_t FIELD : FIELDS) {
+        frame = fn(frame, CustomSpan<uint8_t>(ptr, FIELD));
+        ptr += FIELD;
+      }
+      value += frame;
+    }
+    const std::chrono::duration<double, std::nano> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    EXPECT_NE(value, 1U);  // результат используется
+    return ELAPSED.count() / FRAMES;
+  };
+
+  std::printf("\n%10s | %10s | %10s | %10s | %10s\n", "data bytes", "nibble",
+              "bytewise", "slice4", "append");
+  for (const size_t SIZE : {0, 8, 32, 64, 128, 248}) {
+    const double NIBBLE = measure(SIZE, [](uint32_t value, auto span) {
+      return Crc16Modbus::append_nibble(value, span);
+    });
+    const double BYTEWISE = measure(SIZE, [](uint32_t value, auto span) {
+      return Crc16Modbus::append_bytewise(value, span);
+    });
+    const double SLICE4 = measure(SIZE, [](uint32_t value, auto span) {
+      return Crc16Modbus::append_slice4(value, span);
+    });
+    const double APPEND = measure(SIZE, [&](uint32_t value, auto span) {
+      return crc.append(value, span);
+    });
+    std::printf("%10zu | %10.1f | %10.1f | %10.1f | %10.1f  ns/frame\n", SIZE,
+                NIBBLE, BYTEWISE, SLICE4, APPEND);
+  }
+}
+}  // namespace
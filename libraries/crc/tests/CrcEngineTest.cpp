@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Crc16Modbus.hpp"
+#include "CrcEngine.hpp"
+#include "CrcSoft.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using proto::test::pattern;
+
+constexpr uint8_t CHECK[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+// Check values from the CRC catalogue, computed by the compiler
+static_assert(Crc32IsoHdlc::compute(CHECK, 9) == 0xCBF43926U);
+static_assert(Crc16ModbusEngine::compute(CHECK, 9) == 0x4B37U);
+static_assert(Crc16Xmodem::compute(CHECK, 9) == 0x31C3U);
+static_assert(Crc16Ccitt::compute(CHECK, 9) == 0x29B1U);
+static_assert(Crc8Smbus::compute(CHECK, 9) == 0xF4U);
+static_assert(CrcInitial<Crc32IsoHdlc>::value == 0);
+static_assert(CrcInitial<Crc16ModbusEngine>::value == 0xFFFF);
+static_assert(sizeof(Crc16Xmodem) == 1, "no state");
+
+// Less common shapes: odd widths, mixed reflection, non-zero init
+using Crc12Umts = CrcEngine<12, 0x80F, 0x000, false, true, 0x000>;
+using Crc24OpenPgp = CrcEngine<24, 0x864CFB, 0xB704CE, false, false, 0>;
+using Crc32Bzip2 =
+    CrcEngine<32, 0x04C11DB7, 0xFFFFFFFF, false, false, 0xFFFFFFFF>;
+using Crc32C = CrcEngine<32, 0x1EDC6F41, 0xFFFFFFFF, true, true, 0xFFFFFFFF>;
+using Crc8Maxim = CrcEngine<8, 0x31, 0x00, true, true, 0x00>;
+static_assert(Crc12Umts::compute(CHECK, 9) == 0xDAFU);
+static_assert(Crc24OpenPgp::compute(CHECK, 9) == 0x21CF02U);
+static_assert(Crc32Bzip2::compute(CHECK, 9) == 0xFC891918U);
+static_assert(Crc32C::compute(CHECK, 9) == 0xE3069283U);
+static_assert(Crc8Maxim::compute(CHECK, 9) == 0xA1U);
+
+// "1234" + "56789" joined from the two CRCs alone
+static_assert(Crc32IsoHdlc::combine(Crc32IsoHdlc::compute(CHECK, 4),
+                                    Crc32IsoHdlc::compute(CHECK + 4, 5),
+                                    5) == 0xCBF43926U);
+static_assert(Crc16Xmodem::combine(Crc16Xmodem::compute(CHECK, 4),
+                                   Crc16Xmodem::compute(CHECK + 4, 5),
+                                   5) == 0x31C3U);
+
+// The sliced loop against the single-table one, and chaining of appends
+template <typename Engine, typename Bytewise>
+void expect_consistent(const std::vector<uint8_t>& data) {
+  Engine engine;
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t size = 0; size + offset <= data.size(); size += 1 + size / 8) {
+      const CustomSpan<uint8_t> SPAN(data.data() + offset, size);
+      const uint32_t EXPECTED = Bytewise::compute(SPAN.data(), SPAN.size());
+      ASSERT_EQ(engine.calc(SPAN), EXPECTED) << size;
+      const size_t HALF = size / 3;
+      const uint32_t HEAD =
+          engine.append(Engine::INITIAL, SPAN.subspan(0, HALF));
+      ASSERT_EQ(engine.append(HEAD, SPAN.subspan(HALF)), EXPECTED) << size;
+    }
+  }
+}
+
+/**
+ * @test Every slicing degree gives the single-table result for all lengths
+ * and alignments, and appends chain, for each register size and reflection.
+ */
+TEST(CrcEngineTest, SlicedMatchesBytewise) {
+  const auto DATA = pattern(600);
+  expect_consistent<Crc32IsoHdlc,
+                    CrcEngine<32, 0x04C11DB7, 0xFFFFFFFF, true, true,
+                              0xFFFFFFFF, 1>>(DATA);
+  expect_consistent<Crc32Bzip2, CrcEngine<32, 0x04C11DB7, 0xFFFFFFFF, false,
+                                          false, 0xFFFFFFFF, 1>>(DATA);
+  expect_consistent<Crc16ModbusEngine,
+                    CrcEngine<16, 0x8005, 0xFFFF, true, true, 0, 1>>(DATA);
+  expect_consistent<Crc16Xmodem,
+                    CrcEngine<16, 0x1021, 0, false, false, 0, 1>>(DATA);
+  expect_consistent<Crc12Umts,
+                    CrcEngine<12, 0x80F, 0, false, true, 0, 1>>(DATA);
+  expect_consistent<Crc24OpenPgp,
+                    CrcEngine<24, 0x864CFB, 0xB704CE, false, false, 0, 1>>(
+      DATA);
+  expect_consistent<Crc8Maxim, CrcEngine<8, 0x31, 0, true, true, 0, 1>>(DATA);
+  expect_consistent<CrcEngine<16, 0x1021, 0xFFFF, false, false, 0, 4>,
+                    CrcEngine<16, 0x1021, 0xFFFF, false, false, 0, 1>>(DATA);
+}
+
+// combine() against the CRC of the concatenation, for every split point
+template <typename Engine>
+void expect_combines(const std::vector<uint8_t>& data) {
+  for (size_t size = 0; size <= data.size(); size += 1 + size / 4) {
+    const uint32_t WHOLE = Engine::compute(data.data(), size);
+    for (size_t split = 0; split <= size; split += 1 + split / 3) {
+      const uint32_t HEAD = Engine::compute(data.data(), split);
+      const uint32_t TAIL = Engine::compute(data.data() + split, size - split);
+      ASSERT_EQ(Engine::combine(HEAD, TAIL, size - split), WHOLE)
+          << size << " split at " << split;
+    }
+  }
+}
+
+/**
+ * @test combine() joins two CRCs into the CRC of the concatenated data for
+ * every register size, reflection and init/xorout combination, including
+ * empty halves.
+ */
+TEST(CrcEngineTest, CombineMatchesConcatenation) {
+  const auto DATA = pattern(3000);
+  expect_combines<Crc32IsoHdlc>(DATA);
+  expect_combines<Crc32Bzip2>(DATA);
+  expect_combines<Crc32C>(DATA);
+  expect_combines<Crc24OpenPgp>(DATA);
+  expect_combines<Crc16ModbusEngine>(DATA);
+  expect_combines<Crc16Xmodem>(DATA);
+  expect_combines<Crc16Ccitt>(DATA);
+  expect_combines<Crc12Umts>(DATA);
+  expect_combines<Crc8Smbus>(DATA);
+  expect_combines<Crc8Maxim>(DATA);
+}
+
+/// @test The hand-written policies and their engine equivalents agree.
+TEST(CrcEngineTest, MatchesHandWrittenPolicies) {
+  const auto DATA = pattern(1000);
+  CrcSoft soft;
+  Crc16Modbus modbus;
+  for (size_t size = 0; size <= DATA.size(); size += 7) {
+    const CustomSpan<uint8_t> SPAN(DATA.data(), size);
+    EXPECT_EQ(Crc32IsoHdlc().calc(SPAN), soft.calc(SPAN)) << size;
+    EXPECT_EQ(Crc16ModbusEngine().calc(SPAN), modbus.calc(SPAN)) << size;
+  }
+}
+
+/// @test Throughput of the engine against the hand-written policies.
+TEST(CrcEngineTest, ThroughputBenchmark) {
+  const auto DATA = pattern(64 * 1024);
+  constexpr size_t TOTAL = 32U << 20U;
+
+  auto measure = [&](const size_t SIZE, auto&& fn) {
+    const size_t ROUNDS = TOTAL / SIZE;
+    uint32_t value = 0;
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ROUNDS; ++i) {
+      value = fn(value, CustomSpan<uint8_t>(DATA.data(), SIZE));
+    }
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    EXPECT_NE(value, 1U);  // результат используется
+    return static_cast<double>(ROUNDS * SIZE) / (1U << 20U) / ELAPSED.count();
+  };
+
+  CrcSoft soft;
+  Crc16Modbus modbus;
+  std::printf("\n%8s | %10s | %10s | %10s | %10s | %10s\n", "bytes",
+              "CrcSoft", "Crc32Eng", "Crc16Modb", "Crc16MEng", "Xmodem");
+  for (const size_t SIZE : {16, 64, 256, 4096, 65536}) {
+    const double SOFT = measure(SIZE, [&](uint32_t value, auto span) {
+      return soft.append(value, span);
+    });
+    const double ENGINE32 = measure(SIZE, [](uint32_t value, auto span) {
+      return Crc32IsoHdlc().append(value, span);
+    });
+    const double MODBUS = measure(SIZE, [&](uint32_t value, auto span) {
+      return modbus.append(value, span);
+    });
+    const double ENGINE16 = measure(SIZE, [](uint32_t value, auto span) {
+      return Crc16ModbusEngine().append(value, span);
+    });
+    const double XMODEM = measure(SIZE, [](uint32_t value, auto span) {
+      return Crc16Xmodem().append(value, span);
+    });
+    std::printf("%8zu | %10.0f | %10.0f | %10.0f | %10.0f | %10.0f  MiB/s\n",
+                SIZE, SOFT, ENGINE32, MODBUS, ENGINE16, XMODEM);
+  }
+}
+}  // namespace
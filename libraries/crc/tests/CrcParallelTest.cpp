@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Crc16Modbus.hpp"
+#include "CrcEngine.hpp"
+#include "CrcParallel.hpp"
+#include "CrcSoft.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using proto::test::pattern;
+
+/**
+ * @test Every thread count, including more threads than chunks and sizes
+ * that do not divide evenly, gives the single-threaded CRC.
+ */
+TEST(CrcParallelTest, MatchesSequential) {
+  const auto DATA = pattern(5 * CRC_PARALLEL_MIN_CHUNK + 12'345);
+  CrcSoft soft;
+  Crc16Modbus modbus;
+  for (const size_t SIZE : {size_t{0}, size_t{1000}, 2 * CRC_PARALLEL_MIN_CHUNK,
+                            DATA.size()}) {
+    const CustomSpan<uint8_t> SPAN(DATA.data(), SIZE);
+    for (const size_t THREADS : {0, 1, 2, 3, 4, 7, 16}) {
+      EXPECT_EQ(crc_parallel_calc<CrcSoft>(SPAN, THREADS), soft.calc(SPAN))
+          << SIZE << " bytes, " << THREADS << " threads";
+      EXPECT_EQ(crc_parallel_calc<Crc16Modbus>(SPAN, THREADS),
+                modbus.calc(SPAN))
+          << SIZE << " bytes, " << THREADS << " threads";
+      EXPECT_EQ(crc_parallel_calc<Crc16Xmodem>(SPAN, THREADS),
+                Crc16Xmodem::compute(SPAN.data(), SPAN.size()))
+          << SIZE << " bytes, " << THREADS << " threads";
+    }
+  }
+}
+
+/// @test Scaling of a 64 MiB checksum from one thread to twice the hardware
+/// threads.
+TEST(CrcParallelTest, ScalingBenchmark) {
+  const auto DATA = pattern(64U << 20U);
+  const CustomSpan<uint8_t> SPAN(DATA.data(), DATA.size());
+  constexpr int ROUNDS = 3;
+
+  auto measure = [&](const size_t THREADS, auto&& fn) {
+    uint32_t value = 0;
+    const auto START = std::chrono::steady_clock::now();
+    for (int i = 0; i < ROUNDS; ++i) {
+      value += fn(THREADS);
+    }
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    EXPECT_NE(value, 1U);  // результат используется
+    return static_cast<double>(ROUNDS * SPAN.size()) / (1U << 20U) /
+           ELAPSED.count();
+  };
+
+  const size_t CORES = std::max(1U, std::thread::hardware_concurrency());
+  std::printf("\nhardware threads: %zu\n", CORES);
+  std::printf("%8s | %10s | %10s | %10s\n", "threads", "CrcSoft", "Modbus",
+              "Xmodem");
+  for (size_t threads = 1; threads <= std::max<size_t>(2 * CORES, 4);
+       threads *= 2) {
+    const double SOFT = measure(threads, [&](const size_t THREADS) {
+      return crc_parallel_calc<CrcSoft>(SPAN, THREADS);
+    });
+    const double MODBUS = measure(threads, [&](const size_t THREADS) {
+      return crc_parallel_calc<Crc16Modbus>(SPAN, THREADS);
+    });
+    const double XMODEM = measure(threads, [&](const size_t THREADS) {
+      return crc_parallel_calc<Crc16Xmodem>(SPAN, THREADS);
+    });
+    std::printf("%8zu | %10.0f | %10.0f | %10.0f  MiB/s\n", threads, SOFT,
+                MODBUS, XMODEM);
+  }
+}
+}  // namespace
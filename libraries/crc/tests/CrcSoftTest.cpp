@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "CrcSoft.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using proto::test::pattern;
+
+TEST(CrcSoftTest, CheckValue) {
+  CrcSoft crc;
+  const char* TEXT = "123456789";
+  const CustomSpan<uint8_t> DATA(reinterpret_cast<const uint8_t*>(TEXT), 9);
+  EXPECT_EQ(crc.calc(DATA), 0xCBF43926U);
+  EXPECT_EQ(crc.append(0, DATA), 0xCBF43926U);
+  EXPECT_EQ(CrcSoft::append_slice8(0, DATA), 0xCBF43926U);
+  EXPECT_EQ(CrcSoft::append_slice16(0, DATA), 0xCBF43926U);
+  EXPECT_EQ(CrcSoft::append_clmul(0, DATA), 0xCBF43926U);
+}
+
+/**
+ * @test Every kernel matches the bytewise loop for all lengths up to 300 at
+ * every alignment, and for a chain of appends split at arbitrary points.
+ */
+TEST(CrcSoftTest, KernelsMatchBytewise) {
+  CrcSoft crc;
+  const auto DATA = pattern(300 + 16);
+  for (size_t offset = 0; offset < 16; ++offset) {
+    for (size_t size = 0; size <= 300; ++size) {
+      const CustomSpan<uint8_t> SPAN(DATA.data() + offset, size);
+      const uint32_t EXPECTED = crc.append_bytewise(0x5A5A5A5A, SPAN);
+      ASSERT_EQ(crc.append(0x5A5A5A5A, SPAN), EXPECTED) << size;
+      ASSERT_EQ(CrcSoft::append_slice8(0x5A5A5A5A, SPAN), EXPECTED) << size;
+      ASSERT_EQ(CrcSoft::append_slice16(0x5A5A5A5A, SPAN), EXPECTED) << size;
+      ASSERT_EQ(CrcSoft::append_clmul(0x5A5A5A5A, SPAN), EXPECTED) << size;
+    }
+  }
+
+  const auto BIG = pattern(10'000);
+  const uint32_t WHOLE = crc.calc({BIG.data(), BIG.size()});
+  EXPECT_EQ(WHOLE, crc.append_bytewise(0, {BIG.data(), BIG.size()}));
+  uint32_t chained = 0;
+  size_t done = 0;
+  for (size_t step = 1; done < BIG.size(); step = step * 3 % 997 + 1) {
+    const size_t COUNT = std::min(step, BIG.size() - done);
+    chained = crc.append(chained, {BIG.data() + done, COUNT});
+    done += COUNT;
+  }
+  EXPECT_EQ(chained, WHOLE);
+}
+
+/// @test combine() gives the CRC of the whole from the CRCs of two pieces.
+TEST(CrcSoftTest, Combine) {
+  CrcSoft crc;
+  const auto DATA = pattern(100'000);
+  const uint32_t WHOLE = crc.calc({DATA.data(), DATA.size()});
+  for (const size_t SPLIT : {0, 1, 15, 4096, 65537, 99'999, 100'000}) {
+    const uint32_t HEAD = crc.calc({DATA.data(), SPLIT});
+    const uint32_t TAIL = crc.calc({DATA.data() + SPLIT, DATA.size() - SPLIT});
+    EXPECT_EQ(CrcSoft::combine(HEAD, TAIL, DATA.size() - SPLIT), WHOLE)
+        << SPLIT;
+  }
+}
+
+/**
+ * @test Tables are shared compile-time data: an instance is just the ICrc
+ * base.
+ */
+TEST(CrcSoftTest, InstancesAreEmpty) {
+  EXPECT_EQ(sizeof(CrcSoft), sizeof(ICrc));
+}
+
+/**
+ * @test Constructing an instance (as every RX/TX container does) builds
+ * nothing: construct + 1-byte append costs about as much as the append.
+ */
+TEST(CrcSoftTest, ConstructionBenchmark) {
+  constexpr int ROUNDS = 100'000;
+  alignas(CrcSoft) unsigned char storage[sizeof(CrcSoft)];
+  uint32_t value = 0;
+  const auto START = std::chrono::steady_clock::now();
+  for (int i = 0; i < ROUNDS; ++i) {
+    auto* crc = new (storage) CrcSoft();
+    value = crc->append(value, {storage, 1});
+    crc->~CrcSoft();
+  }
+  const std::chrono::duration<double, std::nano> ELAPSED =
+      std::chrono::steady_clock::now() - START;
+  EXPECT_NE(value, 1U);  // результат используется
+  std::printf("\nsizeof(CrcSoft) = %zu B, construct + 1-byte append: %.1f ns\n",
+              sizeof(CrcSoft), ELAPSED.count() / ROUNDS);
+}
+
+/**
+ * @test Throughput of the bytewise, slicing-by-8, slicing-by-16, PCLMULQDQ
+ * and automatically chosen paths, 16 B to 64 KiB.
+ */
+TEST(CrcSoftTest, ThroughputBenchmark) {
+  CrcSoft crc;
+  const auto DATA = pattern(64 * 1024);
+  constexpr size_t TOTAL = 64U << 20U;  // байт на каждое измерение
+
+  auto measure = [&](const size_t SIZE, auto&& fn) {
+    const size_t ROUNDS = TOTAL / SIZE;
+    uint32_t value = 0;
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ROUNDS; ++i) {
+      value = fn(value, CustomSpan<uint8_t>(DATA.data(), SIZE));
+    }
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    EXPECT_NE(value, 1U);  // результат используется
+    return static_cast<double>(ROUNDS * SIZE) / (1U << 20U) / ELAPSED.count();
+  };
+
+  std::printf("\npclmulqdq: %s\n", CrcSoft::has_clmul() ? "yes" : "no");
+  std::printf("%8s | %10s | %10s | %10s | %10s | %10s\n", "bytes",
+              "bytewise", "slice8", "slice16", "clmul", "append");
+  for (const size_t SIZE : {16, 64, 256, 1024, 4096, 16384, 65536}) {
+    const double BYTEWISE = measure(SIZE, [&](uint32_t value, auto span) {
+      return crc.append_bytewise(value, span);
+    });
+    const double SLICE8 = measure(SIZE, [](uint32_t value, auto span) {
+      return CrcSoft::append_slice8(value, span);
+    });
+    const double SLICE16 = measure(SIZE, [](uint32_t value, auto span) {
+      return CrcSoft::append_slice16(value, span);
+    });
+    const double CLMUL = measure(SIZE, [](uint32_t value, auto span) {
+      return CrcSoft::append_clmul(value, span);
+    });
+    const double APPEND = measure(SIZE, [&](uint32_t value, auto span) {
+      return crc.append(value, span);
+    });
+    std::printf("%8zu | %10.0f | %10.0f | %10.0f | %10.0f | %10.0f  MiB/s\n",
+                SIZE, BYTEWISE, SLICE8, SLICE16, CLMUL, APPEND);
+  }
+}
+}  // namespace
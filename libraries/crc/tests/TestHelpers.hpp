@@ -0,0 +1,24 @@
+/**
+ * @file TestHelpers.hpp
+ * @brief Test data shared by the CRC tests.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace proto::test {
+
+/// @brief @p size pseudo-random bytes (LCG), the same on every run.
+inline auto pattern(const size_t SIZE, uint32_t state = 0x12345678)
+    -> std::vector<uint8_t> {
+  std::vector<uint8_t> data(SIZE);
+  for (auto& byte : data) {
+    state = state * 1664525U + 1013904223U;
+    byte = static_cast<uint8_t>(state >> 24);
+  }
+  return data;
+}
+}  // namespace proto::test
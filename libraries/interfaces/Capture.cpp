@@ -0,0 +1,361 @@
+#include "Capture.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace proto::interface {
+
+namespace {
+// File layout: FileHeader, then records of RecordHeader + payload back to
+// back. The staging rings carry the same records.
+struct FileHeader {
+  static constexpr uint32_t MAGIC = 0x50435250;  // "PRCP"
+  static constexpr uint16_t VERSION = 1;
+  uint32_t m_magic;
+  uint16_t m_version;
+  uint16_t m_record_header;  // sizeof(RecordHeader), for forward checks
+  uint64_t m_reserved;
+};
+
+struct RecordHeader {
+  uint64_t m_time_ns;
+  uint32_t m_size;
+  uint8_t m_direction;
+  uint8_t m_reserved[3];
+};
+
+static_assert(sizeof(FileHeader) == 16 && sizeof(RecordHeader) == 16,
+              "Capture file layout must not depend on the compiler");
+
+// Record chunks go through ByteRing whole: the payload is pushed right after
+// the header, so a consumer that saw the header only waits for a producer
+// that is already copying.
+void pop_exact(ByteRing& ring, uint8_t* out, size_t count) {
+  while (count > 0) {
+    const size_t TAKEN = ring.pop(out, count);
+    out += TAKEN;
+    count -= TAKEN;
+    if (TAKEN == 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+}  // namespace
+
+CaptureInterface::CaptureInterface(IInterface& inner, std::string path,
+                                   const CaptureOptions& options)
+    : IInterface("capture interface"),
+      inner_(inner),
+      path_(std::move(path)),
+      options_(options),
+      rings_{ByteRing(options.m_buffer), ByteRing(options.m_buffer)} {
+  inner_delegate_ = inner_.add_receive_callback(
+      [this](CustomSpan<uint8_t> data, size_t& read) {
+        record(CaptureDirection::RX, data);
+        m_callbacks.for_each(
+            [&](CallbackType& callback) { callback(data, read); });
+      });
+}
+
+CaptureInterface::~CaptureInterface() { close(); }
+
+auto CaptureInterface::write(const CustomSpan<uint8_t> BUFFER,
+                             const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  if (!inner_.write(BUFFER, TIMEOUT)) {
+    return false;
+  }
+  std::lock_guard lock(tx_mtx_);  // кольцо TX рассчитано на одного писателя
+  record(CaptureDirection::TX, BUFFER);
+  return true;
+}
+
+auto CaptureInterface::flush() -> bool { return inner_.flush(); }
+
+auto CaptureInterface::is_open() -> bool { return inner_.is_open(); }
+
+auto CaptureInterface::open() -> bool {
+  if (!recording_) {
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+      return false;
+    }
+    mapped_ = std::max(options_.m_file_step, sizeof(FileHeader));
+    void* address = MAP_FAILED;
+    if (ftruncate(fd_, static_cast<off_t>(mapped_)) == 0) {
+      address =
+          mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    }
+    if (address == MAP_FAILED) {
+      ::close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    map_ = static_cast<uint8_t*>(address);
+    const FileHeader HEADER{FileHeader::MAGIC, FileHeader::VERSION,
+                            sizeof(RecordHeader), 0};
+    std::memcpy(map_, &HEADER, sizeof(HEADER));
+    used_ = sizeof(HEADER);
+    start_ = std::chrono::steady_clock::now();
+    recording_ = true;
+    writer_thread_ = std::thread([this] { writer_loop(); });
+  }
+  return inner_.open();
+}
+
+auto CaptureInterface::close() -> bool {
+  const bool RESULT = inner_.close();
+  {
+    std::lock_guard lock(tx_mtx_);  // запись TX в полёте доходит до кольца
+    if (!recording_.exchange(false)) {
+      return RESULT;
+    }
+  }
+  if (writer_thread_.joinable()) {
+    writer_thread_.join();  // поток дописывает остаток колец
+  }
+  munmap(map_, mapped_);
+  map_ = nullptr;
+  const bool TRIMMED = ftruncate(fd_, static_cast<off_t>(used_)) == 0;
+  ::close(fd_);
+  fd_ = -1;
+  return RESULT && TRIMMED;
+}
+
+void CaptureInterface::record(const CaptureDirection DIRECTION,
+                              const CustomSpan<uint8_t> DATA) {
+  if (!recording_ || DATA.empty()) {
+    return;
+  }
+  ByteRing& ring = rings_[static_cast<size_t>(DIRECTION)];
+  if (ring.capacity() - ring.size() < sizeof(RecordHeader) + DATA.size()) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const RecordHeader HEADER{
+      static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start_)
+              .count()),
+      static_cast<uint32_t>(DATA.size()),
+      static_cast<uint8_t>(DIRECTION),
+      {}};
+  ring.push({reinterpret_cast<const uint8_t*>(&HEADER), sizeof(HEADER)});
+  ring.push(DATA);
+}
+
+void CaptureInterface::writer_loop() {
+  while (recording_) {
+    const bool RX = drain(rings_[0]);
+    const bool TX = drain(rings_[1]);
+    if (!RX && !TX) {
+      // пауза вместо пробуждения: горячий путь не делает системных вызовов
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  drain(rings_[0]);
+  drain(rings_[1]);
+}
+
+auto CaptureInterface::drain(ByteRing& ring) -> bool {
+  bool any = false;
+  while (ring.size() >= sizeof(RecordHeader)) {
+    RecordHeader header{};
+    pop_exact(ring, reinterpret_cast<uint8_t*>(&header), sizeof(header));
+    uint8_t* out = reserve(sizeof(header) + header.m_size);
+    if (out == nullptr) {
+      // диск полон: запись теряется, но кольцо нужно освободить
+      std::vector<uint8_t> discard(header.m_size);
+      pop_exact(ring, discard.data(), discard.size());
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    std::memcpy(out, &header, sizeof(header));
+    pop_exact(ring, out + sizeof(header), header.m_size);
+    used_ += sizeof(header) + header.m_size;
+    any = true;
+  }
+  return any;
+}
+
+auto CaptureInterface::reserve(const size_t SIZE) -> uint8_t* {
+  if (used_ + SIZE > mapped_) {
+    const size_t GROWN = mapped_ + std::max(options_.m_file_step, SIZE);
+    if (ftruncate(fd_, static_cast<off_t>(GROWN)) != 0) {
+      return nullptr;
+    }
+    void* address = mremap(map_, mapped_, GROWN, MREMAP_MAYMOVE);
+    if (address == MAP_FAILED) {
+      return nullptr;
+    }
+    map_ = static_cast<uint8_t*>(address);
+    mapped_ = GROWN;
+  }
+  return map_ + used_;
+}
+
+auto CaptureInterface::read(uint8_t* /*buffer*/, size_t /*count*/) -> int {
+  return 0;  // приём идёт через обратный вызов обёрнутого интерфейса
+}
+
+CaptureReader::~CaptureReader() { close(); }
+
+auto CaptureReader::open(const std::string& path) -> bool {
+  close();
+  const int FD = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (FD < 0) {
+    return false;
+  }
+  struct stat info {};
+  void* address = MAP_FAILED;
+  if (fstat(FD, &info) == 0 &&
+      static_cast<size_t>(info.st_size) >= sizeof(FileHeader)) {
+    address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                   MAP_PRIVATE, FD, 0);
+  }
+  ::close(FD);  // отображение живёт и без дескриптора
+  if (address == MAP_FAILED) {
+    return false;
+  }
+  map_ = static_cast<uint8_t*>(address);
+  size_ = static_cast<size_t>(info.st_size);
+
+  FileHeader file{};
+  std::memcpy(&file, map_, sizeof(file));
+  if (file.m_magic != FileHeader::MAGIC ||
+      file.m_version != FileHeader::VERSION ||
+      file.m_record_header != sizeof(RecordHeader)) {
+    close();
+    return false;
+  }
+  // a file cut short by a crash keeps its complete records; one that was
+  // never trimmed ends in zeros, and record() never writes empty chunks
+  size_t offset = sizeof(FileHeader);
+  while (offset + sizeof(RecordHeader) <= size_) {
+    RecordHeader header{};
+    std::memcpy(&header, map_ + offset, sizeof(header));
+    offset += sizeof(header);
+    if (header.m_size == 0 || header.m_size > size_ - offset ||
+        header.m_direction > static_cast<uint8_t>(CaptureDirection::TX)) {
+      break;
+    }
+    records_.push_back({std::chrono::nanoseconds(header.m_time_ns),
+                        static_cast<CaptureDirection>(header.m_direction),
+                        {map_ + offset, header.m_size}});
+    offset += header.m_size;
+  }
+  // each direction is written in order; interleave them by time
+  std::stable_sort(records_.begin(), records_.end(),
+                   [](const CaptureRecord& lhs, const CaptureRecord& rhs) {
+                     return lhs.m_time < rhs.m_time;
+                   });
+  return true;
+}
+
+void CaptureReader::close() {
+  if (map_ != nullptr) {
+    munmap(map_, size_);
+  }
+  map_ = nullptr;
+  size_ = 0;
+  records_.clear();
+}
+
+ReplayInterface::ReplayInterface(const ReplayOptions& options)
+    : IInterface("replay interface"), options_(options) {}
+
+ReplayInterface::~ReplayInterface() { close(); }
+
+auto ReplayInterface::load(const std::string& path) -> bool {
+  close();
+  if (on_replay_thread()) {
+    return false;  // отображение ещё читает поток воспроизведения
+  }
+  return reader_.open(path);
+}
+
+auto ReplayInterface::write(CustomSpan<uint8_t> /*buffer*/,
+                            std::chrono::milliseconds /*timeout*/) -> bool {
+  return is_open_;
+}
+
+auto ReplayInterface::is_open() -> bool { return is_open_; }
+
+auto ReplayInterface::open() -> bool {
+  if (on_replay_thread()) {
+    return false;  // поток не может перезапустить сам себя
+  }
+  if (!is_open_.exchange(true)) {
+    if (replay_thread_.joinable()) {
+      replay_thread_.join();
+    }
+    done_ = false;
+    delivered_ = 0;
+    replay_thread_ = std::thread([this] { replay_loop(); });
+  }
+  return true;
+}
+
+auto ReplayInterface::close() -> bool {
+  is_open_ = false;
+  if (on_replay_thread()) {
+    return true;  // из колбэка: поток выйдет из цикла сам, его дождутся позже
+  }
+  if (replay_thread_.joinable()) {
+    replay_thread_.join();
+  }
+  return true;
+}
+
+auto ReplayInterface::on_replay_thread() const -> bool {
+  return replay_id_.load() == std::this_thread::get_id();
+}
+
+auto ReplayInterface::wait_done(const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  while (!done_) {
+    if (std::chrono::steady_clock::now() >= DEADLINE) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void ReplayInterface::replay_loop() {
+  replay_id_ = std::this_thread::get_id();
+  const auto& records = reader_.records();
+  const auto FIRST = std::find_if(
+      records.begin(), records.end(), [this](const CaptureRecord& record) {
+        return record.m_direction == options_.m_direction;
+      });
+  for (size_t pass = 0; pass < options_.m_repeat && is_open_; ++pass) {
+    const auto PASS_START = std::chrono::steady_clock::now();
+    for (auto it = FIRST; it != records.end() && is_open_; ++it) {
+      if (it->m_direction != options_.m_direction) {
+        continue;
+      }
+      if (options_.m_pacing == ReplayPacing::ORIGINAL) {
+        std::this_thread::sleep_until(PASS_START + (it->m_time - FIRST->m_time));
+      }
+      size_t read = 0;
+      m_callbacks.for_each(
+          [&](CallbackType& callback) { callback(it->m_data, read); });
+      delivered_.fetch_add(it->m_data.size(), std::memory_order_relaxed);
+    }
+  }
+  replay_id_ = std::thread::id{};
+  done_ = true;
+}
+
+auto ReplayInterface::read(uint8_t* /*buffer*/, size_t /*count*/) -> int {
+  return 0;  // данные раздаёт поток воспроизведения прямо из отображения
+}
+}  // namespace proto::interface
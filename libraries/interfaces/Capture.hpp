@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CustomSpan.hpp"
+#include "Interface.hpp"
+#include "Loopback.hpp"
+
+namespace proto::interface {
+
+enum class CaptureDirection : uint8_t {
+  RX,  //!< Bytes the wrapped interface received.
+  TX   //!< Bytes written through the wrapped interface.
+};
+
+/// @brief One chunk from a capture file; m_data points into the mapping.
+struct CaptureRecord {
+  std::chrono::nanoseconds m_time;  //!< Since the capture was opened.
+  CaptureDirection m_direction;
+  CustomSpan<uint8_t> m_data;
+};
+
+struct CaptureOptions {
+  /// Lock-free staging ring per direction; a chunk that does not fit is
+  /// dropped and counted in dropped().
+  size_t m_buffer{1U << 20U};
+  /// The file grows by at least this much each time the mapping is full.
+  size_t m_file_step{16U << 20U};
+};
+
+/**
+ * @brief Decorator that records every RX and TX chunk of another interface
+ * into an append-only memory-mapped file.
+ *
+ * write() and the receive path only stamp the chunk with steady_clock and
+ * copy it into a lock-free ring (one per direction); a writer thread moves
+ * the records into the mapped file. Concurrent write() calls share the TX
+ * ring under a short lock, the same way the wrapped interfaces serialize
+ * their writes. Read the file back with CaptureReader or feed it to
+ * ReplayInterface.
+ *
+ * @code{.cpp}
+ * CaptureInterface capture(uart, "/tmp/session.cap");
+ * capture.open();
+ * endpoint.set_interfaces(capture, capture);
+ * @endcode
+ */
+class CaptureInterface final : public IInterface {
+ public:
+  /// @param inner Interface to record; must outlive the decorator.
+  CaptureInterface(IInterface& inner, std::string path,
+                   const CaptureOptions& options = {});
+  ~CaptureInterface() override;
+
+  CaptureInterface(const CaptureInterface&) = delete;
+  auto operator=(const CaptureInterface&) -> CaptureInterface& = delete;
+
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+  auto flush() -> bool override;
+
+  auto is_open() -> bool override;
+
+  /// @brief Truncate the file, start recording and open the wrapped
+  /// interface.
+  auto open() -> bool override;
+
+  /// @brief Close the wrapped interface, write out staged records and trim
+  /// the file to its contents.
+  auto close() -> bool override;
+
+  /// @brief Chunks lost because a staging ring was full.
+  [[nodiscard]] auto dropped() const -> uint64_t {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  IInterface& inner_;
+  std::string path_;
+  CaptureOptions options_;
+  ByteRing rings_[2];  // indexed by CaptureDirection
+  std::mutex tx_mtx_;
+  std::atomic_bool recording_{false};
+  std::atomic<uint64_t> dropped_{0};
+  std::chrono::steady_clock::time_point start_;
+  Delegate inner_delegate_;
+
+  // Owned by the writer thread while recording
+  std::thread writer_thread_;
+  int fd_{-1};
+  uint8_t* map_{nullptr};
+  size_t mapped_{0};
+  size_t used_{0};
+
+  void record(CaptureDirection direction, CustomSpan<uint8_t> data);
+  void on_receive(CustomSpan<uint8_t> data);
+  void writer_loop();
+  auto drain(ByteRing& ring) -> bool;
+  auto reserve(size_t size) -> uint8_t*;
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+
+/// @brief Read-only view of a capture file, records sorted by time.
+class CaptureReader {
+ public:
+  CaptureReader() = default;
+  ~CaptureReader();
+
+  CaptureReader(const CaptureReader&) = delete;
+  auto operator=(const CaptureReader&) -> CaptureReader& = delete;
+
+  /// @brief Map @p path and index its records; false if it is not a
+  /// capture file.
+  auto open(const std::string& path) -> bool;
+  void close();
+
+  [[nodiscard]] auto records() const -> const std::vector<CaptureRecord>& {
+    return records_;
+  }
+
+ private:
+  uint8_t* map_{nullptr};
+  size_t size_{0};
+  std::vector<CaptureRecord> records_;
+};
+
+enum class ReplayPacing : uint8_t {
+  ORIGINAL,  //!< Deliver each chunk at its recorded time.
+  MAX_SPEED  //!< Deliver chunks back to back.
+};
+
+struct ReplayOptions {
+  ReplayPacing m_pacing{ReplayPacing::ORIGINAL};
+  /// Chunks to replay; RX feeds the parser what the device sent.
+  CaptureDirection m_direction{CaptureDirection::RX};
+  size_t m_repeat{1};  //!< Passes over the capture.
+};
+
+/**
+ * @brief Feeds a capture back to the receive callbacks, e.g. into
+ * RxContainer, for reproducible parser runs and throughput measurements.
+ *
+ * Chunks are handed out straight from the mapped file with their recorded
+ * boundaries. write() accepts and discards everything, so an endpoint can
+ * use the interface for both directions.
+ */
+class ReplayInterface final : public IInterface {
+ public:
+  explicit ReplayInterface(const ReplayOptions& options = {});
+  ~ReplayInterface() override;
+
+  ReplayInterface(const ReplayInterface&) = delete;
+  auto operator=(const ReplayInterface&) -> ReplayInterface& = delete;
+
+  /**
+   * @brief Map the capture to replay; call before open().
+   * @note From a receive callback this only stops the replay and returns
+   * false: the replay thread still reads the current mapping.
+   */
+  auto load(const std::string& path) -> bool;
+
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+
+  auto is_open() -> bool override;
+
+  /// @brief Start replaying from the first chunk; false from a receive
+  /// callback, whose thread is still the one replaying.
+  auto open() -> bool override;
+  /// @brief Stop replaying. From a receive callback returns at once; the
+  /// thread is joined by the destructor or the next open(), close() or
+  /// load().
+  auto close() -> bool override;
+
+  /// @brief Wait until every pass has been delivered.
+  auto wait_done(std::chrono::milliseconds timeout) -> bool;
+
+  /// @brief Bytes delivered since open().
+  [[nodiscard]] auto delivered() const -> uint64_t {
+    return delivered_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  ReplayOptions options_;
+  CaptureReader reader_;
+  std::atomic_bool is_open_{false};
+  std::atomic_bool done_{false};
+  std::atomic<uint64_t> delivered_{0};
+  std::thread replay_thread_;
+  // set by the running replay thread itself: it may reach a callback before
+  // open() has finished assigning replay_thread_
+  std::atomic<std::thread::id> replay_id_{};
+
+  void replay_loop();
+  [[nodiscard]] auto on_replay_thread() const -> bool;
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+}  // namespace proto::interface
@@ -0,0 +1,330 @@
+#include "Datagram.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace proto::interface {
+namespace {
+auto resolve(const std::string& host, const uint16_t PORT,
+             sockaddr_in& address) -> bool {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  addrinfo* list = nullptr;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &list) != 0) {
+    return false;
+  }
+  std::memcpy(&address, list->ai_addr, sizeof(address));
+  address.sin_port = htons(PORT);
+  freeaddrinfo(list);
+  return true;
+}
+}  // namespace
+
+DatagramInterface::DatagramInterface(const DatagramOptions& options)
+    : IInterface("datagram interface"), options_(options) {
+  options_.m_max_datagram = std::max<size_t>(options_.m_max_datagram, 1);
+  options_.m_frames_per_datagram =
+      std::max<size_t>(options_.m_frames_per_datagram, 1);
+  options_.m_send_batch = std::max<size_t>(options_.m_send_batch, 1);
+  options_.m_receive_batch = std::max<size_t>(options_.m_receive_batch, 1);
+  tx_data_.resize(options_.m_send_batch * options_.m_max_datagram);
+  tx_sizes_.assign(options_.m_send_batch, 0);
+  rx_data_.resize(options_.m_receive_batch * options_.m_max_datagram);
+  rx_sources_.resize(options_.m_receive_batch);
+}
+
+DatagramInterface::~DatagramInterface() { close(); }
+
+auto DatagramInterface::bind(const uint16_t port, const std::string& host)
+    -> bool {
+  close();
+  sockaddr_in address{};
+  if (!resolve(host, port, address)) {
+    return false;
+  }
+  fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) {
+    return false;
+  }
+  if (options_.m_receive_buffer > 0) {
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &options_.m_receive_buffer,
+               sizeof(options_.m_receive_buffer));
+  }
+  socklen_t length = sizeof(address);
+  if (::bind(fd_, reinterpret_cast<const sockaddr*>(&address), length) != 0 ||
+      getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  port_ = ntohs(address.sin_port);
+  m_name = host + ":" + std::to_string(port_);
+  return open();
+}
+
+auto DatagramInterface::connect(const std::string& host, const uint16_t port)
+    -> bool {
+  if (fd_ < 0 && !bind()) {
+    return false;
+  }
+  std::lock_guard lock(tx_mtx_);
+  has_peer_ = resolve(host, port, peer_);
+  has_source_ = false;
+  return has_peer_;
+}
+
+auto DatagramInterface::write(const CustomSpan<uint8_t> BUFFER,
+                              const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  const auto TIMER = m_stats.write_timer();
+  std::lock_guard lock(tx_mtx_);
+  if (fd_ < 0 || tx_dropping_) {
+    return false;
+  }
+  if (tx_sizes_[tx_closed_] + BUFFER.size() > options_.m_max_datagram &&
+      !move_frame_locked(BUFFER.size(), TIMEOUT)) {
+    return false;
+  }
+  const size_t OFFSET =
+      tx_closed_ * options_.m_max_datagram + tx_sizes_[tx_closed_];
+  std::memcpy(tx_data_.data() + OFFSET, BUFFER.data(), BUFFER.size());
+  tx_sizes_[tx_closed_] += BUFFER.size();
+  return true;
+}
+
+auto DatagramInterface::flush() -> bool {
+  std::lock_guard lock(tx_mtx_);
+  if (tx_dropping_) {
+    tx_dropping_ = false;  // кадр не поместился и уже отброшен
+    return false;
+  }
+  tx_boundary_ = tx_sizes_[tx_closed_];
+  if (++tx_frames_ < options_.m_frames_per_datagram) {
+    return true;
+  }
+  return close_datagram_locked(FLUSH_TIMEOUT);
+}
+
+auto DatagramInterface::move_frame_locked(
+    const size_t EXTRA, const std::chrono::milliseconds TIMEOUT) -> bool {
+  const size_t FROM = tx_closed_ * options_.m_max_datagram + tx_boundary_;
+  const size_t PARTIAL = tx_sizes_[tx_closed_] - tx_boundary_;
+  if (tx_boundary_ == 0 || PARTIAL + EXTRA > options_.m_max_datagram) {
+    // кадр больше датаграммы: отбрасываем его до следующего flush()
+    tx_sizes_[tx_closed_] = tx_boundary_;
+    tx_dropping_ = true;
+    return false;
+  }
+  // датаграмма уходит по границе последнего целого кадра, а начало текущего
+  // переезжает в следующую; после отправки слот уже свободен для memmove
+  tx_sizes_[tx_closed_] = tx_boundary_;
+  if (!close_datagram_locked(TIMEOUT)) {
+    tx_dropping_ = true;
+    return false;
+  }
+  std::memmove(tx_data_.data() + tx_closed_ * options_.m_max_datagram,
+               tx_data_.data() + FROM, PARTIAL);
+  tx_sizes_[tx_closed_] = PARTIAL;
+  return true;
+}
+
+auto DatagramInterface::send_pending() -> bool {
+  std::lock_guard lock(tx_mtx_);
+  if (tx_sizes_[tx_closed_] > 0) {
+    ++tx_closed_;
+  }
+  tx_frames_ = 0;
+  tx_boundary_ = 0;
+  return send_locked(FLUSH_TIMEOUT);
+}
+
+auto DatagramInterface::close_datagram_locked(
+    const std::chrono::milliseconds TIMEOUT) -> bool {
+  tx_frames_ = 0;
+  tx_boundary_ = 0;
+  if (tx_sizes_[tx_closed_] == 0) {
+    return true;
+  }
+  if (++tx_closed_ < options_.m_send_batch) {
+    return true;
+  }
+  return send_locked(TIMEOUT);
+}
+
+auto DatagramInterface::send_locked(const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  const size_t COUNT = tx_closed_;
+  tx_closed_ = 0;
+  if (COUNT == 0) {
+    return true;
+  }
+  const bool HAS_TARGET = has_peer_ || has_source_;
+  std::vector<iovec> iov(COUNT);
+  std::vector<mmsghdr> messages(COUNT);
+  for (size_t i = 0; i < COUNT; ++i) {
+    iov[i] = {tx_data_.data() + i * options_.m_max_datagram, tx_sizes_[i]};
+    messages[i] = {};
+    messages[i].msg_hdr.msg_name = &peer_;
+    messages[i].msg_hdr.msg_namelen = sizeof(peer_);
+    messages[i].msg_hdr.msg_iov = &iov[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    tx_sizes_[i] = 0;
+  }
+  if (!HAS_TARGET) {
+    return false;  // некуда отправлять: ни connect(), ни входящих
+  }
+
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  size_t sent = 0;
+  while (sent < COUNT) {
+    int result = 0;
+    if (options_.m_use_mmsg) {
+      result = sendmmsg(fd_, messages.data() + sent,
+                        static_cast<unsigned>(COUNT - sent), 0);
+    } else {
+      result = ::sendmsg(fd_, &messages[sent].msg_hdr, 0) >= 0 ? 1 : -1;
+    }
+    if (result > 0) {
+      // датаграмма уходит целиком, короткой записи не бывает
+      for (size_t i = sent; i < sent + static_cast<size_t>(result); ++i) {
+        m_stats.on_write(iov[i].iov_len, iov[i].iov_len);
+      }
+      sent += static_cast<size_t>(result);
+      continue;
+    }
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    pollfd pfd{fd_, POLLOUT, 0};
+    if (result < 0 && errno != EAGAIN) {
+      return false;
+    }
+    m_stats.on_write_eagain();
+    const auto LEFT = std::chrono::duration_cast<std::chrono::milliseconds>(
+        DEADLINE - std::chrono::steady_clock::now());
+    if (LEFT.count() <= 0 ||
+        poll(&pfd, 1, static_cast<int>(LEFT.count())) <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto DatagramInterface::is_open() -> bool { return is_open_; }
+
+auto DatagramInterface::open() -> bool {
+  if (fd_ < 0) {
+    return false;
+  }
+  if (!is_open_.exchange(true)) {
+    if (receive_thread_.joinable()) {
+      receive_thread_.join();  // поток, закрытый из колбэка
+    }
+    receive_thread_ = std::thread([this] { reader_loop(); });
+  }
+  return true;
+}
+
+auto DatagramInterface::close() -> bool {
+  is_open_ = false;
+  if (reader_id_.load() == std::this_thread::get_id()) {
+    // из колбэка: поток приёма ещё читает сокет и закроет его при выходе
+    close_on_exit_ = true;
+    return true;
+  }
+  if (receive_thread_.joinable()) {
+    receive_thread_.join();
+  }
+  release();
+  return true;
+}
+
+void DatagramInterface::release() {
+  std::lock_guard lock(tx_mtx_);
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  std::fill(tx_sizes_.begin(), tx_sizes_.end(), 0);
+  tx_closed_ = 0;
+  tx_frames_ = 0;
+}
+
+void DatagramInterface::reader_loop() {
+  const size_t SLOT = options_.m_max_datagram;
+  const size_t BATCH = options_.m_use_mmsg ? options_.m_receive_batch : 1;
+  std::vector<iovec> iov(BATCH);
+  std::vector<mmsghdr> messages(BATCH);
+  reader_id_ = std::this_thread::get_id();
+  while (is_open_) {
+    pollfd pfd{fd_, POLLIN, 0};
+    if (poll(&pfd, 1, 200) <= 0) {
+      continue;  // таймаут 200 мс: проверка is_open_
+    }
+    for (size_t i = 0; i < BATCH; ++i) {
+      iov[i] = {rx_data_.data() + i * SLOT, SLOT};
+      messages[i] = {};
+      messages[i].msg_hdr.msg_name = &rx_sources_[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      messages[i].msg_hdr.msg_iov = &iov[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    int count = 0;
+    if (options_.m_use_mmsg) {
+      count = recvmmsg(fd_, messages.data(), static_cast<unsigned>(BATCH),
+                       MSG_DONTWAIT, nullptr);
+    } else {
+      const ssize_t SIZE = ::recvmsg(fd_, &messages[0].msg_hdr, MSG_DONTWAIT);
+      messages[0].msg_len = static_cast<unsigned>(std::max<ssize_t>(SIZE, 0));
+      count = SIZE >= 0 ? 1 : -1;
+    }
+    if (count <= 0) {
+      if (count < 0 && errno == EAGAIN) {
+        m_stats.on_read_eagain();
+      }
+      continue;
+    }
+    {
+      std::lock_guard lock(tx_mtx_);
+      if (!has_peer_) {
+        peer_ = rx_sources_[count - 1];
+        has_source_ = true;
+      }
+    }
+    for (int i = 0; i < count; ++i) {
+      m_stats.on_read(messages[i].msg_len);
+      notify_receive(rx_data_.data() + i * SLOT, messages[i].msg_len);
+    }
+  }
+  reader_id_ = std::thread::id{};
+  if (close_on_exit_.exchange(false)) {
+    release();  // close() из колбэка оставил это потоку приёма
+  }
+}
+
+void DatagramInterface::notify_receive(const uint8_t* data,
+                                       const size_t COUNT) {
+  // каждая датаграмма — отдельный фрагмент, счётчик read у каждой свой
+  size_t read{};
+  m_callbacks.for_each(
+      [&](CallbackType& callback) { callback({data, COUNT}, read); });
+}
+
+auto DatagramInterface::read(uint8_t* buffer, const size_t COUNT) -> int {
+  const ssize_t SIZE = ::recv(fd_, buffer, COUNT, MSG_DONTWAIT);
+  if (SIZE >= 0) {
+    m_stats.on_read(static_cast<size_t>(SIZE));
+  } else if (errno == EAGAIN) {
+    m_stats.on_read_eagain();
+  }
+  return SIZE >= 0 ? static_cast<int>(SIZE) : -1;
+}
+}  // namespace proto::interface
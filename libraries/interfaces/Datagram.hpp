@@ -0,0 +1,129 @@
+#pragma once
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CustomSpan.hpp"
+#include "Interface.hpp"
+
+namespace proto::interface {
+
+struct DatagramOptions {
+  /// Largest datagram sent or received; 1472 fits an Ethernet MTU.
+  size_t m_max_datagram{1472};
+  /// Frames packed into one datagram before it is closed.
+  size_t m_frames_per_datagram{1};
+  /// Closed datagrams queued before one sendmmsg() sends them all.
+  size_t m_send_batch{1};
+  /// Datagrams fetched per recvmmsg().
+  size_t m_receive_batch{32};
+  /// SO_RCVBUF in bytes; 0 keeps the system default.
+  int m_receive_buffer{4 * 1024 * 1024};
+  /// false: one sendto()/recvfrom() per datagram instead of the mmsg calls.
+  bool m_use_mmsg{true};
+};
+
+/**
+ * @brief UDP interface for Ethernet-attached controllers; one datagram holds
+ * one or more whole frames.
+ *
+ * TX: write() appends to the open datagram and flush(), which TxContainer
+ * calls after every frame, marks a frame boundary. After
+ * DatagramOptions::m_frames_per_datagram frames the datagram is closed, and
+ * once DatagramOptions::m_send_batch datagrams are closed they leave in one
+ * sendmmsg(). With the defaults every frame is sent on its own at flush().
+ * With larger values call send_pending() at the end of a burst.
+ *
+ * A frame never straddles two datagrams: when the next field does not fit,
+ * the open datagram is closed at the last frame boundary and the frame
+ * moves on to the next one. Only a frame larger than
+ * DatagramOptions::m_max_datagram fails; its writes and flush() return false
+ * and nothing of it is sent.
+ *
+ * RX: a reader thread fetches up to DatagramOptions::m_receive_batch
+ * datagrams per recvmmsg() and hands each one to the callbacks as its own
+ * chunk. Without connect() replies go to the sender of the last datagram.
+ */
+class DatagramInterface final : public IInterface {
+ public:
+  explicit DatagramInterface(const DatagramOptions& options = {});
+  ~DatagramInterface() override;
+
+  DatagramInterface(const DatagramInterface&) = delete;
+  auto operator=(const DatagramInterface&) -> DatagramInterface& = delete;
+
+  /**
+   * @brief Bind to @p host:@p port and open.
+   * @param port 0 picks a free port, see port().
+   */
+  auto bind(uint16_t port = 0, const std::string& host = "127.0.0.1")
+      -> bool;
+
+  /// @brief Send to @p host:@p port from now on. Binds first if needed.
+  auto connect(const std::string& host, uint16_t port) -> bool;
+
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+
+  /// @brief End of a frame; may close and send datagrams, see class notes.
+  auto flush() -> bool override;
+
+  /// @brief Close the open datagram and send everything queued.
+  auto send_pending() -> bool;
+
+  auto is_open() -> bool override;
+  auto open() -> bool override;
+  auto close() -> bool override;
+
+  [[nodiscard]] auto port() const -> uint16_t { return port_; }
+
+ private:
+  DatagramOptions options_;
+  int fd_{-1};
+  uint16_t port_{0};
+  std::atomic_bool is_open_{false};
+  std::thread receive_thread_;
+  std::atomic_bool close_on_exit_{false};  // close() ran on the reader thread
+  // set by the running reader itself: it may reach a callback before open()
+  // has finished assigning receive_thread_
+  std::atomic<std::thread::id> reader_id_{};
+
+  // Guarded by tx_mtx_
+  std::mutex tx_mtx_;
+  sockaddr_in peer_{};
+  bool has_peer_{false};
+  bool has_source_{false};        // peer_ is the last sender
+  std::vector<uint8_t> tx_data_;  // m_send_batch slots of m_max_datagram
+  std::vector<size_t> tx_sizes_;  // per slot; slot tx_closed_ is open
+  size_t tx_closed_{0};
+  size_t tx_frames_{0};      // frames in the open datagram
+  size_t tx_boundary_{0};    // bytes of whole frames in the open datagram
+  bool tx_dropping_{false};  // frame too large; skip writes until flush()
+
+  std::vector<uint8_t> rx_data_;
+  std::vector<sockaddr_in> rx_sources_;
+
+  /// Timeout of sends no caller waits on: flush() and send_pending().
+  static constexpr std::chrono::milliseconds FLUSH_TIMEOUT{1000};
+
+  auto close_datagram_locked(std::chrono::milliseconds timeout) -> bool;
+  /// Make room for @p extra more bytes of the current frame by closing the
+  /// open datagram at the last frame boundary.
+  auto move_frame_locked(size_t extra, std::chrono::milliseconds timeout)
+      -> bool;
+  /// Send the closed datagrams, waiting up to @p timeout for socket space.
+  auto send_locked(std::chrono::milliseconds timeout) -> bool;
+  void reader_loop();
+  /// Close the socket and drop queued datagrams.
+  void release();
+  void notify_receive(const uint8_t* data, size_t count);
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+}  // namespace proto::interface
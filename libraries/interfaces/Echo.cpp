@@ -13,13 +13,8 @@ auto EchoInterface::write(CustomSpan<uint8_t> buffer,
   }
   std::lock_guard lock(write_mtx_);
   size_t read = 0;
-  for (int i = static_cast<int>(m_callbacks.size() - 1); i >= 0; i--) {
-    if (auto callback = m_callbacks[i].lock(); !callback) {
-      m_callbacks.erase(m_callbacks.begin() + i);
-    } else {
-      (*callback)(buffer.subspan(read), read);
-    }
-  }
+  m_callbacks.for_each(
+      [&](CallbackType& callback) { callback(buffer.subspan(read), read); });
   return true;
 }
 
@@ -0,0 +1,119 @@
+#include "EpollReactor.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+
+namespace proto::interface {
+
+EpollReactor::EpollReactor() {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ < 0 || event_fd_ < 0) {
+    throw std::runtime_error("EpollReactor: epoll/eventfd setup failed");
+  }
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = event_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &event);
+  thread_ = std::thread([this] { loop(); });
+}
+
+EpollReactor::~EpollReactor() {
+  {
+    std::lock_guard lock(mtx_);
+    running_ = false;
+  }
+  wakeup();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  ::close(event_fd_);
+  ::close(epoll_fd_);
+}
+
+auto EpollReactor::add(const int FD, Handler handler) -> bool {
+  std::lock_guard lock(mtx_);
+  epoll_event event{};
+  event.events = EPOLLIN | EPOLLRDHUP;
+  event.data.fd = FD;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, FD, &event) != 0) {
+    return false;
+  }
+  handlers_[FD] = std::make_shared<Handler>(std::move(handler));
+  return true;
+}
+
+void EpollReactor::remove(const int FD) {
+  std::unique_lock lock(mtx_);
+  if (handlers_.erase(FD) != 0) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, FD, nullptr);
+  }
+  // a handler may already have removed itself and still be running
+  if (std::this_thread::get_id() == thread_.get_id()) {
+    return;  // called from a handler: nothing else runs on this thread
+  }
+  idle_cv_.wait(lock, [this, FD] { return current_fd_ != FD; });
+}
+
+void EpollReactor::wakeup() const {
+  const uint64_t ONE = 1;
+  eventfd_calls_.fetch_add(1, std::memory_order_relaxed);
+  // Only fails with EAGAIN when the counter is saturated, i.e. already set.
+  [[maybe_unused]] const auto RESULT = ::write(event_fd_, &ONE, sizeof(ONE));
+}
+
+auto EpollReactor::size() -> size_t {
+  std::lock_guard lock(mtx_);
+  return handlers_.size();
+}
+
+void EpollReactor::loop() {
+  constexpr int MAX_EVENTS = 64;
+  std::array<epoll_event, MAX_EVENTS> events{};
+  while (true) {
+    wait_calls_.fetch_add(1, std::memory_order_relaxed);
+    const int COUNT = epoll_wait(epoll_fd_, events.data(), MAX_EVENTS, -1);
+    if (COUNT < 0 && errno != EINTR) {
+      break;
+    }
+    for (int i = 0; i < COUNT; ++i) {
+      const int FD = events[i].data.fd;
+      if (FD == event_fd_) {
+        uint64_t value{};
+        eventfd_calls_.fetch_add(1, std::memory_order_relaxed);
+        [[maybe_unused]] const auto RESULT =
+            ::read(event_fd_, &value, sizeof(value));
+        continue;
+      }
+      std::shared_ptr<Handler> handler;
+      {
+        std::lock_guard lock(mtx_);
+        // The descriptor may have been removed by an earlier handler of
+        // this batch.
+        if (auto iter = handlers_.find(FD); iter != handlers_.end()) {
+          handler = iter->second;
+          current_fd_ = FD;
+        }
+      }
+      if (handler) {
+        (*handler)();
+        {
+          std::lock_guard lock(mtx_);
+          current_fd_ = -1;
+        }
+        idle_cv_.notify_all();
+      }
+    }
+    std::lock_guard lock(mtx_);
+    if (!running_) {
+      break;
+    }
+  }
+}
+}  // namespace proto::interface
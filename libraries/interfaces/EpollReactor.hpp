@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace proto::interface {
+/**
+ * @brief One epoll loop that serves readiness events of many descriptors.
+ *
+ * Interfaces register their descriptor together with a handler that is
+ * called on the reactor thread whenever the descriptor becomes readable (or
+ * reports an error). An eventfd wakes the loop for shutdown, so the thread
+ * sleeps in epoll_wait() without a timeout while nothing happens.
+ *
+ * Descriptors must be non-blocking: handlers are expected to read until
+ * EAGAIN.
+ *
+ * @warning The reactor must outlive every interface registered with it.
+ */
+class EpollReactor {
+ public:
+  using Handler = std::function<void()>;
+
+  EpollReactor();
+  ~EpollReactor();
+
+  EpollReactor(const EpollReactor&) = delete;
+  auto operator=(const EpollReactor&) -> EpollReactor& = delete;
+
+  /**
+   * @brief Start watching @p FD for input.
+   * @return false if epoll refused the descriptor.
+   */
+  auto add(int FD, Handler handler) -> bool;
+
+  /**
+   * @brief Stop watching @p FD.
+   *
+   * When called from another thread, returns only after a handler running
+   * for @p FD has finished, so the owner may close the descriptor and
+   * destroy the handler state right away. Safe to call from inside a handler.
+   */
+  void remove(int FD);
+
+  /// @brief Interrupt epoll_wait(); the loop re-checks its state.
+  void wakeup() const;
+
+  /// @brief Number of descriptors currently registered.
+  [[nodiscard]] auto size() -> size_t;
+
+  /// @brief epoll_wait() calls so far, for benchmarks.
+  [[nodiscard]] auto wait_calls() const -> uint64_t {
+    return wait_calls_.load(std::memory_order_relaxed);
+  }
+
+  /// @brief eventfd reads and writes so far, for benchmarks.
+  [[nodiscard]] auto eventfd_calls() const -> uint64_t {
+    return eventfd_calls_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  int epoll_fd_{-1};
+  int event_fd_{-1};
+  bool running_{true};
+  int current_fd_{-1};
+  std::atomic<uint64_t> wait_calls_{0};
+  mutable std::atomic<uint64_t> eventfd_calls_{0};  // wakeup() is const
+  std::mutex mtx_;
+  std::condition_variable idle_cv_;
+  std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+  std::thread thread_;
+
+  void loop();
+};
+}  // namespace proto::interface
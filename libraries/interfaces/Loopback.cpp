@@ -0,0 +1,183 @@
+#include "Loopback.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace proto::interface {
+
+ByteRing::ByteRing(const size_t CAPACITY) {
+  size_t size = 1;
+  while (size < CAPACITY) {
+    size <<= 1U;
+  }
+  buffer_.resize(size);
+  mask_ = size - 1;
+}
+
+auto ByteRing::push(const CustomSpan<uint8_t> DATA) -> size_t {
+  const size_t TAIL = tail_.load(std::memory_order_relaxed);
+  const size_t HEAD = head_.load(std::memory_order_acquire);
+  const size_t COUNT = std::min(DATA.size(), buffer_.size() - (TAIL - HEAD));
+  const size_t OFFSET = TAIL & mask_;
+  const size_t FIRST = std::min(COUNT, buffer_.size() - OFFSET);
+  std::memcpy(buffer_.data() + OFFSET, DATA.data(), FIRST);
+  std::memcpy(buffer_.data(), DATA.data() + FIRST, COUNT - FIRST);
+  tail_.store(TAIL + COUNT, std::memory_order_release);
+  return COUNT;
+}
+
+auto ByteRing::pop(uint8_t* out, const size_t COUNT) -> size_t {
+  const size_t HEAD = head_.load(std::memory_order_relaxed);
+  const size_t TAIL = tail_.load(std::memory_order_acquire);
+  const size_t TAKEN = std::min(COUNT, TAIL - HEAD);
+  const size_t OFFSET = HEAD & mask_;
+  const size_t FIRST = std::min(TAKEN, buffer_.size() - OFFSET);
+  std::memcpy(out, buffer_.data() + OFFSET, FIRST);
+  std::memcpy(out + FIRST, buffer_.data(), TAKEN - FIRST);
+  head_.store(HEAD + TAKEN, std::memory_order_release);
+  return TAKEN;
+}
+
+auto ByteRing::size() const -> size_t {
+  return tail_.load(std::memory_order_acquire) -
+         head_.load(std::memory_order_acquire);
+}
+
+LoopbackInterface::LoopbackInterface(const LoopbackOptions& options)
+    : IInterface("loopback interface"),
+      options_(options),
+      ring_(options.m_capacity),
+      receive_buffer_(options.m_max_chunk > 0
+                          ? std::min(options.m_max_chunk, ring_.capacity())
+                          : ring_.capacity()),
+      random_state_(options.m_seed != 0 ? options.m_seed : 1) {}
+
+LoopbackInterface::~LoopbackInterface() { close(); }
+
+void LoopbackInterface::link(LoopbackInterface& first,
+                             LoopbackInterface& second) {
+  first.peer_ = &second;
+  second.peer_ = &first;
+}
+
+auto LoopbackInterface::write(const CustomSpan<uint8_t> BUFFER,
+                              const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  if (!is_open_ || peer_ == nullptr || !peer_->is_open_) {
+    return false;
+  }
+  const auto TIMER = m_stats.write_timer();
+  std::lock_guard lock(write_mtx_);  // кольцо рассчитано на одного писателя
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  size_t done = 0;
+  while (true) {
+    const size_t PUSHED = peer_->ring_.push(BUFFER.subspan(done));
+    if (PUSHED > 0) {
+      m_stats.on_write(BUFFER.size() - done, PUSHED);
+    }
+    done += PUSHED;
+    peer_->wake();
+    if (done == BUFFER.size()) {
+      return true;
+    }
+    // кольцо полно: ждём, пока получатель его разгрузит
+    if (!peer_->wait_for_space(DEADLINE)) {
+      return false;
+    }
+  }
+}
+
+auto LoopbackInterface::wait_for_space(
+    const std::chrono::steady_clock::time_point DEADLINE) -> bool {
+  std::unique_lock lock(space_mtx_);
+  writer_waiting_.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const bool ROOM = space_cv_.wait_until(lock, DEADLINE, [this] {
+    return ring_.size() < ring_.capacity() || !is_open_;
+  });
+  writer_waiting_.store(false, std::memory_order_relaxed);
+  return ROOM && is_open_;
+}
+
+void LoopbackInterface::wake() {
+  // pairs with the fence in receiver_loop(): either the writer sees
+  // sleeping_ or the receiver sees the new bytes
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    std::lock_guard lock(wake_mtx_);
+    wake_cv_.notify_one();
+  }
+}
+
+void LoopbackInterface::wake_writer() {
+  // pairs with the fence in wait_for_space()
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (writer_waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard lock(space_mtx_);
+    space_cv_.notify_one();
+  }
+}
+
+auto LoopbackInterface::is_open() -> bool { return is_open_; }
+
+auto LoopbackInterface::open() -> bool {
+  if (!is_open_.exchange(true)) {
+    receive_thread_ = std::thread([this] { receiver_loop(); });
+  }
+  return true;
+}
+
+auto LoopbackInterface::close() -> bool {
+  if (is_open_.exchange(false)) {
+    {
+      std::lock_guard lock(wake_mtx_);
+      wake_cv_.notify_one();
+    }
+    {
+      std::lock_guard lock(space_mtx_);
+      space_cv_.notify_one();
+    }
+    if (receive_thread_.joinable()) {
+      receive_thread_.join();
+    }
+  }
+  return true;
+}
+
+// xorshift32: cheap and reproducible from the seed
+auto LoopbackInterface::next_chunk() -> size_t {
+  const size_t LIMIT = receive_buffer_.size();
+  if (!options_.m_random_chunks) {
+    return LIMIT;
+  }
+  random_state_ ^= random_state_ << 13U;
+  random_state_ ^= random_state_ >> 17U;
+  random_state_ ^= random_state_ << 5U;
+  return 1 + random_state_ % LIMIT;
+}
+
+void LoopbackInterface::receiver_loop() {
+  while (is_open_) {
+    const int COUNT = read(receive_buffer_.data(), next_chunk());
+    if (COUNT == 0) {
+      std::unique_lock lock(wake_mtx_);
+      sleeping_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      // повторная проверка после объявления сна: писатель мог успеть раньше
+      wake_cv_.wait(lock, [this] { return ring_.size() > 0 || !is_open_; });
+      sleeping_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+    m_stats.on_read(static_cast<size_t>(COUNT));
+    wake_writer();
+    size_t read = 0;
+    m_callbacks.for_each([&](CallbackType& callback) {
+      callback({receive_buffer_.data(), static_cast<size_t>(COUNT)}, read);
+    });
+  }
+}
+
+auto LoopbackInterface::read(uint8_t* buffer, const size_t COUNT) -> int {
+  return static_cast<int>(ring_.pop(buffer, COUNT));
+}
+}  // namespace proto::interface
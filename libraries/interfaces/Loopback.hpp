@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CustomSpan.hpp"
+#include "Interface.hpp"
+
+namespace proto::interface {
+/**
+ * @brief Single-producer/single-consumer byte ring without locks.
+ *
+ * The producer only moves tail_, the consumer only moves head_; both are
+ * free-running counters, so the ring holds exactly CAPACITY bytes.
+ */
+class ByteRing {
+ public:
+  /// @param CAPACITY Rounded up to a power of two.
+  explicit ByteRing(size_t CAPACITY);
+
+  /// @brief Copy as much of @p data as fits. @return bytes copied.
+  auto push(CustomSpan<uint8_t> data) -> size_t;
+
+  /// @brief Copy up to @p count bytes into @p out. @return bytes copied.
+  auto pop(uint8_t* out, size_t count) -> size_t;
+
+  [[nodiscard]] auto size() const -> size_t;
+  [[nodiscard]] auto capacity() const -> size_t { return buffer_.size(); }
+
+ private:
+  std::vector<uint8_t> buffer_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+struct LoopbackOptions {
+  size_t m_capacity{64 * 1024};  //!< Ring size per direction.
+  /// Largest chunk handed to one callback; 0 delivers all queued bytes.
+  size_t m_max_chunk{0};
+  /// Cut deliveries at random sizes in [1, m_max_chunk] instead.
+  bool m_random_chunks{false};
+  uint32_t m_seed{1};
+};
+
+/**
+ * @brief One end of an in-memory link; bytes written here come out of the
+ * peer.
+ *
+ * Unlike EchoInterface, write() only copies into the peer's ring. The peer's
+ * receiver thread runs the callbacks, so sender and receiver work
+ * concurrently the way they do on a real serial line. Created in pairs, see
+ * LoopbackPair.
+ */
+class LoopbackInterface final : public IInterface {
+ public:
+  explicit LoopbackInterface(const LoopbackOptions& options = {});
+  ~LoopbackInterface() override;
+
+  LoopbackInterface(const LoopbackInterface&) = delete;
+  auto operator=(const LoopbackInterface&) -> LoopbackInterface& = delete;
+
+  /// @brief Connect two ends; both must outlive the link.
+  static void link(LoopbackInterface& first, LoopbackInterface& second);
+
+  /**
+   * @brief Queue @p buffer for the peer.
+   *
+   * Waits for ring space up to @p timeout; returns false if the port or the
+   * peer is closed or the bytes did not fit in time.
+   */
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+
+  auto is_open() -> bool override;
+
+  /// @brief Start the receiver thread.
+  auto open() -> bool override;
+
+  /// @brief Stop the receiver thread; queued bytes are kept.
+  auto close() -> bool override;
+
+ private:
+  LoopbackOptions options_;
+  LoopbackInterface* peer_{nullptr};
+  ByteRing ring_;
+  std::atomic_bool is_open_{false};
+  std::mutex write_mtx_;
+
+  // Receiver wakeup: the thread sleeps only after announcing it in
+  // sleeping_, writers notify only when it is set.
+  std::atomic_bool sleeping_{false};
+  std::mutex wake_mtx_;
+  std::condition_variable wake_cv_;
+  // Writer wakeup, the same handshake the other way round: the peer's
+  // writer waits here for space in ring_.
+  std::atomic_bool writer_waiting_{false};
+  std::mutex space_mtx_;
+  std::condition_variable space_cv_;
+  std::thread receive_thread_;
+  std::vector<uint8_t> receive_buffer_;
+  uint32_t random_state_;
+
+  void receiver_loop();
+  void wake();
+  void wake_writer();
+  auto wait_for_space(std::chrono::steady_clock::time_point deadline) -> bool;
+  auto next_chunk() -> size_t;
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+
+/**
+ * @brief Two linked, open loopback interfaces.
+ *
+ * @code{.cpp}
+ * LoopbackPair link;
+ * host.set_interfaces(link.m_a, link.m_a);   // host writes reach m_b
+ * board.set_interfaces(link.m_b, link.m_b);  // board replies reach m_a
+ * @endcode
+ */
+struct LoopbackPair {
+  LoopbackInterface m_a;
+  LoopbackInterface m_b;
+
+  explicit LoopbackPair(const LoopbackOptions& options = {})
+      : m_a(options), m_b(options) {
+    LoopbackInterface::link(m_a, m_b);
+    m_a.open();
+    m_b.open();
+  }
+  // Both receiver threads stop before either end goes away.
+  ~LoopbackPair() {
+    m_a.close();
+    m_b.close();
+  }
+  LoopbackPair(const LoopbackPair&) = delete;
+  auto operator=(const LoopbackPair&) -> LoopbackPair& = delete;
+};
+}  // namespace proto::interface
@@ -0,0 +1,316 @@
+#include "Mux.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "CrcEngine.hpp"
+
+namespace proto::interface {
+
+namespace {
+using HeaderCrc = Crc8Smbus;
+using SegmentCrc = Crc16Ccitt;
+
+constexpr size_t HEADER_SIZE = ChannelMux::HEADER_SIZE;
+constexpr size_t OVERHEAD = HEADER_SIZE + ChannelMux::TRAILER_SIZE;
+
+auto header_crc(const uint8_t* header) -> uint8_t {
+  return static_cast<uint8_t>(
+      HeaderCrc::compute(HeaderCrc::INITIAL, header, HEADER_SIZE - 1));
+}
+
+// Payload length of a valid header, 0 otherwise. A zero length is never
+// sent, so runs of zeros (whose CRC-8 is zero too) do not parse as headers.
+auto header_length(const uint8_t* header, const size_t MAX) -> size_t {
+  const size_t LENGTH = header[1] | (header[2] << 8U);
+  if (LENGTH == 0 || LENGTH > MAX || header[3] != header_crc(header)) {
+    return 0;
+  }
+  return LENGTH;
+}
+
+auto segment_crc(const uint8_t* segment, const size_t LENGTH) -> uint16_t {
+  return static_cast<uint16_t>(
+      SegmentCrc::compute(SegmentCrc::INITIAL, segment, HEADER_SIZE + LENGTH));
+}
+
+auto trailer_valid(const uint8_t* segment, const size_t LENGTH) -> bool {
+  const uint16_t CRC = segment_crc(segment, LENGTH);
+  const uint8_t* trailer = segment + HEADER_SIZE + LENGTH;
+  return trailer[0] == (CRC & 0xFFU) && trailer[1] == (CRC >> 8U);
+}
+}  // namespace
+
+MuxChannel::MuxChannel(ChannelMux& mux, const uint8_t id)
+    : IInterface("mux channel"), mux_(mux), id_(id) {
+  m_name += " " + std::to_string(id);
+}
+
+auto MuxChannel::write(const CustomSpan<uint8_t> BUFFER,
+                       const std::chrono::milliseconds TIMEOUT) -> bool {
+  const auto TIMER = m_stats.write_timer();
+  const size_t LIMIT = mux_.options_.m_queue_limit;
+  std::unique_lock lock(queue_mtx_);
+  // очередь полна: ждём, пока планировщик её разгрузит
+  if (!space_cv_.wait_for(lock, TIMEOUT, [&] {
+        return queue_.size() - sent_ < LIMIT || !is_open_;
+      }) ||
+      !is_open_ || mux_.closed_) {
+    return false;
+  }
+  queue_.insert(queue_.end(), BUFFER.begin(), BUFFER.end());
+  m_stats.on_write(BUFFER.size(), BUFFER.size());
+  // длинный кадр уходит сегментами, не дожидаясь flush()
+  const bool SEND_NOW =
+      queue_.size() - committed_ >= mux_.options_.m_max_segment;
+  if (SEND_NOW) {
+    committed_ = queue_.size();
+  }
+  lock.unlock();
+  return !SEND_NOW || mux_.pump();
+}
+
+auto MuxChannel::flush() -> bool {
+  {
+    std::lock_guard lock(queue_mtx_);
+    if (committed_ == queue_.size()) {
+      return true;
+    }
+    committed_ = queue_.size();
+  }
+  return mux_.pump();
+}
+
+auto MuxChannel::is_open() -> bool { return is_open_ && mux_.is_open(); }
+
+auto MuxChannel::open() -> bool {
+  is_open_ = true;
+  return mux_.is_open() || mux_.open();
+}
+
+auto MuxChannel::close() -> bool {
+  std::lock_guard lock(queue_mtx_);
+  is_open_ = false;
+  space_cv_.notify_all();
+  return true;
+}
+
+auto MuxChannel::take(uint8_t* out, const size_t MAX) -> size_t {
+  std::lock_guard lock(queue_mtx_);
+  const size_t COUNT = std::min(MAX, committed_ - sent_);
+  if (COUNT == 0) {
+    return 0;
+  }
+  std::memcpy(out, queue_.data() + sent_, COUNT);
+  sent_ += COUNT;
+  if (sent_ == queue_.size()) {
+    queue_.clear();
+    sent_ = 0;
+    committed_ = 0;
+  } else if (sent_ >= queue_.size() / 2) {
+    // сдвигаем остаток, только когда отправлена большая часть: O(1) в среднем
+    queue_.erase(queue_.begin(), queue_.begin() + sent_);
+    committed_ -= sent_;
+    sent_ = 0;
+  }
+  space_cv_.notify_all();
+  return COUNT;
+}
+
+void MuxChannel::deliver(const CustomSpan<uint8_t> DATA) {
+  if (!is_open_) {
+    return;
+  }
+  m_stats.on_read(DATA.size());
+  size_t read{};
+  m_callbacks.for_each([&](CallbackType& callback) { callback(DATA, read); });
+}
+
+auto MuxChannel::read(uint8_t* /*buffer*/, size_t /*count*/) -> int {
+  return 0;  // данные приходят от мультиплексора
+}
+
+ChannelMux::ChannelMux(IInterface& inner, const MuxOptions& options)
+    : inner_(inner),
+      options_(options),
+      rx_gate_(std::make_shared<RxGate>()) {
+  options_.m_max_segment = std::clamp<size_t>(options_.m_max_segment, 1,
+                                              UINT16_MAX);
+  options_.m_queue_limit =
+      std::max(options_.m_queue_limit, options_.m_max_segment);
+  segment_.resize(OVERHEAD + options_.m_max_segment);
+  rx_segment_.resize(OVERHEAD + options_.m_max_segment);
+  rx_gate_->m_mux = this;
+  inner_delegate_ = inner_.add_receive_callback(
+      [gate = rx_gate_](CustomSpan<uint8_t> data, size_t& /*read*/) {
+        std::lock_guard lock(gate->m_mtx);
+        if (gate->m_mux != nullptr) {
+          gate->m_mux->on_receive(data);
+        }
+      });
+}
+
+ChannelMux::~ChannelMux() {
+  {
+    // дожидаемся текущей доставки; следующая увидит пустой указатель
+    std::lock_guard lock(rx_gate_->m_mtx);
+    rx_gate_->m_mux = nullptr;
+  }
+  inner_delegate_.reset();
+}
+
+auto ChannelMux::channel(const uint8_t id) -> MuxChannel& {
+  std::lock_guard lock(channels_mtx_);
+  if (!owned_[id]) {
+    owned_[id] = std::make_unique<MuxChannel>(*this, id);
+    order_.push_back(owned_[id].get());
+    channels_[id].store(owned_[id].get(), std::memory_order_release);
+  }
+  return *owned_[id];
+}
+
+auto ChannelMux::open() -> bool {
+  closed_ = false;
+  return inner_.is_open() || inner_.open();
+}
+
+auto ChannelMux::close() -> bool {
+  // разбор сбрасывает сам приёмный поток: close() может прийти из колбэка
+  rx_reset_ = true;
+  closed_ = true;
+  return true;
+}
+
+auto ChannelMux::pump() -> bool {
+  if (closed_) {
+    return false;
+  }
+  requests_.fetch_add(1);
+  bool result = true;
+  while (requests_.load() != 0) {
+    if (pumping_.exchange(true)) {
+      return result;  // отправляющий поток увидит запрос в requests_
+    }
+    while (requests_.exchange(0) != 0) {
+      int sent = 0;
+      while ((sent = send_round()) > 0) {
+      }
+      result = sent == 0 && result;
+      result = inner_.flush() && result;
+    }
+    pumping_.store(false);
+  }
+  return result;
+}
+
+// One segment per channel with committed bytes; the first channel rotates
+// between rounds so none is always served first.
+auto ChannelMux::send_round() -> int {
+  {
+    std::lock_guard lock(channels_mtx_);
+    round_ = order_;
+  }
+  int sent = 0;
+  const size_t SIZE = round_.size();
+  for (size_t i = 0; i < SIZE; ++i) {
+    MuxChannel* channel = round_[(next_ + i) % SIZE];
+    const size_t COUNT =
+        channel->take(segment_.data() + HEADER_SIZE, options_.m_max_segment);
+    if (COUNT == 0) {
+      continue;
+    }
+    segment_[0] = channel->id();
+    segment_[1] = static_cast<uint8_t>(COUNT & 0xFFU);
+    segment_[2] = static_cast<uint8_t>(COUNT >> 8U);
+    segment_[3] = header_crc(segment_.data());
+    const uint16_t CRC = segment_crc(segment_.data(), COUNT);
+    segment_[HEADER_SIZE + COUNT] = static_cast<uint8_t>(CRC & 0xFFU);
+    segment_[HEADER_SIZE + COUNT + 1] = static_cast<uint8_t>(CRC >> 8U);
+    if (!inner_.write({segment_.data(), OVERHEAD + COUNT})) {
+      return -1;
+    }
+    ++sent;
+  }
+  next_ = SIZE != 0 ? (next_ + 1) % SIZE : 0;
+  return sent;
+}
+
+void ChannelMux::on_receive(const CustomSpan<uint8_t> DATA) {
+  if (rx_reset_.exchange(false)) {
+    rx_fill_ = 0;
+    rx_length_ = 0;
+    replay_.clear();
+  }
+  parse(DATA);
+  // отвергнутый сегмент разбирается заново со второго байта, а за ним
+  // остаток куска; новый отказ внутри снова откладывает хвост в replay_
+  while (!replay_.empty() && !closed_) {
+    replaying_.swap(replay_);
+    replay_.clear();
+    parse({replaying_.data(), replaying_.size()});
+  }
+  replay_.clear();
+}
+
+void ChannelMux::parse(CustomSpan<uint8_t> data) {
+  const size_t MAX = options_.m_max_segment;
+  while (!data.empty() && !closed_) {
+    if (rx_fill_ == 0 && data.size() >= HEADER_SIZE) {
+      // сегмент целиком в куске проверяется и отдаётся без копирования
+      const size_t LENGTH = header_length(data.data(), MAX);
+      if (LENGTH != 0 && data.size() < OVERHEAD + LENGTH) {
+        std::memcpy(rx_segment_.data(), data.data(), data.size());
+        rx_fill_ = data.size();
+        rx_length_ = LENGTH;
+        return;
+      }
+      if (LENGTH == 0 || !trailer_valid(data.data(), LENGTH)) {
+        resyncs_.fetch_add(1, std::memory_order_relaxed);
+        data = data.subspan(1);
+        continue;
+      }
+      route(data[0], data.subspan(HEADER_SIZE, LENGTH));
+      data = data.subspan(OVERHEAD + LENGTH);
+      continue;
+    }
+    // сегмент разрезан между кусками: собираем его в rx_segment_
+    const size_t WANT =
+        (rx_length_ == 0 ? HEADER_SIZE : OVERHEAD + rx_length_) - rx_fill_;
+    const size_t TAKE = std::min(WANT, data.size());
+    std::memcpy(rx_segment_.data() + rx_fill_, data.data(), TAKE);
+    rx_fill_ += TAKE;
+    data = data.subspan(TAKE);
+    if (TAKE < WANT) {
+      return;
+    }
+    if (rx_length_ == 0) {
+      rx_length_ = header_length(rx_segment_.data(), MAX);
+      if (rx_length_ != 0) {
+        continue;
+      }
+    } else if (trailer_valid(rx_segment_.data(), rx_length_)) {
+      route(rx_segment_[0], {rx_segment_.data() + HEADER_SIZE, rx_length_});
+      rx_fill_ = 0;
+      rx_length_ = 0;
+      continue;
+    }
+    // не сегмент: байты после первого и остаток куска разбираем заново
+    resyncs_.fetch_add(1, std::memory_order_relaxed);
+    replay_.assign(rx_segment_.begin() + 1, rx_segment_.begin() + rx_fill_);
+    replay_.insert(replay_.end(), data.begin(), data.end());
+    rx_fill_ = 0;
+    rx_length_ = 0;
+    return;
+  }
+}
+
+void ChannelMux::route(const uint8_t id, const CustomSpan<uint8_t> PAYLOAD) {
+  MuxChannel* channel = channels_[id].load(std::memory_order_acquire);
+  if (channel != nullptr) {
+    channel->deliver(PAYLOAD);
+  } else {
+    dropped_.fetch_add(PAYLOAD.size(), std::memory_order_relaxed);
+  }
+}
+}  // namespace proto::interface
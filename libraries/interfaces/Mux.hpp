@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CustomSpan.hpp"
+#include "Interface.hpp"
+
+namespace proto::interface {
+
+struct MuxOptions {
+  /// Largest payload of one segment; a longer frame goes out in several
+  /// segments, interleaved with the other channels. The receiver rejects
+  /// longer segments, so both ends need the same value.
+  size_t m_max_segment{256};
+  /// Bytes a channel may queue before write() waits for the scheduler.
+  size_t m_queue_limit{64 * 1024};
+};
+
+class ChannelMux;
+
+/**
+ * @brief One logical channel of a ChannelMux, usable wherever an IInterface
+ * is: attach an RxContainer, a TxContainer or a whole endpoint to it.
+ *
+ * write() only queues bytes; flush() (called by TxContainer after every
+ * frame) hands them to the mux scheduler. Receive callbacks get a segment's
+ * payload in place when the whole segment arrived in one chunk of the
+ * underlying interface, from the mux's reassembly buffer otherwise.
+ */
+class MuxChannel final : public IInterface {
+ public:
+  MuxChannel(ChannelMux& mux, uint8_t id);
+
+  MuxChannel(const MuxChannel&) = delete;
+  auto operator=(const MuxChannel&) -> MuxChannel& = delete;
+
+  /**
+   * @brief Queue @p buffer on this channel.
+   *
+   * Waits up to @p timeout while the channel already holds
+   * MuxOptions::m_queue_limit bytes; returns false if the channel is closed
+   * or the queue did not drain in time.
+   */
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+
+  /// @brief Frame boundary: schedule the queued bytes for sending.
+  auto flush() -> bool override;
+
+  auto is_open() -> bool override;
+
+  /// @brief Accept traffic on this channel; opens the mux if needed.
+  auto open() -> bool override;
+
+  /// @brief Stop delivering and accepting bytes; the mux stays open.
+  auto close() -> bool override;
+
+  [[nodiscard]] auto id() const -> uint8_t { return id_; }
+
+ private:
+  friend class ChannelMux;
+
+  ChannelMux& mux_;
+  const uint8_t id_;
+  std::atomic_bool is_open_{true};
+
+  // Queue shared with the scheduler: bytes [sent_, committed_) may go out,
+  // [committed_, size) wait for the next flush().
+  std::mutex queue_mtx_;
+  std::condition_variable space_cv_;
+  std::vector<uint8_t> queue_;
+  size_t sent_{0};
+  size_t committed_{0};
+
+  /// @brief Move up to @p max committed bytes into @p out. @return count.
+  auto take(uint8_t* out, size_t max) -> size_t;
+  void deliver(CustomSpan<uint8_t> data);
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+
+/**
+ * @brief Carries up to 256 independent byte streams over one interface.
+ *
+ * Each segment on the wire is a 4-byte header, the payload and a 2-byte
+ * trailer. The header holds the channel id, the payload length (little
+ * endian, 1..MuxOptions::m_max_segment) and a CRC-8 of those three bytes;
+ * the trailer is a CRC-16 of header and payload. A payload reaches the
+ * channel only after its trailer checked out: a lost or flipped byte costs
+ * the segment it hit, never hands one channel's bytes to another, and the
+ * receiver resumes the search one byte after the rejected header. The
+ * protocol running on a channel thus never resyncs on another channel's
+ * frames.
+ *
+ * Sending is round robin by segment: a channel pushing a firmware image
+ * gives way to control frames every MuxOptions::m_max_segment bytes. The
+ * thread whose flush() finds the scheduler idle sends for all channels
+ * until every queue is empty.
+ *
+ * @code{.cpp}
+ * ChannelMux mux(uart);
+ * control.set_interfaces(mux.channel(0), mux.channel(0));
+ * telemetry.set_interfaces(mux.channel(1), mux.channel(1));
+ * mux.open();
+ * @endcode
+ */
+class ChannelMux {
+ public:
+  static constexpr size_t HEADER_SIZE = 4;
+  static constexpr size_t TRAILER_SIZE = 2;
+
+  /// @param inner Interface to share; must outlive the mux.
+  explicit ChannelMux(IInterface& inner, const MuxOptions& options = {});
+  /**
+   * @brief Unsubscribes from the inner interface and leaves it open.
+   *
+   * Waits for a delivery already in progress, so it must not run from a
+   * receive callback of one of the mux's channels.
+   */
+  ~ChannelMux();
+
+  ChannelMux(const ChannelMux&) = delete;
+  auto operator=(const ChannelMux&) -> ChannelMux& = delete;
+
+  /// @brief Channel @p id, created open on first use.
+  auto channel(uint8_t id) -> MuxChannel&;
+
+  /// @brief Resume routing after close(); opens the inner interface if needed.
+  auto open() -> bool;
+
+  /**
+   * @brief Stop routing: received bytes are discarded and channel writes
+   * fail. The inner interface belongs to the caller and stays open.
+   */
+  auto close() -> bool;
+
+  auto is_open() -> bool { return !closed_ && inner_.is_open(); }
+
+  /// @brief Payload bytes addressed to channels that were never created.
+  [[nodiscard]] auto dropped() const -> uint64_t {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Bytes skipped while looking for a valid segment.
+  [[nodiscard]] auto resyncs() const -> uint64_t {
+    return resyncs_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class MuxChannel;
+
+  // Shared with the receive callback, which may still run while the mux is
+  // destroyed: the destructor clears m_mux under m_mtx.
+  struct RxGate {
+    std::mutex m_mtx;
+    ChannelMux* m_mux;
+  };
+
+  IInterface& inner_;
+  MuxOptions options_;
+  std::shared_ptr<RxGate> rx_gate_;
+  Delegate inner_delegate_;
+  std::atomic_bool closed_{false};
+
+  std::mutex channels_mtx_;
+  std::array<std::unique_ptr<MuxChannel>, 256> owned_;
+  std::array<std::atomic<MuxChannel*>, 256> channels_{};  // read by RX
+  std::vector<MuxChannel*> order_;                        // creation order
+
+  // Scheduler: one thread sends at a time, the others leave a request.
+  // A flag rather than a mutex: a receive callback may flush a channel from
+  // inside the sending thread's inner write().
+  std::atomic_bool pumping_{false};
+  std::atomic<uint32_t> requests_{0};
+  std::vector<MuxChannel*> round_;  // owned by the pumping thread
+  std::vector<uint8_t> segment_;    // owned by the pumping thread
+  size_t next_{0};                  // owned by the pumping thread
+
+  // Receive state, touched only by the inner interface's receive path
+  std::vector<uint8_t> rx_segment_;  // segment split across chunks
+  size_t rx_fill_{0};
+  size_t rx_length_{0};              // payload length once the header is valid
+  std::vector<uint8_t> replay_;      // bytes after a rejected segment
+  std::vector<uint8_t> replaying_;
+  std::atomic_bool rx_reset_{false};  // set by close()
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> resyncs_{0};
+
+  auto pump() -> bool;
+  auto send_round() -> int;
+  void on_receive(CustomSpan<uint8_t> data);
+  void parse(CustomSpan<uint8_t> data);
+  void route(uint8_t id, CustomSpan<uint8_t> payload);
+};
+}  // namespace proto::interface
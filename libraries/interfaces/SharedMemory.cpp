@@ -0,0 +1,332 @@
+#include "SharedMemory.hpp"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+
+namespace proto::interface {
+
+// Positions are free-running 64-bit counters; a ring holds exactly its
+// capacity. Sequence words are bumped before every FUTEX_WAKE so a sleeper
+// that raced with the wakeup does not block.
+struct SharedMemoryInterface::Ring {
+  alignas(64) std::atomic<uint64_t> m_head{0};  // consumer
+  alignas(64) std::atomic<uint64_t> m_tail{0};  // producer
+  alignas(64) std::atomic<uint32_t> m_data_seq{0};
+  std::atomic<uint32_t> m_reader_waiting{0};
+  std::atomic<uint32_t> m_space_seq{0};
+  std::atomic<uint32_t> m_writer_waiting{0};
+};
+
+struct SharedMemoryInterface::Header {
+  static constexpr uint32_t MAGIC = 0x50524D53;  // "PRMS"
+  std::atomic<uint32_t> m_magic{0};
+  uint64_t m_capacity{0};
+  // a side that attached and left stays distinguishable from one that has
+  // not attached yet
+  std::atomic<uint32_t> m_open[2]{};
+  Ring m_rings[2];
+};
+
+namespace {
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "Shared-memory atomics must not rely on process-local locks");
+
+// Not FUTEX_PRIVATE: the words live in memory shared between processes.
+void futex_wait(std::atomic<uint32_t>& word, const uint32_t EXPECTED,
+                const int TIMEOUT_MS) {
+  const timespec TIMEOUT{TIMEOUT_MS / 1000, (TIMEOUT_MS % 1000) * 1000000L};
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, EXPECTED,
+          &TIMEOUT, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>& word) {
+  word.fetch_add(1, std::memory_order_release);
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+// m_open states; zero until the side attaches
+constexpr uint32_t PEER_OPEN = 1;
+constexpr uint32_t PEER_LEFT = 2;
+
+auto round_capacity(const size_t CAPACITY) -> size_t {
+  size_t size = 64;
+  while (size < CAPACITY) {
+    size <<= 1U;
+  }
+  return size;
+}
+}  // namespace
+
+SharedMemoryInterface::~SharedMemoryInterface() { close(); }
+
+auto SharedMemoryInterface::map(const int FD, const size_t SIZE) -> bool {
+  void* address =
+      mmap(nullptr, SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0);
+  if (address == MAP_FAILED) {
+    return false;
+  }
+  header_ = static_cast<Header*>(address);
+  mapped_size_ = SIZE;
+  return true;
+}
+
+auto SharedMemoryInterface::create(const size_t CAPACITY) -> int {
+  close();
+  const size_t RING = round_capacity(CAPACITY);
+  const size_t SIZE = sizeof(Header) + 2 * RING;
+  const int FD = memfd_create("protolib-shm", MFD_CLOEXEC);
+  if (FD < 0) {
+    return -1;
+  }
+  if (ftruncate(FD, static_cast<off_t>(SIZE)) != 0 || !map(FD, SIZE)) {
+    ::close(FD);
+    return -1;
+  }
+  header_ = new (header_) Header();
+  header_->m_capacity = RING;
+  header_->m_magic.store(Header::MAGIC, std::memory_order_release);
+  if (!join(0)) {
+    ::close(FD);
+    return -1;
+  }
+  return FD;
+}
+
+auto SharedMemoryInterface::create(const std::string& name,
+                                   const size_t CAPACITY) -> bool {
+  close();
+  const std::string PATH = "/" + name;
+  const int FD = shm_open(PATH.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (FD < 0) {
+    return false;
+  }
+  const size_t RING = round_capacity(CAPACITY);
+  const size_t SIZE = sizeof(Header) + 2 * RING;
+  const bool MAPPED =
+      ftruncate(FD, static_cast<off_t>(SIZE)) == 0 && map(FD, SIZE);
+  ::close(FD);  // отображение живёт и без дескриптора
+  if (!MAPPED) {
+    shm_unlink(PATH.c_str());
+    return false;
+  }
+  name_ = PATH;
+  header_ = new (header_) Header();
+  header_->m_capacity = RING;
+  header_->m_magic.store(Header::MAGIC, std::memory_order_release);
+  return join(0);
+}
+
+auto SharedMemoryInterface::attach(const int FD) -> bool {
+  close();
+  struct stat info {};
+  if (fstat(FD, &info) != 0 ||
+      static_cast<size_t>(info.st_size) < sizeof(Header) ||
+      !map(FD, static_cast<size_t>(info.st_size))) {
+    return false;
+  }
+  if (header_->m_magic.load(std::memory_order_acquire) != Header::MAGIC ||
+      sizeof(Header) + 2 * header_->m_capacity > mapped_size_) {
+    close();
+    return false;
+  }
+  return join(1);
+}
+
+auto SharedMemoryInterface::attach(const std::string& name) -> bool {
+  const int FD = shm_open(("/" + name).c_str(), O_RDWR, 0);
+  if (FD < 0) {
+    return false;
+  }
+  const bool RESULT = attach(FD);
+  ::close(FD);
+  return RESULT;
+}
+
+auto SharedMemoryInterface::join(const int SIDE) -> bool {
+  side_ = SIDE;
+  header_->m_open[SIDE].store(PEER_OPEN, std::memory_order_release);
+  return open();
+}
+
+auto SharedMemoryInterface::tx_ring() const -> Ring& {
+  return header_->m_rings[side_];
+}
+
+auto SharedMemoryInterface::rx_ring() const -> Ring& {
+  return header_->m_rings[1 - side_];
+}
+
+auto SharedMemoryInterface::data(const int RING) const -> uint8_t* {
+  return reinterpret_cast<uint8_t*>(header_ + 1) +
+         static_cast<size_t>(RING) * header_->m_capacity;
+}
+
+auto SharedMemoryInterface::write(const CustomSpan<uint8_t> BUFFER,
+                                  const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  const auto TIMER = m_stats.write_timer();
+  std::lock_guard lock(write_mtx_);
+  if (!is_open_ || header_ == nullptr) {
+    return false;
+  }
+  Ring& ring = tx_ring();
+  uint8_t* const DATA = data(side_);
+  const uint64_t CAPACITY = header_->m_capacity;
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  size_t done = 0;
+  while (true) {
+    const uint64_t TAIL = ring.m_tail.load(std::memory_order_relaxed);
+    const uint64_t HEAD = ring.m_head.load(std::memory_order_acquire);
+    const size_t COUNT = std::min<size_t>(BUFFER.size() - done,
+                                          CAPACITY - (TAIL - HEAD));
+    const size_t OFFSET = TAIL & (CAPACITY - 1);
+    const size_t FIRST = std::min<size_t>(COUNT, CAPACITY - OFFSET);
+    std::memcpy(DATA + OFFSET, BUFFER.data() + done, FIRST);
+    std::memcpy(DATA, BUFFER.data() + done + FIRST, COUNT - FIRST);
+    ring.m_tail.store(TAIL + COUNT, std::memory_order_release);
+    if (COUNT > 0) {
+      m_stats.on_write(BUFFER.size() - done, COUNT);
+    }
+    done += COUNT;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (COUNT > 0 && ring.m_reader_waiting.load(std::memory_order_relaxed)) {
+      futex_wake(ring.m_data_seq);
+    }
+    if (done == BUFFER.size()) {
+      return true;
+    }
+
+    // кольцо полно: спим, пока читатель не освободит место
+    const auto LEFT = std::chrono::ceil<std::chrono::milliseconds>(
+        DEADLINE - std::chrono::steady_clock::now());
+    if (LEFT.count() <= 0 || !is_open_ ||
+        header_->m_open[1 - side_].load() == PEER_LEFT) {
+      return false;
+    }
+    const uint32_t SEEN = ring.m_space_seq.load(std::memory_order_acquire);
+    ring.m_writer_waiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring.m_head.load(std::memory_order_acquire) == HEAD) {
+      futex_wait(ring.m_space_seq, SEEN,
+                 static_cast<int>(std::min<int64_t>(LEFT.count(), 200)));
+    }
+    ring.m_writer_waiting.store(0, std::memory_order_relaxed);
+  }
+}
+
+auto SharedMemoryInterface::is_open() -> bool { return is_open_; }
+
+auto SharedMemoryInterface::open() -> bool {
+  if (header_ == nullptr) {
+    return false;
+  }
+  if (!is_open_.exchange(true)) {
+    if (receive_thread_.joinable()) {
+      receive_thread_.join();  // поток, завершившийся по закрытию собеседника
+    }
+    receive_thread_ = std::thread([this] { reader_loop(); });
+  }
+  return true;
+}
+
+auto SharedMemoryInterface::close() -> bool {
+  is_open_ = false;
+  const bool FROM_CALLBACK =
+      receive_thread_.joinable() &&
+      receive_thread_.get_id() == std::this_thread::get_id();
+  if (unmap_on_exit_) {
+    // уже закрыт из колбэка: отображение снимает поток приёма при выходе
+    if (!FROM_CALLBACK) {
+      receive_thread_.join();
+      unmap_on_exit_ = false;
+    }
+    return true;
+  }
+  if (header_ == nullptr) {
+    return true;
+  }
+  header_->m_open[side_].store(PEER_LEFT, std::memory_order_release);
+  futex_wake(tx_ring().m_data_seq);   // собеседник заметит закрытие
+  futex_wake(rx_ring().m_data_seq);   // наш поток чтения
+  futex_wake(rx_ring().m_space_seq);  // писатель собеседника
+  if (FROM_CALLBACK) {
+    // поток приёма ещё читает кольцо после возврата из колбэка
+    unmap_on_exit_ = true;
+    return true;
+  }
+  if (receive_thread_.joinable()) {
+    receive_thread_.join();
+  }
+  unmap();
+  return true;
+}
+
+void SharedMemoryInterface::unmap() {
+  std::lock_guard lock(write_mtx_);
+  munmap(header_, mapped_size_);
+  header_ = nullptr;
+  mapped_size_ = 0;
+  if (side_ == 0 && !name_.empty()) {
+    shm_unlink(name_.c_str());
+  }
+  name_.clear();
+}
+
+void SharedMemoryInterface::reader_loop() {
+  Ring& ring = rx_ring();
+  const uint8_t* const DATA = data(1 - side_);
+  const uint64_t CAPACITY = header_->m_capacity;
+  while (is_open_) {
+    const uint64_t HEAD = ring.m_head.load(std::memory_order_relaxed);
+    const uint64_t TAIL = ring.m_tail.load(std::memory_order_acquire);
+    if (TAIL == HEAD) {
+      if (header_->m_open[1 - side_].load() == PEER_LEFT) {
+        is_open_ = false;  // собеседник ушёл, как EOF у сокета
+        break;
+      }
+      const uint32_t SEEN = ring.m_data_seq.load(std::memory_order_acquire);
+      ring.m_reader_waiting.store(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (ring.m_tail.load(std::memory_order_acquire) == HEAD && is_open_) {
+        futex_wait(ring.m_data_seq, SEEN, 200);
+      }
+      ring.m_reader_waiting.store(0, std::memory_order_relaxed);
+      continue;
+    }
+
+    // callbacks read straight from the ring; the span ends at the wrap point
+    const size_t OFFSET = HEAD & (CAPACITY - 1);
+    const size_t COUNT = std::min<size_t>(TAIL - HEAD, CAPACITY - OFFSET);
+    m_stats.on_read(COUNT);
+    size_t read = 0;
+    m_callbacks.for_each([&](CallbackType& callback) {
+      callback({DATA + OFFSET, COUNT}, read);
+    });
+    ring.m_head.store(HEAD + COUNT, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring.m_writer_waiting.load(std::memory_order_relaxed) != 0) {
+      futex_wake(ring.m_space_seq);
+    }
+  }
+  if (unmap_on_exit_) {
+    unmap();  // close() из колбэка оставил это потоку приёма
+  }
+}
+
+auto SharedMemoryInterface::read(uint8_t* /*buffer*/, size_t /*count*/)
+    -> int {
+  return 0;  // данные читает поток приёма прямо из кольца
+}
+}  // namespace proto::interface
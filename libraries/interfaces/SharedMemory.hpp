@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "CustomSpan.hpp"
+#include "Interface.hpp"
+
+namespace proto::interface {
+/**
+ * @brief Byte link between two processes over a shared-memory mapping.
+ *
+ * The mapping holds one single-producer/single-consumer ring per direction.
+ * write() copies into the ring, and the reader thread hands the bytes to
+ * the callbacks straight from shared memory, so the data path has no
+ * syscalls and no kernel copies. A side that finds its ring empty (or full,
+ * when writing) sleeps on a futex in the mapping; the other side issues
+ * FUTEX_WAKE only when a sleeper has announced itself.
+ *
+ * One process calls create(), the other attach(). An anonymous memfd is
+ * shared by inheriting the descriptor or passing it over a Unix socket; a
+ * named segment goes through shm_open(). When one side closes, the other
+ * closes as well, as a socket would on EOF.
+ *
+ * @note Each direction has one producer: concurrent write() calls are
+ * serialized inside the process, but only one process may write a ring.
+ */
+class SharedMemoryInterface final : public IInterface {
+ public:
+  SharedMemoryInterface() : IInterface("shared memory interface") {}
+  ~SharedMemoryInterface() override;
+
+  SharedMemoryInterface(const SharedMemoryInterface&) = delete;
+  auto operator=(const SharedMemoryInterface&)
+      -> SharedMemoryInterface& = delete;
+
+  /**
+   * @brief Create an anonymous segment (memfd) and open as the first side.
+   * @param CAPACITY Ring size per direction, rounded up to a power of two.
+   * @return The memfd for the peer's attach(int), or -1.
+   */
+  auto create(size_t CAPACITY) -> int;
+
+  /// @brief Create the named segment "/@p name" and open as the first side.
+  auto create(const std::string& name, size_t CAPACITY) -> bool;
+
+  /// @brief Map a segment made by create(size_t) and open as the second side.
+  auto attach(int fd) -> bool;
+
+  /// @brief Map the named segment and open as the second side.
+  auto attach(const std::string& name) -> bool;
+
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+
+  auto is_open() -> bool override;
+  auto open() -> bool override;
+
+  /// @brief Leave the link and unmap; a named segment is unlinked by its
+  /// creator. Called from a receive callback, it leaves the unmapping to the
+  /// reader thread, which is still walking the ring.
+  auto close() -> bool override;
+
+ private:
+  struct Ring;
+  struct Header;
+
+  Header* header_{nullptr};
+  size_t mapped_size_{0};
+  int side_{0};  // 0 — create(), 1 — attach()
+  std::string name_;
+  std::atomic_bool is_open_{false};
+  std::mutex write_mtx_;
+  std::thread receive_thread_;
+  std::atomic_bool unmap_on_exit_{false};  // close() ran on the reader thread
+
+  auto map(int fd, size_t size) -> bool;
+  void unmap();
+  auto join(int side) -> bool;
+  [[nodiscard]] auto tx_ring() const -> Ring&;
+  [[nodiscard]] auto rx_ring() const -> Ring&;
+  [[nodiscard]] auto data(int ring) const -> uint8_t*;
+  void reader_loop();
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+}  // namespace proto::interface
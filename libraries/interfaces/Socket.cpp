@@ -0,0 +1,416 @@
+#include "Socket.hpp"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+namespace proto::interface {
+namespace {
+auto set_non_blocking(const int FD) -> bool {
+  const int FLAGS = fcntl(FD, F_GETFL);
+  return FLAGS >= 0 && fcntl(FD, F_SETFL, FLAGS | O_NONBLOCK) == 0;
+}
+
+// The sun_path limit (108 bytes on Linux) includes the terminating zero.
+auto make_unix_address(const std::string& path, sockaddr_un& address)
+    -> bool {
+  address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+}  // namespace
+
+StreamSocketInterface::StreamSocketInterface(const SocketOptions& options)
+    : IInterface("stream socket interface"),
+      options_(options),
+      receive_buffer_(options.m_read_size > 0 ? options.m_read_size : 1) {}
+
+StreamSocketInterface::StreamSocketInterface(EpollReactor& reactor,
+                                             const SocketOptions& options)
+    : StreamSocketInterface(options) {
+  reactor_ = &reactor;
+}
+
+StreamSocketInterface::StreamSocketInterface(UringReactor& reactor,
+                                             const SocketOptions& options)
+    : StreamSocketInterface(options) {
+  uring_ = &reactor;
+}
+
+StreamSocketInterface::~StreamSocketInterface() { close(); }
+
+void StreamSocketInterface::configure(const int FD, const bool TCP) const {
+  if (TCP) {
+    const int NO_DELAY = options_.m_no_delay ? 1 : 0;
+    setsockopt(FD, IPPROTO_TCP, TCP_NODELAY, &NO_DELAY, sizeof(NO_DELAY));
+  }
+  if (options_.m_receive_buffer > 0) {
+    setsockopt(FD, SOL_SOCKET, SO_RCVBUF, &options_.m_receive_buffer,
+               sizeof(options_.m_receive_buffer));
+  }
+  if (options_.m_send_buffer > 0) {
+    setsockopt(FD, SOL_SOCKET, SO_SNDBUF, &options_.m_send_buffer,
+               sizeof(options_.m_send_buffer));
+  }
+}
+
+auto StreamSocketInterface::connect_tcp(const std::string& host,
+                                        const uint16_t port) -> bool {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* list = nullptr;
+  const std::string SERVICE = std::to_string(port);
+  if (getaddrinfo(host.c_str(), SERVICE.c_str(), &hints, &list) != 0) {
+    return false;
+  }
+  int descr = -1;
+  for (const addrinfo* iter = list; iter != nullptr; iter = iter->ai_next) {
+    descr = ::socket(iter->ai_family, iter->ai_socktype | SOCK_CLOEXEC,
+                     iter->ai_protocol);
+    if (descr < 0) {
+      continue;
+    }
+    // буферы задаём до connect(), чтобы окно TCP сразу было нужного размера
+    configure(descr, true);
+    if (::connect(descr, iter->ai_addr, iter->ai_addrlen) == 0) {
+      break;
+    }
+    ::close(descr);
+    descr = -1;
+  }
+  freeaddrinfo(list);
+  if (descr < 0) {
+    return false;
+  }
+  m_name = host + ":" + SERVICE;
+  return adopt(descr);
+}
+
+auto StreamSocketInterface::connect_unix(const std::string& path) -> bool {
+  sockaddr_un address{};
+  if (!make_unix_address(path, address)) {
+    return false;
+  }
+  const int DESCR = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (DESCR < 0) {
+    return false;
+  }
+  configure(DESCR, false);
+  if (::connect(DESCR, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) != 0) {
+    ::close(DESCR);
+    return false;
+  }
+  m_name = path;
+  return adopt(DESCR);
+}
+
+auto StreamSocketInterface::adopt(const int FD) -> bool {
+  close();
+  sockaddr_storage address{};
+  socklen_t length = sizeof(address);
+  if (getsockname(FD, reinterpret_cast<sockaddr*>(&address), &length) != 0 ||
+      !set_non_blocking(FD)) {
+    ::close(FD);
+    return false;
+  }
+  configure(FD, address.ss_family == AF_INET || address.ss_family == AF_INET6);
+  fd_ = FD;
+  m_stats.on_open();
+  return open();
+}
+
+auto StreamSocketInterface::write(const CustomSpan<uint8_t> BUFFER,
+                                  const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  const auto TIMER = m_stats.write_timer();
+  std::lock_guard lock(write_mtx_);
+  if (fd_ < 0) {
+    return false;
+  }
+  if (uring_ != nullptr) {
+    const bool QUEUED = uring_->write(fd_, BUFFER, TIMEOUT);
+    m_stats.on_write(BUFFER.size(), QUEUED ? BUFFER.size() : 0);
+    return QUEUED;
+  }
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  size_t done = 0;
+  while (done < BUFFER.size()) {
+    // MSG_NOSIGNAL: закрытый собеседник даёт EPIPE, а не SIGPIPE
+    const ssize_t SENT = ::send(fd_, BUFFER.data() + done,
+                                BUFFER.size() - done, MSG_NOSIGNAL);
+    if (SENT > 0) {
+      m_stats.on_write(BUFFER.size() - done, static_cast<size_t>(SENT));
+      done += static_cast<size_t>(SENT);
+      continue;
+    }
+    if (SENT < 0 && errno == EINTR) {
+      continue;
+    }
+    if (SENT < 0 && errno != EAGAIN) {
+      return false;
+    }
+    m_stats.on_write_eagain();
+    const auto LEFT = std::chrono::duration_cast<std::chrono::milliseconds>(
+        DEADLINE - std::chrono::steady_clock::now());
+    pollfd pfd{fd_, POLLOUT, 0};
+    if (LEFT.count() <= 0 ||
+        poll(&pfd, 1, static_cast<int>(LEFT.count())) <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto StreamSocketInterface::flush() -> bool {
+  if (uring_ == nullptr) {
+    return true;
+  }
+  std::lock_guard lock(write_mtx_);
+  return fd_ >= 0 && uring_->flush();
+}
+
+auto StreamSocketInterface::is_open() -> bool { return is_open_; }
+
+auto StreamSocketInterface::open() -> bool {
+  if (fd_ < 0) {
+    return false;
+  }
+  if (reactor_ != nullptr) {
+    if (!registered_) {
+      registered_ = reactor_->add(fd_, [this] { on_readable(); });
+    }
+    is_open_ = registered_.load();
+    return is_open_;
+  }
+  if (uring_ != nullptr) {
+    if (!registered_) {
+      registered_ = uring_->add(
+          fd_, [this](CustomSpan<uint8_t> data) { on_data(data); });
+    }
+    is_open_ = registered_.load();
+    return is_open_;
+  }
+  is_open_ = true;
+  if (!receive_thread_.joinable()) {
+    receive_thread_ = std::thread([this] { reader_loop(); });
+  }
+  return true;
+}
+
+auto StreamSocketInterface::close() -> bool {
+  if (callback_thread_.load() == std::this_thread::get_id()) {
+    close_from_reader();
+    return true;
+  }
+  std::lock_guard lock(close_mtx_);
+  teardown(false);
+  return true;
+}
+
+// Reader side of close(), on EOF or from a receive callback: an owner already
+// holding close_mtx_ waits for this thread, so blocking here would deadlock.
+void StreamSocketInterface::close_from_reader() {
+  std::unique_lock lock(close_mtx_, std::try_to_lock);
+  if (lock.owns_lock()) {
+    teardown(true);
+  }
+}
+
+// On the reader or reactor thread the descriptor is only shut down: it stays
+// open, so its number is not reused, until the owner's close() has waited
+// for that thread.
+void StreamSocketInterface::teardown(const bool FROM_READER) {
+  is_open_ = false;
+  int descr = fd_.exchange(-1);
+  if (descr >= 0) {
+    if (registered_.exchange(false)) {
+      // ждёт завершения обработчика
+      if (reactor_ != nullptr) {
+        reactor_->remove(descr);
+      } else {
+        uring_->submit();  // поставленные в очередь записи уходят до закрытия
+        uring_->remove(descr);
+      }
+    }
+    // shutdown() будит poll() потока чтения, дескриптор пока остаётся живым
+    ::shutdown(descr, SHUT_RDWR);
+    if (FROM_READER) {
+      closing_fd_ = descr;
+      return;
+    }
+  } else if (FROM_READER) {
+    return;
+  } else if (closing_fd_ >= 0) {
+    descr = std::exchange(closing_fd_, -1);
+    // обработчик, закрывший сокет, может ещё выполняться
+    if (reactor_ != nullptr) {
+      reactor_->remove(descr);
+    } else if (uring_ != nullptr) {
+      uring_->remove(descr);
+    }
+  }
+  if (receive_thread_.joinable()) {
+    receive_thread_.join();
+  }
+  if (descr >= 0) {
+    std::lock_guard lock(write_mtx_);
+    ::close(descr);
+  }
+}
+
+void StreamSocketInterface::reader_loop() {
+  while (is_open_) {
+    const int COUNT = read(receive_buffer_.data(), receive_buffer_.size());
+    if (COUNT > 0) {
+      notify_receive({receive_buffer_.data(), static_cast<size_t>(COUNT)});
+    } else if (COUNT < 0) {
+      // собеседник закрыл соединение: закрываемся сами, поток завершится
+      is_open_ = false;
+    }
+  }
+}
+
+// Reactor mode: drain until a short read or EAGAIN, as UartLinuxInterface
+// does.
+void StreamSocketInterface::on_readable() {
+  while (true) {
+    const ssize_t COUNT =
+        ::recv(fd_, receive_buffer_.data(), receive_buffer_.size(), 0);
+    if (COUNT > 0) {
+      m_stats.on_read(static_cast<size_t>(COUNT));
+      notify_receive({receive_buffer_.data(), static_cast<size_t>(COUNT)});
+      if (static_cast<size_t>(COUNT) < receive_buffer_.size()) {
+        return;
+      }
+      continue;
+    }
+    if (COUNT < 0 && errno == EINTR) {
+      continue;
+    }
+    if (COUNT < 0 && errno == EAGAIN) {
+      m_stats.on_read_eagain();
+      return;
+    }
+    close_from_reader();  // EOF или ошибка
+    return;
+  }
+}
+
+// io_uring mode: the bytes arrive in the reactor's buffer.
+void StreamSocketInterface::on_data(const CustomSpan<uint8_t> DATA) {
+  if (DATA.empty()) {
+    close_from_reader();  // EOF или ошибка
+    return;
+  }
+  m_stats.on_read(DATA.size());
+  notify_receive(DATA);
+}
+
+void StreamSocketInterface::notify_receive(const CustomSpan<uint8_t> DATA) {
+  size_t read{};
+  callback_thread_ = std::this_thread::get_id();
+  m_callbacks.for_each([&](CallbackType& callback) { callback(DATA, read); });
+  callback_thread_ = std::thread::id{};
+}
+
+auto StreamSocketInterface::read(uint8_t* buffer, const size_t COUNT) -> int {
+  pollfd pfd{fd_, POLLIN, 0};
+  const int READY = poll(&pfd, 1, 200);  // таймаут 200 мс: проверка is_open_
+  if (READY <= 0) {
+    return 0;
+  }
+  const ssize_t READ = ::recv(fd_, buffer, COUNT, 0);
+  if (READ > 0) {
+    m_stats.on_read(static_cast<size_t>(READ));
+    return static_cast<int>(READ);
+  }
+  if (READ < 0 && errno == EAGAIN) {
+    m_stats.on_read_eagain();
+  }
+  if (READ < 0 && (errno == EAGAIN || errno == EINTR)) {
+    return 0;
+  }
+  return -1;  // EOF или ошибка
+}
+
+StreamListener::~StreamListener() { close(); }
+
+auto StreamListener::listen_tcp(const uint16_t port) -> bool {
+  close();
+  fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) {
+    return false;
+  }
+  const int ONE = 1;
+  setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &ONE, sizeof(ONE));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  socklen_t length = sizeof(address);
+  if (::bind(fd_, reinterpret_cast<const sockaddr*>(&address), length) != 0 ||
+      ::listen(fd_, SOMAXCONN) != 0 ||
+      getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    close();
+    return false;
+  }
+  port_ = ntohs(address.sin_port);
+  return true;
+}
+
+auto StreamListener::listen_unix(const std::string& path) -> bool {
+  close();
+  sockaddr_un address{};
+  if (!make_unix_address(path, address)) {
+    return false;
+  }
+  fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) {
+    return false;
+  }
+  ::unlink(path.c_str());
+  if (::bind(fd_, reinterpret_cast<const sockaddr*>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(fd_, SOMAXCONN) != 0) {
+    close();
+    return false;
+  }
+  path_ = path;
+  return true;
+}
+
+auto StreamListener::accept(const std::chrono::milliseconds TIMEOUT) -> int {
+  pollfd pfd{fd_, POLLIN, 0};
+  if (fd_ < 0 || poll(&pfd, 1, static_cast<int>(TIMEOUT.count())) <= 0) {
+    return -1;
+  }
+  return ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+}
+
+void StreamListener::close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  if (!path_.empty()) {
+    ::unlink(path_.c_str());
+    path_.clear();
+  }
+  port_ = 0;
+}
+}  // namespace proto::interface
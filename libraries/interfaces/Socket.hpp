@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CustomSpan.hpp"
+#include "EpollReactor.hpp"
+#include "Interface.hpp"
+#include "UringReactor.hpp"
+
+namespace proto::interface {
+
+struct SocketOptions {
+  bool m_no_delay{true};  //!< TCP_NODELAY; ignored for Unix sockets.
+  /// SO_RCVBUF in bytes; 0 keeps the system default.
+  int m_receive_buffer{1024 * 1024};
+  /// SO_SNDBUF in bytes; 0 keeps the system default.
+  int m_send_buffer{0};
+  size_t m_read_size{64 * 1024};  //!< Bytes per read() and per callback.
+};
+
+/**
+ * @brief Stream socket (TCP or Unix domain) as a byte interface, e.g. a
+ * ser2net-style gateway in front of a board or a local simulator.
+ *
+ * The descriptor is non-blocking, except while a UringReactor serves it
+ * (see UringReactor). Received bytes are delivered by a reader
+ * thread or, for sockets constructed with an EpollReactor, by the reactor
+ * thread. With a UringReactor writes are queued and leave at flush(), as
+ * for UartLinuxInterface. When the peer closes the connection the interface
+ * closes (is_open() turns false); reconnecting is up to the owner.
+ */
+class StreamSocketInterface final : public IInterface {
+ public:
+  explicit StreamSocketInterface(const SocketOptions& options = {});
+  /// @param reactor Event loop that serves this socket; must outlive it.
+  explicit StreamSocketInterface(EpollReactor& reactor,
+                                 const SocketOptions& options = {});
+  /// @param reactor io_uring loop that serves this socket; must outlive it.
+  explicit StreamSocketInterface(UringReactor& reactor,
+                                 const SocketOptions& options = {});
+  ~StreamSocketInterface() override;
+
+  StreamSocketInterface(const StreamSocketInterface&) = delete;
+  auto operator=(const StreamSocketInterface&)
+      -> StreamSocketInterface& = delete;
+
+  /// @brief Connect to @p host (name or address) on @p port and open.
+  auto connect_tcp(const std::string& host, uint16_t port) -> bool;
+
+  /// @brief Connect to the Unix socket at @p path and open.
+  auto connect_unix(const std::string& path) -> bool;
+
+  /// @brief Take over a connected descriptor, e.g. from StreamListener.
+  auto adopt(int fd) -> bool;
+
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+
+  /// @brief Submit queued writes in io_uring mode; otherwise a no-op.
+  auto flush() -> bool override;
+
+  auto is_open() -> bool override;
+
+  /// @brief Start delivering received bytes; the connect calls do this.
+  auto open() -> bool override;
+
+  auto close() -> bool override;
+
+ private:
+  SocketOptions options_;
+  // claimed with exchange() by whoever tears the connection down
+  std::atomic_int fd_{-1};
+  std::atomic_bool is_open_{false};
+  std::mutex write_mtx_;
+  // held for the whole teardown so close() returns after a concurrent one
+  std::mutex close_mtx_;
+  // shut down by the reader itself, closed by the owner's close(); guarded
+  // by close_mtx_
+  int closing_fd_{-1};
+  std::vector<uint8_t> receive_buffer_;
+  std::thread receive_thread_;
+  EpollReactor* reactor_{nullptr};
+  UringReactor* uring_{nullptr};
+  std::atomic_bool registered_{false};
+  // thread running the receive callbacks, whose close() must not block
+  std::atomic<std::thread::id> callback_thread_{};
+
+  void configure(int fd, bool tcp) const;
+  void close_from_reader();
+  void teardown(bool from_reader);
+  void reader_loop();
+  void on_readable();
+  void on_data(CustomSpan<uint8_t> data);
+  void notify_receive(CustomSpan<uint8_t> data);
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+
+/**
+ * @brief Listening TCP or Unix socket that hands out connected descriptors
+ * for StreamSocketInterface::adopt().
+ */
+class StreamListener {
+ public:
+  StreamListener() = default;
+  ~StreamListener();
+
+  StreamListener(const StreamListener&) = delete;
+  auto operator=(const StreamListener&) -> StreamListener& = delete;
+
+  /**
+   * @brief Listen on the loopback address.
+   * @param port 0 picks a free port, see port().
+   */
+  auto listen_tcp(uint16_t port = 0) -> bool;
+
+  /// @brief Listen on @p path; an existing socket file there is replaced.
+  auto listen_unix(const std::string& path) -> bool;
+
+  /// @brief Wait up to @p timeout for a connection. @return fd or -1.
+  auto accept(std::chrono::milliseconds timeout) -> int;
+
+  [[nodiscard]] auto port() const -> uint16_t { return port_; }
+
+  void close();
+
+ private:
+  int fd_{-1};
+  uint16_t port_{0};
+  std::string path_;
+};
+}  // namespace proto::interface
@@ -0,0 +1,31 @@
+#include "Termios2.hpp"
+
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+namespace proto::interface::termios2 {
+
+auto set_baudrate(const int FD, const int BAUDRATE) -> bool {
+  if (BAUDRATE <= 0) {
+    return false;
+  }
+  struct termios2 tio {};
+  if (ioctl(FD, TCGETS2, &tio) != 0) {
+    return false;
+  }
+  // BOTHER для вывода и ввода: скорость берётся из c_ospeed/c_ispeed
+  tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+  tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+  tio.c_ospeed = static_cast<speed_t>(BAUDRATE);
+  tio.c_ispeed = static_cast<speed_t>(BAUDRATE);
+  return ioctl(FD, TCSETS2, &tio) == 0;
+}
+
+auto get_baudrate(const int FD) -> int {
+  struct termios2 tio {};
+  if (ioctl(FD, TCGETS2, &tio) != 0) {
+    return -1;
+  }
+  return static_cast<int>(tio.c_ospeed);
+}
+}  // namespace proto::interface::termios2
@@ -0,0 +1,24 @@
+#pragma once
+
+namespace proto::interface {
+/**
+ * @brief Arbitrary baud rates through the Linux termios2 interface.
+ *
+ * glibc's termios only knows the fixed Bxxx constants. termios2 with BOTHER
+ * lets the driver pick the nearest divisor for any rate. The implementation
+ * lives in its own translation unit because <asm/termbits.h> clashes with
+ * <termios.h>.
+ */
+namespace termios2 {
+/**
+ * @brief Switch input and output speed of @p FD to @p BAUDRATE.
+ *
+ * Other line settings are kept, so call it after tcsetattr().
+ * @return false if the driver rejected the request.
+ */
+auto set_baudrate(int FD, int BAUDRATE) -> bool;
+
+/// @brief Current output speed in baud, or -1 on error.
+auto get_baudrate(int FD) -> int;
+}  // namespace termios2
+}  // namespace proto::interface
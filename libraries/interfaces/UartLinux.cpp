@@ -1,7 +1,9 @@
 #include "UartLinux.hpp"
 
 #include <fcntl.h>
+#include <linux/serial.h>
 #include <poll.h>
+#include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -12,16 +14,172 @@
 #include <thread>
 
 #include "SysFSHelper.hpp"
+#include "Termios2.hpp"
 
 namespace proto::interface {
+namespace {
+// Bxxx constant for a baud rate, B0 if there is none.
+auto standard_speed(const int BAUDRATE) -> speed_t {
+  struct Entry {
+    int m_baud;
+    speed_t m_speed;
+  };
+  static constexpr Entry TABLE[] = {
+      {50, B50},           {75, B75},           {110, B110},
+      {134, B134},         {150, B150},         {200, B200},
+      {300, B300},         {600, B600},         {1200, B1200},
+      {1800, B1800},       {2400, B2400},       {4800, B4800},
+      {9600, B9600},       {19200, B19200},     {38400, B38400},
+      {57600, B57600},     {115200, B115200},   {230400, B230400},
+#ifdef B460800
+      {460800, B460800},   {500000, B500000},   {576000, B576000},
+      {921600, B921600},   {1000000, B1000000}, {1152000, B1152000},
+      {1500000, B1500000}, {2000000, B2000000}, {2500000, B2500000},
+      {3000000, B3000000}, {3500000, B3500000}, {4000000, B4000000},
+#endif
+  };
+  for (const auto& entry : TABLE) {
+    if (entry.m_baud == BAUDRATE) {
+      return entry.m_speed;
+    }
+  }
+  return B0;
+}
+
+// ASYNC_LOW_LATENCY asks the driver to push received bytes to the tty layer
+// right away instead of on its own timer. Not every driver (or a pty)
+// implements TIOCSSERIAL, so failure is not an error.
+void enable_low_latency(const int FD) {
+  serial_struct serial{};
+  if (ioctl(FD, TIOCGSERIAL, &serial) != 0) {
+    return;
+  }
+  serial.flags |= ASYNC_LOW_LATENCY;
+  ioctl(FD, TIOCSSERIAL, &serial);
+}
+}  // namespace
 
 auto UartLinuxInterface::write(const CustomSpan<uint8_t> DATA,
                                const std::chrono::milliseconds TIMEOUT)
     -> bool {
+  const auto TIMER = m_stats.write_timer();
+  std::lock_guard lock(write_mtx_);
   if (fd_ < 0) {
     return false;
   }
+  if (uring_ != nullptr) {
+    const bool QUEUED = uring_->write(fd_, DATA, TIMEOUT);
+    m_stats.on_write(DATA.size(), QUEUED ? DATA.size() : 0);
+    return QUEUED;
+  }
+  const size_t CAPACITY = tx_buffer_.size();
+  if (CAPACITY == 0) {
+    return write_drained(DATA, TIMEOUT) != 0;
+  }
+
+  if (tx_size_ + DATA.size() > CAPACITY && !flush_locked(TIMEOUT)) {
+    return false;
+  }
+  if (DATA.size() > CAPACITY) {
+    // больше буфера — пишем напрямую, с той же политикой tcdrain
+    return write_drained(DATA, TIMEOUT) == DATA.size();
+  }
+  if (tx_size_ == 0) {
+    tx_first_ = std::chrono::steady_clock::now();
+    flush_cv_.notify_one();
+  }
+  std::memcpy(tx_buffer_.data() + tx_size_, DATA.data(), DATA.size());
+  tx_size_ += DATA.size();
+  return true;
+}
+
+auto UartLinuxInterface::flush() -> bool {
   std::lock_guard lock(write_mtx_);
+  if (fd_ < 0) {
+    return false;
+  }
+  if (uring_ != nullptr) {
+    return uring_->flush();
+  }
+  const bool RESULT = flush_locked(FLUSH_TIMEOUT);
+  if (drain_policy_ == DrainPolicy::PER_FRAME) {
+    tcdrain(fd_);
+  }
+  return RESULT;
+}
+
+auto UartLinuxInterface::flush_locked(const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  if (tx_size_ == 0) {
+    return true;
+  }
+  if (fd_ < 0) {
+    return false;
+  }
+  const size_t TOTAL = write_drained({tx_buffer_.data(), tx_size_}, TIMEOUT);
+  // недописанный хвост кадра остаётся в буфере до следующей попытки
+  std::memmove(tx_buffer_.data(), tx_buffer_.data() + TOTAL, tx_size_ - TOTAL);
+  tx_size_ -= TOTAL;
+  if (tx_size_ != 0) {
+    tx_first_ = std::chrono::steady_clock::now();  // повтор через DEADLINE
+  }
+  return tx_size_ == 0;
+}
+
+auto UartLinuxInterface::write_drained(const CustomSpan<uint8_t> DATA,
+                                       const std::chrono::milliseconds TIMEOUT)
+    -> size_t {
+  const size_t TOTAL = write_fd(DATA, TIMEOUT);
+  if (TOTAL > 0 && drain_policy_ == DrainPolicy::PER_WRITE) {
+    tcdrain(fd_);
+  }
+  return TOTAL;
+}
+
+void UartLinuxInterface::set_drain_policy(const DrainPolicy POLICY) {
+  std::lock_guard lock(write_mtx_);
+  drain_policy_ = POLICY;
+}
+
+void UartLinuxInterface::set_coalescing(
+    const size_t CAPACITY, const std::chrono::microseconds DEADLINE) {
+  {
+    std::lock_guard lock(write_mtx_);
+    flush_locked(FLUSH_TIMEOUT);
+    tx_size_ = 0;
+    tx_buffer_.assign(CAPACITY, 0);
+    tx_deadline_ = DEADLINE;
+    flusher_running_ = false;
+  }
+  flush_cv_.notify_all();
+  if (flusher_thread_.joinable()) {
+    flusher_thread_.join();
+  }
+  if (CAPACITY > 0 && DEADLINE.count() > 0) {
+    flusher_running_ = true;
+    flusher_thread_ = std::thread([this] { deadline_flusher(); });
+  }
+}
+
+void UartLinuxInterface::deadline_flusher() {
+  std::unique_lock lock(write_mtx_);
+  while (flusher_running_) {
+    if (tx_size_ == 0) {
+      flush_cv_.wait(lock);
+      continue;
+    }
+    const auto DUE = tx_first_ + tx_deadline_;
+    if (std::chrono::steady_clock::now() >= DUE) {
+      flush_locked(FLUSH_TIMEOUT);
+      continue;
+    }
+    flush_cv_.wait_until(lock, DUE);
+  }
+}
+
+auto UartLinuxInterface::write_fd(const CustomSpan<uint8_t> DATA,
+                                  const std::chrono::milliseconds TIMEOUT)
+    -> size_t {
   CustomSpan<uint8_t> ptr = DATA;
   size_t total = 0;
   const auto START = std::chrono::steady_clock::now();
@@ -29,11 +187,24 @@ auto UartLinuxInterface::write(const CustomSpan<uint8_t> DATA,
   while (!ptr.empty()) {
     const ssize_t WRITTEN = ::write(fd_, ptr.data(), ptr.size());
     if (WRITTEN < 0) {
-      if (errno == EINTR || errno == EAGAIN) {
+      if (errno == EINTR) {
         continue;
       }
-      return false;  // write error
+      if (errno == EAGAIN) {
+        m_stats.on_write_eagain();
+        // дескриптор неблокирующий: ждём места в буфере, но не дольше TIMEOUT
+        const auto LEFT = std::chrono::duration_cast<std::chrono::milliseconds>(
+            TIMEOUT - (std::chrono::steady_clock::now() - START));
+        pollfd pfd{fd_, POLLOUT, 0};
+        if (LEFT.count() <= 0 ||
+            poll(&pfd, 1, static_cast<int>(LEFT.count())) <= 0) {
+          break;
+        }
+        continue;
+      }
+      return total;  // write error
     }
+    m_stats.on_write(ptr.size(), static_cast<size_t>(WRITTEN));
     if (WRITTEN == 0) {
       break;
     }
@@ -44,16 +215,12 @@ auto UartLinuxInterface::write(const CustomSpan<uint8_t> DATA,
       break;
     }
   }
-
-  if (total > 0) {
-    tcdrain(fd_);
-  }
-  return static_cast<int>(total) != 0;
+  return total;
 }
 
 auto UartLinuxInterface::uart_reader_thread() -> int {
   while (is_open_) {
-    int count = read(receive_buffer_.data(), sizeof(receive_buffer_));
+    int count = read(receive_buffer_.data(), receive_buffer_.size());
     if (count < 0) {
       if (!is_open_) {
         break;  // выходим, если нас закрывают
@@ -68,23 +235,83 @@ auto UartLinuxInterface::uart_reader_thread() -> int {
     if (count == 0) {
       continue;  // просто нет данных сейчас
     }
+    notify_receive({receive_buffer_.data(), static_cast<size_t>(count)});
+  }
+
+  return 0;
+}
+
+void UartLinuxInterface::notify_receive(const CustomSpan<uint8_t> DATA) {
+  size_t read{};
+  m_callbacks.for_each([&](CallbackType& callback) { callback(DATA, read); });
+}
 
-    size_t read{};
-    for (int i = static_cast<int>(m_callbacks.size()) - 1; i >= 0; --i) {
-      if (auto callback = m_callbacks[i].lock(); !callback) {
-        m_callbacks.erase(m_callbacks.begin() + i);
-      } else {
-        (*callback)({receive_buffer_.data(), static_cast<size_t>(count)}, read);
+// Reactor mode: drain everything the kernel has buffered, then go back to
+// epoll. A read that returns less than the buffer means the queue is empty,
+// which saves the final EAGAIN round trip.
+void UartLinuxInterface::on_readable() {
+  while (true) {
+    const ssize_t COUNT =
+        ::read(fd_, receive_buffer_.data(), receive_buffer_.size());
+    if (COUNT > 0) {
+      m_stats.on_read(static_cast<size_t>(COUNT));
+      notify_receive({receive_buffer_.data(), static_cast<size_t>(COUNT)});
+      if (static_cast<size_t>(COUNT) < receive_buffer_.size()) {
+        return;
       }
+      continue;
+    }
+    if (COUNT < 0 && errno == EINTR) {
+      continue;
     }
+    if (COUNT < 0 && errno == EAGAIN) {
+      m_stats.on_read_eagain();
+      return;
+    }
+    // EOF или ошибка: устройство отключено
+    close_on_eof();
+    return;
   }
+}
 
-  return 0;
+// io_uring mode: the bytes arrive in the reactor's buffer.
+void UartLinuxInterface::on_data(const CustomSpan<uint8_t> DATA) {
+  if (DATA.empty()) {
+    close_on_eof();  // EOF или ошибка: устройство отключено
+    return;
+  }
+  m_stats.on_read(DATA.size());
+  notify_receive(DATA);
+}
+
+void UartLinuxInterface::set_read_profile(const UartReadProfile& profile) {
+  read_profile_ = profile;
 }
 
 auto UartLinuxInterface::is_open() -> bool { return is_open_; }
 
 auto UartLinuxInterface::open() -> bool {
+  if (reactor_ != nullptr) {
+    if (fd_ < 0) {
+      return false;
+    }
+    if (!registered_) {
+      registered_ = reactor_->add(fd_, [this] { on_readable(); });
+    }
+    is_open_ = registered_.load();
+    return is_open_;
+  }
+  if (uring_ != nullptr) {
+    if (fd_ < 0) {
+      return false;
+    }
+    if (!registered_) {
+      registered_ = uring_->add(
+          fd_, [this](CustomSpan<uint8_t> data) { on_data(data); });
+    }
+    is_open_ = registered_.load();
+    return is_open_;
+  }
   is_open_ = true;
   if (not receive_thread_.joinable()) {
     receive_thread_ = std::thread([this] { uart_reader_thread(); });
@@ -93,18 +320,49 @@ auto UartLinuxInterface::open() -> bool {
 }
 
 auto UartLinuxInterface::close() -> bool {
-  if (is_open()) {
-    is_open_ = false;  // 1) просигналили
-    const int DESCR = fd_;
-    fd_ = -1;
-    if (DESCR >= 0) {
-      ::close(DESCR);  // 2) закрыли (poll вернёт HUP/ERR или timeout)
+  std::lock_guard lock(close_mtx_);
+  teardown();
+  return true;
+}
+
+// Handler side of close(): an owner already holding close_mtx_ waits in
+// remove() for this handler, so blocking on the mutex here would deadlock.
+void UartLinuxInterface::close_on_eof() {
+  std::unique_lock lock(close_mtx_, std::try_to_lock);
+  if (lock.owns_lock()) {
+    teardown();
+  }
+}
+
+void UartLinuxInterface::teardown() {
+  if (!is_open_.exchange(false)) {  // 1) просигналили
+    return;
+  }
+  int descr = -1;
+  {
+    std::lock_guard lock(write_mtx_);
+    flush_locked(FLUSH_TIMEOUT);  // недописанный кадр уходит до закрытия
+    tx_size_ = 0;
+    if (uring_ != nullptr) {
+      uring_->submit();
     }
-    if (receive_thread_.joinable()) {
-      receive_thread_.join();  // 3) корректно дождались
+    descr = fd_.exchange(-1);
+  }
+  const int DESCR = descr;
+  if (registered_.exchange(false)) {
+    // ждёт завершения обработчика
+    if (reactor_ != nullptr) {
+      reactor_->remove(DESCR);
+    } else {
+      uring_->remove(DESCR);
     }
   }
-  return true;
+  if (DESCR >= 0) {
+    ::close(DESCR);  // 2) закрыли (poll вернёт HUP/ERR или timeout)
+  }
+  if (receive_thread_.joinable()) {
+    receive_thread_.join();  // 3) корректно дождались
+  }
 }
 
 auto UartLinuxInterface::open_uart(const std::string& vid,
@@ -134,7 +392,9 @@ auto UartLinuxInterface::open_uart(const std::string& device,
     const auto PID = device.substr(POS + 1);  // всё после ':'
     return open_uart(VID, PID, BAUDRATE);
   }
-  const int DESCR = ::open(device.c_str(), O_RDWR | O_NOCTTY | O_SYNC);
+  // O_NONBLOCK is set once here; reads never block and need no fcntl.
+  const int DESCR =
+      ::open(device.c_str(), O_RDWR | O_NOCTTY | O_SYNC | O_NONBLOCK);
   if (DESCR < 0) {
     return -1;
   }
@@ -145,31 +405,15 @@ auto UartLinuxInterface::open_uart(const std::string& device,
     return -1;
   }
 
-  // скорость
-  speed_t speed;
-  switch (BAUDRATE) {
-    case 9600:
-      speed = B9600;
-      break;
-    case 19200:
-      speed = B19200;
-      break;
-    case 38400:
-      speed = B38400;
-      break;
-    case 57600:
-      speed = B57600;
-      break;
-    case 115200:
-      speed = B115200;
-      break;
-    default:
-      std::cerr << "Unsupported baud rate\n";
-      ::close(DESCR);
-      return -1;
+  // скорость: стандартная константа или termios2/BOTHER после tcsetattr
+  if (BAUDRATE <= 0) {
+    std::cerr << "Unsupported baud rate\n";
+    ::close(DESCR);
+    return -1;
   }
-  cfsetospeed(&tty, speed);
-  cfsetispeed(&tty, speed);
+  const speed_t SPEED = standard_speed(BAUDRATE);
+  cfsetospeed(&tty, SPEED != B0 ? SPEED : B38400);
+  cfsetispeed(&tty, SPEED != B0 ? SPEED : B38400);
 
   // 8N1, без управления потоком
   tty.c_cflag = (tty.c_cflag & ~CSIZE) | CS8;  // 8 бит
@@ -191,9 +435,11 @@ auto UartLinuxInterface::open_uart(const std::string& device,
   tty.c_lflag = 0;  // уже было, оставляем
   tty.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG | IEXTEN);
 
-  // тайминги чтения (как у тебя)
-  tty.c_cc[VMIN] = 1;
-  tty.c_cc[VTIME] = 1;
+  // тайминги чтения из профиля; у реактора нет таймера для неполной пачки
+  tty.c_cc[VMIN] = reactor_ != nullptr || uring_ != nullptr
+                       ? 1
+                       : read_profile_.m_vmin;
+  tty.c_cc[VTIME] = read_profile_.m_vtime;
 
   // на всякий случай очистим очереди и применим атрибуты «с флэшом»
   tcflush(DESCR, TCIOFLUSH);
@@ -202,10 +448,27 @@ auto UartLinuxInterface::open_uart(const std::string& device,
     ::close(DESCR);
     return -1;
   }
+  if (SPEED == B0 && !termios2::set_baudrate(DESCR, BAUDRATE)) {
+    std::cerr << "Unsupported baud rate " << BAUDRATE << "\n";
+    ::close(DESCR);
+    return -1;
+  }
+
+  // без флага профиля драйвер сохраняет свой режим (ftdi_sio: low latency)
+  if (read_profile_.m_low_latency) {
+    enable_low_latency(DESCR);
+  }
+  receive_buffer_.resize(std::max<size_t>(read_profile_.m_buffer_size, 1));
+  {
+    std::lock_guard lock(read_mtx_);
+    read_wait_ = read_profile_.m_max_wait;
+    read_vmin_ = read_profile_.m_vmin;
+  }
 
   fd_ = DESCR;
   m_name = device;
   baudrate_ = BAUDRATE;
+  m_stats.on_open();
   open();
   return DESCR;
 }
@@ -214,10 +477,11 @@ auto UartLinuxInterface::read(uint8_t* buffer, const size_t COUNT) -> int {
   std::lock_guard lock(read_mtx_);
 
   pollfd pfd{fd_, POLLIN | POLLERR | POLLHUP, 0};
-  const int PTR = poll(&pfd, 1, 200);  // таймаут 200 мс
-  if (PTR == 0) {
+  const int PTR = poll(&pfd, 1, static_cast<int>(read_wait_.count()));
+  if (PTR == 0 && read_vmin_ <= 1) {
     return 0;  // нет данных сейчас
   }
+  // PTR == 0 при VMIN > 1: пачка не набралась, забираем то, что есть
   if (PTR < 0) {
     if (errno == EINTR) {
       return 0;
@@ -228,20 +492,12 @@ auto UartLinuxInterface::read(uint8_t* buffer, const size_t COUNT) -> int {
     return -1;  // устройство умерло/отключено
   }
 
-  int flags = fcntl(fd_, F_GETFL, 0);
-  if (flags == -1) {
-    perror("fcntl(F_GETFL)");
-    return -1;
-  }
-
-  if (fcntl(fd_, F_SETFL, flags | O_NONBLOCK) == -1) {
-    perror("fcntl(F_SETFL)");
-    return -1;
-  }
-
   ssize_t READ = ::read(fd_, buffer, COUNT);
 
   if (READ < 0) {
+    if (errno == EAGAIN) {
+      m_stats.on_read_eagain();
+    }
     if (errno == EAGAIN || errno == EINTR) {
       return 0;  // временная ошибка — просто нет данных
     }
@@ -253,6 +509,7 @@ auto UartLinuxInterface::read(uint8_t* buffer, const size_t COUNT) -> int {
     return -1;  // EOF — клиент закрыл соединение
   }
 
+  m_stats.on_read(static_cast<size_t>(READ));
   return static_cast<int>(READ);
 }
 }  // namespace proto::interface
\ No newline at end of file
@@ -1,29 +1,139 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "CustomSpan.hpp"
+#include "EpollReactor.hpp"
 #include "Interface.hpp"
+#include "UringReactor.hpp"
 
 namespace proto::interface {
+/**
+ * @brief When UartLinuxInterface waits for written bytes to leave the UART.
+ */
+enum class DrainPolicy : uint8_t {
+  NEVER,      //!< Return as soon as the kernel accepted the bytes.
+  PER_FRAME,  //!< tcdrain() in flush(), i.e. once per frame.
+  PER_WRITE   //!< tcdrain() after every write to the descriptor (default).
+};
+
+/**
+ * @brief How UartLinuxInterface reads: buffer size, termios timing and
+ * driver latency mode.
+ *
+ * The descriptor is non-blocking, so VMIN/VTIME do not make read() wait
+ * (with a UringReactor the kernel reads and the port uses no read()).
+ * They still shape wakeups: with VTIME = 0 the tty reports the port readable
+ * only once VMIN bytes are queued, and the reader thread collects a partial
+ * batch after @ref m_max_wait. Reactor mode has no timer and always uses
+ * VMIN = 1.
+ *
+ * Start from a named profile and override single fields as needed:
+ * @code{.cpp}
+ * auto profile = UartReadProfile::throughput();
+ * profile.m_vmin = 32;
+ * uart.set_read_profile(profile);
+ * @endcode
+ */
+struct UartReadProfile {
+  size_t m_buffer_size{1000};  //!< Bytes per read() and per callback.
+  uint8_t m_vmin{1};
+  uint8_t m_vtime{1};  //!< Tenths of a second.
+  /// Longest wait for readiness before the reader thread reads what is there.
+  std::chrono::milliseconds m_max_wait{200};
+  /// Request ASYNC_LOW_LATENCY from the driver (ignored if unsupported);
+  /// false leaves the driver's own setting alone.
+  bool m_low_latency{false};
+
+  /// @brief Small reads, every byte wakes the reader, driver low-latency mode.
+  static auto low_latency() -> UartReadProfile {
+    return {64, 1, 0, std::chrono::milliseconds{200}, true};
+  }
+  /**
+   * @brief Large reads, the reader wakes per 64 bytes or every 5 ms.
+   * @note n_tty hands data to read() in 64-byte steps and a VMIN above 64
+   * makes every read() stop at 64 bytes, so 64 is the useful maximum.
+   */
+  static auto throughput() -> UartReadProfile {
+    return {4096, 64, 0, std::chrono::milliseconds{5}, false};
+  }
+};
+
+/**
+ * @brief Linux serial port (termios).
+ *
+ * By default the port owns a reader thread. Ports constructed with an
+ * EpollReactor are served by the reactor thread instead, which lets one
+ * thread handle any number of ports. The descriptor is non-blocking in both
+ * modes.
+ *
+ * With a UringReactor the kernel reads into the reactor's buffers and
+ * write() only queues the bytes: they leave at flush(), which TxContainer
+ * calls after every frame. DrainPolicy and coalescing do not apply there.
+ * The reactor keeps the descriptor blocking while it serves the port.
+ *
+ * @note In reactor mode a port that reports an error or hang-up is closed
+ * (is_open() turns false) and has to be reopened by the owner; the threaded
+ * mode keeps trying to reconnect on its own.
+ */
 class UartLinuxInterface final : public IInterface {
  public:
   explicit UartLinuxInterface() : IInterface("uart linux interface") {}
+  /// @param reactor Event loop that serves this port; must outlive it.
+  explicit UartLinuxInterface(EpollReactor& reactor)
+      : IInterface("uart linux interface"), reactor_(&reactor) {}
+  /// @param reactor io_uring loop that serves this port; must outlive it.
+  explicit UartLinuxInterface(UringReactor& reactor)
+      : IInterface("uart linux interface"), uring_(&reactor) {}
   ~UartLinuxInterface() override {
-    is_open_ = false;
-    if (receive_thread_.joinable()) {
-      receive_thread_.join();
-    }
+    close();
+    set_coalescing(0);
   }
   auto write(CustomSpan<uint8_t> /*buffer*/,
              std::chrono::milliseconds /*timeout*/) -> bool override;
 
+  /// @brief Write out the coalescing buffer and apply DrainPolicy::PER_FRAME.
+  auto flush() -> bool override;
+
+  void set_drain_policy(DrainPolicy policy);
+
+  /**
+   * @brief Collect small writes and hand them to the kernel in one call.
+   *
+   * Bytes are written when flush() marks the end of a frame, when the buffer
+   * is full, or when the oldest buffered byte is @p DEADLINE old (for callers
+   * that never call flush()). Bytes the port does not accept in time stay
+   * buffered for the next attempt and make write()/flush() return false;
+   * write() uses its own timeout when it has to make room.
+   *
+   * @param CAPACITY Buffer size in bytes; 0 turns coalescing off.
+   * @param DEADLINE Longest time a byte may wait for flush(); zero waits
+   * forever. A non-zero deadline starts a small flusher thread.
+   */
+  void set_coalescing(size_t CAPACITY, std::chrono::microseconds DEADLINE =
+                                           std::chrono::microseconds{0});
+
+  /**
+   * @brief Choose buffer size and read timing.
+   * @note Takes effect at the next open_uart().
+   */
+  void set_read_profile(const UartReadProfile& profile);
+
   auto is_open() -> bool override;
 
   auto open() -> bool override;
 
+  /**
+   * @brief Open and configure a tty as raw 8N1.
+   * @param device   Device path or "VID:PID".
+   * @param baudrate Any standard rate up to 4000000 baud, or an arbitrary rate
+   * that the driver accepts through termios2/BOTHER.
+   * @return Descriptor, or -1 on failure.
+   */
   auto open_uart(const std::string& device, int baudrate) -> int;
 
   auto open_uart(const std::string& vid, const std::string& pid, int BAUDRATE)
@@ -32,18 +142,58 @@ class UartLinuxInterface final : public IInterface {
   auto close() -> bool override;
 
  private:
-  int fd_{-1};
+  std::atomic_int fd_{-1};
   int baudrate_{};
   std::string vid_pid_;
   std::mutex write_mtx_;
   std::mutex read_mtx_;
   std::atomic_bool is_open_{false};
+  // held for the whole teardown so close() returns after a concurrent one
+  std::mutex close_mtx_;
 
-  std::array<uint8_t, 1000> receive_buffer_{};
+  UartReadProfile read_profile_;
+  // The reader's copy of the profile timing, set by open_uart().
+  // Guarded by read_mtx_
+  std::chrono::milliseconds read_wait_{read_profile_.m_max_wait};
+  uint8_t read_vmin_{read_profile_.m_vmin};
+  std::vector<uint8_t> receive_buffer_ =
+      std::vector<uint8_t>(read_profile_.m_buffer_size);
 
   std::thread receive_thread_;
+  EpollReactor* reactor_{nullptr};
+  UringReactor* uring_{nullptr};
+  std::atomic_bool registered_{false};
+
+  // Guarded by write_mtx_
+  DrainPolicy drain_policy_{DrainPolicy::PER_WRITE};
+  std::vector<uint8_t> tx_buffer_;
+  size_t tx_size_{0};
+  std::chrono::steady_clock::time_point tx_first_;
+  std::chrono::microseconds tx_deadline_{0};
+  bool flusher_running_{false};
+  std::condition_variable flush_cv_;
+  std::thread flusher_thread_;
+
+  /// Timeout of flushes no caller waits on: flush(), the deadline flusher
+  /// and close().
+  static constexpr std::chrono::milliseconds FLUSH_TIMEOUT{1000};
+
+  void close_on_eof();
+  void teardown();
+  auto write_fd(CustomSpan<uint8_t> data, std::chrono::milliseconds timeout)
+      -> size_t;
+  /// write_fd() followed by tcdrain() under DrainPolicy::PER_WRITE.
+  auto write_drained(CustomSpan<uint8_t> data,
+                     std::chrono::milliseconds timeout) -> size_t;
+  /// Write out the coalescing buffer; what the descriptor did not take stays
+  /// buffered and the call returns false.
+  auto flush_locked(std::chrono::milliseconds timeout) -> bool;
+  void deadline_flusher();
 
   auto uart_reader_thread() -> int;
+  void on_readable();
+  void on_data(CustomSpan<uint8_t> data);
+  void notify_receive(CustomSpan<uint8_t> data);
   auto read(uint8_t* /*buffer*/, size_t /*count*/) -> int override;
 };
 }  // namespace proto::interface
\ No newline at end of file
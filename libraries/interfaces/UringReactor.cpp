@@ -0,0 +1,751 @@
+#include "UringReactor.hpp"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+
+namespace proto::interface {
+
+namespace {
+// Newer than many uapi headers; the kernel is probed before it is used.
+constexpr uint8_t OP_READ_MULTISHOT = 49;
+constexpr unsigned UNREGISTER_PBUF_RING = 23;
+constexpr uint16_t BUFFER_GROUP = 0;
+
+// user_data: the top two bits tell what completed, the rest says which.
+constexpr uint64_t TAG_SHIFT = 62;
+constexpr uint64_t TAG_READ = 1ULL << TAG_SHIFT;
+constexpr uint64_t TAG_WRITE = 2ULL << TAG_SHIFT;
+constexpr uint64_t TAG_WAKEUP = 3ULL << TAG_SHIFT;
+constexpr uint64_t TAG_OTHER = 0;  // | id: writability poll ahead of writes
+constexpr uint64_t VALUE_MASK = (1ULL << TAG_SHIFT) - 1;
+
+auto uring_setup(const unsigned ENTRIES, io_uring_params& params) -> int {
+  return static_cast<int>(syscall(SYS_io_uring_setup, ENTRIES, &params));
+}
+
+auto uring_register(const int FD, const unsigned OPCODE, void* arg,
+                    const unsigned COUNT) -> int {
+  return static_cast<int>(
+      syscall(SYS_io_uring_register, FD, OPCODE, arg, COUNT));
+}
+
+auto op_supported(const int FD, const uint8_t OP) -> bool {
+  constexpr unsigned OPS = 256;
+  std::vector<uint8_t> memory(sizeof(io_uring_probe) +
+                              OPS * sizeof(io_uring_probe_op));
+  auto* probe = reinterpret_cast<io_uring_probe*>(memory.data());
+  if (uring_register(FD, IORING_REGISTER_PROBE, probe, OPS) != 0 ||
+      OP > probe->last_op || OP >= probe->ops_len) {
+    return false;
+  }
+  return (probe->ops[OP].flags & IO_URING_OP_SUPPORTED) != 0;
+}
+
+auto map_anonymous(const size_t SIZE) -> void* {
+  void* address = mmap(nullptr, SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return address == MAP_FAILED ? nullptr : address;
+}
+
+auto round_pow2(const size_t VALUE, const size_t LIMIT) -> size_t {
+  size_t size = 1;
+  while (size < VALUE && size < LIMIT) {
+    size <<= 1U;
+  }
+  return size;
+}
+}  // namespace
+
+// Submission and completion rings mapped from the io_uring descriptor.
+struct UringReactor::Queues {
+  int m_fd{-1};
+  void* m_sq_map{nullptr};
+  size_t m_sq_size{0};
+  void* m_cq_map{nullptr};
+  size_t m_cq_size{0};
+  io_uring_sqe* m_sqes{nullptr};
+  size_t m_sqes_size{0};
+
+  unsigned* m_sq_head{nullptr};
+  unsigned* m_sq_tail{nullptr};
+  unsigned* m_sq_array{nullptr};
+  unsigned m_sq_mask{0};
+  unsigned m_sq_entries{0};
+  unsigned m_local_tail{0};  // SQEs prepared, published on submit
+
+  unsigned* m_cq_head{nullptr};
+  unsigned* m_cq_tail{nullptr};
+  unsigned m_cq_mask{0};
+  io_uring_cqe* m_cqes{nullptr};
+
+  Queues() = default;
+  Queues(const Queues&) = delete;
+  auto operator=(const Queues&) -> Queues& = delete;
+
+  ~Queues() {
+    if (m_sqes != nullptr) {
+      munmap(m_sqes, m_sqes_size);
+    }
+    if (m_cq_map != nullptr && m_cq_map != m_sq_map) {
+      munmap(m_cq_map, m_cq_size);
+    }
+    if (m_sq_map != nullptr) {
+      munmap(m_sq_map, m_sq_size);
+    }
+    if (m_fd >= 0) {
+      ::close(m_fd);
+    }
+  }
+
+  auto open(const unsigned ENTRIES) -> bool {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CLAMP;
+    m_fd = uring_setup(ENTRIES, params);
+    if (m_fd < 0) {
+      return false;
+    }
+    m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool SINGLE = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (SINGLE) {
+      m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+    }
+    void* sq_map = mmap(nullptr, m_sq_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if (sq_map == MAP_FAILED) {
+      return false;
+    }
+    m_sq_map = sq_map;
+    void* cq_map = sq_map;
+    if (!SINGLE) {
+      cq_map = mmap(nullptr, m_cq_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+      if (cq_map == MAP_FAILED) {
+        return false;
+      }
+    }
+    m_cq_map = cq_map;
+    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      return false;
+    }
+    m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq_base = static_cast<uint8_t*>(sq_map);
+    m_sq_head = reinterpret_cast<unsigned*>(sq_base + params.sq_off.head);
+    m_sq_tail = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+    m_sq_array = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+    m_sq_mask = *reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+    m_sq_entries = params.sq_entries;
+    m_local_tail = *m_sq_tail;
+
+    auto* cq_base = static_cast<uint8_t*>(cq_map);
+    m_cq_head = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+    m_cq_mask = *reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq_base + params.cq_off.cqes);
+    return true;
+  }
+};
+
+struct UringReactor::Entry {
+  uint64_t m_id{0};
+  int m_fd{-1};
+  bool m_socket{false};
+  bool m_single_shot{false};  // multishot refused for this descriptor
+  bool m_wait_writable{false};  // the last write made no progress
+  int m_flags{0};               // file status flags before add()
+  Handler m_handler;
+  unsigned m_inflight{0};       // leading slots of m_queue in the kernel
+  std::deque<uint16_t> m_queue;  // write slots in order
+};
+
+auto UringReactor::is_supported() -> bool {
+  static const bool SUPPORTED = [] {
+    Queues queues;
+    if (!queues.open(4)) {
+      return false;
+    }
+    for (const uint8_t OP : {IORING_OP_NOP, IORING_OP_READ, IORING_OP_WRITE,
+                             IORING_OP_SEND, IORING_OP_POLL_ADD,
+                             IORING_OP_ASYNC_CANCEL}) {
+      if (!op_supported(queues.m_fd, OP)) {
+        return false;
+      }
+    }
+    // provided buffer rings appeared in 5.19
+    const size_t PAGE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* ring = map_anonymous(PAGE);
+    if (ring == nullptr) {
+      return false;
+    }
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = 1;
+    reg.bgid = BUFFER_GROUP;
+    const bool RINGS =
+        uring_register(queues.m_fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+    if (RINGS) {
+      uring_register(queues.m_fd, UNREGISTER_PBUF_RING, &reg, 1);
+    }
+    munmap(ring, PAGE);
+    return RINGS;
+  }();
+  return SUPPORTED;
+}
+
+UringReactor::UringReactor(const UringOptions& options)
+    : options_(options), queues_(std::make_unique<Queues>()) {
+  options_.m_read_buffers = static_cast<uint16_t>(
+      round_pow2(std::max<uint16_t>(options_.m_read_buffers, 1), 1U << 15U));
+  options_.m_read_buffer_size = std::max<uint32_t>(options_.m_read_buffer_size, 1);
+  options_.m_write_slots = std::max<uint16_t>(options_.m_write_slots, 1);
+  options_.m_write_slot_size = std::max<uint32_t>(options_.m_write_slot_size, 1);
+  if (!is_supported() || !queues_->open(std::max(options_.m_entries, 8U))) {
+    throw std::runtime_error("UringReactor: io_uring is not available");
+  }
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd_ < 0) {
+    throw std::runtime_error("UringReactor: eventfd setup failed");
+  }
+  multishot_ = op_supported(queues_->m_fd, OP_READ_MULTISHOT);
+  setup_buffers();
+  thread_ = std::thread([this] { loop(); });
+}
+
+UringReactor::~UringReactor() {
+  {
+    std::lock_guard lock(mtx_);
+    running_ = false;
+  }
+  wakeup();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  queues_.reset();  // closing the ring cancels whatever is still armed
+  release_buffers();
+  ::close(event_fd_);
+}
+
+void UringReactor::setup_buffers() {
+  const size_t READ_SIZE = static_cast<size_t>(options_.m_read_buffers) *
+                           options_.m_read_buffer_size;
+  const size_t WRITE_SIZE = static_cast<size_t>(options_.m_write_slots) *
+                            options_.m_write_slot_size;
+  buffer_ring_size_ = options_.m_read_buffers * sizeof(io_uring_buf);
+  read_memory_ = static_cast<uint8_t*>(map_anonymous(READ_SIZE));
+  write_memory_ = static_cast<uint8_t*>(map_anonymous(WRITE_SIZE));
+  buffer_ring_ = map_anonymous(buffer_ring_size_);
+
+  io_uring_buf_reg reg{};
+  reg.ring_addr = reinterpret_cast<uint64_t>(buffer_ring_);
+  reg.ring_entries = options_.m_read_buffers;
+  reg.bgid = BUFFER_GROUP;
+  if (read_memory_ == nullptr || write_memory_ == nullptr ||
+      buffer_ring_ == nullptr ||
+      uring_register(queues_->m_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+    release_buffers();
+    ::close(event_fd_);
+    throw std::runtime_error("UringReactor: buffer setup failed");
+  }
+  for (uint16_t i = 0; i < options_.m_read_buffers; ++i) {
+    recycle(i);
+  }
+
+  // Registered buffers count against RLIMIT_MEMLOCK; without them writes
+  // use the same slots as plain buffers.
+  iovec vector{write_memory_, WRITE_SIZE};
+  fixed_writes_ =
+      uring_register(queues_->m_fd, IORING_REGISTER_BUFFERS, &vector, 1) == 0;
+  slots_.resize(options_.m_write_slots);
+  for (uint16_t i = options_.m_write_slots; i > 0; --i) {
+    free_slots_.push_back(static_cast<uint16_t>(i - 1));
+  }
+}
+
+void UringReactor::release_buffers() {
+  if (read_memory_ != nullptr) {
+    munmap(read_memory_, static_cast<size_t>(options_.m_read_buffers) *
+                             options_.m_read_buffer_size);
+  }
+  if (write_memory_ != nullptr) {
+    munmap(write_memory_, static_cast<size_t>(options_.m_write_slots) *
+                              options_.m_write_slot_size);
+  }
+  if (buffer_ring_ != nullptr) {
+    munmap(buffer_ring_, buffer_ring_size_);
+  }
+  read_memory_ = nullptr;
+  write_memory_ = nullptr;
+  buffer_ring_ = nullptr;
+}
+
+// io_uring_buf_ring is not used: in C++ the empty struct in its flexible
+// array has size 1 and moves bufs off the kernel layout. The ring is an array
+// of io_uring_buf whose first resv field is the tail.
+void UringReactor::recycle(const uint16_t BUFFER) {
+  auto* bufs = static_cast<io_uring_buf*>(buffer_ring_);
+  io_uring_buf& slot = bufs[buffer_tail_ & (options_.m_read_buffers - 1U)];
+  slot.addr = reinterpret_cast<uint64_t>(
+      read_memory_ + static_cast<size_t>(BUFFER) * options_.m_read_buffer_size);
+  slot.len = options_.m_read_buffer_size;
+  slot.bid = BUFFER;
+  ++buffer_tail_;
+  __atomic_store_n(&bufs[0].resv, buffer_tail_, __ATOMIC_RELEASE);
+}
+
+auto UringReactor::pending_sqes_locked() const -> unsigned {
+  return queues_->m_local_tail -
+         __atomic_load_n(queues_->m_sq_head, __ATOMIC_ACQUIRE);
+}
+
+auto UringReactor::next_sqe_locked() -> void* {
+  Queues& queues = *queues_;
+  if (pending_sqes_locked() >= queues.m_sq_entries) {
+    flush_sq_locked();
+    if (pending_sqes_locked() >= queues.m_sq_entries) {
+      return nullptr;
+    }
+  }
+  const unsigned INDEX = queues.m_local_tail & queues.m_sq_mask;
+  queues.m_sq_array[INDEX] = INDEX;
+  io_uring_sqe* sqe = &queues.m_sqes[INDEX];
+  std::memset(sqe, 0, sizeof(*sqe));
+  ++queues.m_local_tail;
+  return sqe;
+}
+
+auto UringReactor::enter(const unsigned SUBMIT, const unsigned WAIT) -> int {
+  enter_calls_.fetch_add(1, std::memory_order_relaxed);
+  return static_cast<int>(syscall(SYS_io_uring_enter, queues_->m_fd, SUBMIT,
+                                  WAIT, WAIT > 0 ? IORING_ENTER_GETEVENTS : 0U,
+                                  nullptr, 0));
+}
+
+auto UringReactor::flush_sq_locked() -> bool {
+  __atomic_store_n(queues_->m_sq_tail, queues_->m_local_tail,
+                   __ATOMIC_RELEASE);
+  const unsigned PENDING = pending_sqes_locked();
+  return PENDING == 0 || enter(PENDING, 0) >= 0;
+}
+
+void UringReactor::arm_read_locked(const Entry& entry) {
+  auto* sqe = static_cast<io_uring_sqe*>(next_sqe_locked());
+  if (sqe == nullptr) {
+    return;
+  }
+  const bool MULTISHOT = multishot_ && !entry.m_single_shot;
+  sqe->opcode = MULTISHOT ? OP_READ_MULTISHOT
+                          : static_cast<uint8_t>(IORING_OP_READ);
+  sqe->fd = entry.m_fd;
+  sqe->off = static_cast<uint64_t>(-1);
+  sqe->len = MULTISHOT ? 0 : options_.m_read_buffer_size;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = BUFFER_GROUP;
+  sqe->user_data = TAG_READ | entry.m_id;
+}
+
+void UringReactor::arm_wakeup_locked() {
+  auto* sqe = static_cast<io_uring_sqe*>(next_sqe_locked());
+  if (sqe == nullptr) {
+    return;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = event_fd_;
+  sqe->poll32_events = POLLIN;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  sqe->user_data = TAG_WAKEUP;
+}
+
+// One linked chain per descriptor: the kernel starts a write only after the
+// previous one completed, and a short write cancels the rest of the chain,
+// which is then resubmitted from the first unfinished slot.
+void UringReactor::chain_writes_locked() {
+  std::vector<uint64_t> waiting;
+  for (const uint64_t ID : ready_) {
+    const auto ITER = entries_.find(ID);
+    if (ITER == entries_.end()) {
+      continue;
+    }
+    Entry& entry = *ITER->second;
+    if (entry.m_inflight > 0 || entry.m_queue.empty()) {
+      continue;
+    }
+    const unsigned POLL = entry.m_wait_writable ? 1U : 0U;
+    const unsigned SPACE = queues_->m_sq_entries - pending_sqes_locked();
+    const auto COUNT = static_cast<unsigned>(
+        SPACE > POLL ? std::min<size_t>(entry.m_queue.size(), SPACE - POLL)
+                     : 0);
+    if (COUNT == 0) {
+      waiting.push_back(ID);
+      continue;
+    }
+    if (POLL != 0) {
+      // the chain starts once the descriptor is writable again instead of
+      // resubmitting a write that cannot progress
+      auto* sqe = static_cast<io_uring_sqe*>(next_sqe_locked());
+      sqe->opcode = IORING_OP_POLL_ADD;
+      sqe->fd = entry.m_fd;
+      sqe->poll32_events = POLLOUT;
+      sqe->flags = IOSQE_IO_LINK;
+      sqe->user_data = TAG_OTHER | ID;
+      entry.m_wait_writable = false;
+    }
+    for (unsigned i = 0; i < COUNT; ++i) {
+      const uint16_t SLOT = entry.m_queue[i];
+      const Slot& slot = slots_[SLOT];
+      auto* sqe = static_cast<io_uring_sqe*>(next_sqe_locked());
+      uint8_t* data =
+          write_memory_ +
+          static_cast<size_t>(SLOT) * options_.m_write_slot_size +
+          slot.m_offset;
+      if (entry.m_socket) {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->msg_flags = MSG_NOSIGNAL;  // EPIPE, а не SIGPIPE
+      } else {
+        sqe->opcode = fixed_writes_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->off = static_cast<uint64_t>(-1);
+        sqe->buf_index = 0;
+      }
+      sqe->fd = entry.m_fd;
+      sqe->addr = reinterpret_cast<uint64_t>(data);
+      sqe->len = slot.m_size - slot.m_offset;
+      sqe->flags = i + 1 < COUNT ? IOSQE_IO_LINK : 0;
+      sqe->user_data = TAG_WRITE | SLOT;
+    }
+    entry.m_inflight = COUNT;
+  }
+  ready_ = std::move(waiting);
+}
+
+void UringReactor::drop_entry_locked(const uint64_t ID) {
+  const auto ITER = entries_.find(ID);
+  if (ITER == entries_.end()) {
+    return;
+  }
+  Entry& entry = *ITER->second;
+  // slots in the kernel are freed by their completions
+  for (size_t i = entry.m_inflight; i < entry.m_queue.size(); ++i) {
+    free_slots_.push_back(entry.m_queue[i]);
+  }
+  entry.m_queue.resize(entry.m_inflight);
+  fcntl(entry.m_fd, F_SETFL, entry.m_flags);
+  if (const auto FD = ids_.find(entry.m_fd);
+      FD != ids_.end() && FD->second == ID) {
+    ids_.erase(FD);
+  }
+  entries_.erase(ITER);
+  slot_cv_.notify_all();
+}
+
+void UringReactor::wakeup() const {
+  const uint64_t ONE = 1;
+  // Only fails with EAGAIN when the counter is saturated, i.e. already set.
+  [[maybe_unused]] const auto RESULT = ::write(event_fd_, &ONE, sizeof(ONE));
+}
+
+auto UringReactor::add(const int FD, Handler handler) -> bool {
+  struct stat info {};
+  if (fstat(FD, &info) != 0) {
+    return false;
+  }
+  {
+    std::lock_guard lock(mtx_);
+    const int FLAGS = fcntl(FD, F_GETFL);
+    if (ids_.count(FD) != 0 || FLAGS < 0 ||
+        fcntl(FD, F_SETFL, FLAGS & ~O_NONBLOCK) != 0) {
+      return false;
+    }
+    auto entry = std::make_shared<Entry>();
+    entry->m_id = next_id_++;
+    entry->m_fd = FD;
+    entry->m_flags = FLAGS;
+    entry->m_socket = S_ISSOCK(info.st_mode);
+    entry->m_handler = std::move(handler);
+    entries_[entry->m_id] = entry;
+    ids_[FD] = entry->m_id;
+    to_arm_.push_back(entry->m_id);
+  }
+  // the read is submitted by the reactor thread, so its completions are
+  // processed there and not on the caller's thread
+  wakeup();
+  return true;
+}
+
+void UringReactor::remove(const int FD) {
+  std::unique_lock lock(mtx_);
+  if (const auto ITER = ids_.find(FD); ITER != ids_.end()) {
+    const uint64_t ID = ITER->second;
+    drop_entry_locked(ID);
+    // writes in flight hold their own reference to the file and finish;
+    // submitting right away also pushes out every SQE that still names FD
+    // before the owner closes it
+    for (const uint64_t TARGET : {TAG_READ | ID, TAG_OTHER | ID}) {
+      if (auto* sqe = static_cast<io_uring_sqe*>(next_sqe_locked())) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = TARGET;
+        sqe->user_data = TAG_OTHER;
+      }
+    }
+    flush_sq_locked();
+  }
+  if (std::this_thread::get_id() == thread_.get_id()) {
+    return;  // called from a handler: nothing else runs on this thread
+  }
+  idle_cv_.wait(lock, [this, FD] { return current_fd_ != FD; });
+}
+
+auto UringReactor::write(const int FD, const CustomSpan<uint8_t> DATA,
+                         const std::chrono::milliseconds TIMEOUT) -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  const bool ON_REACTOR = std::this_thread::get_id() == thread_.get_id();
+  // handlers cannot wait for completions, so other threads leave them slots
+  const size_t RESERVE = ON_REACTOR ? 0 : options_.m_write_slots / 4U;
+  std::unique_lock lock(mtx_);
+  size_t done = 0;
+  while (done < DATA.size()) {
+    const auto ID = ids_.find(FD);
+    if (ID == ids_.end()) {
+      return false;
+    }
+    Entry& entry = *entries_[ID->second];
+    uint16_t slot_index = 0;
+    if (entry.m_queue.size() > entry.m_inflight &&
+        slots_[entry.m_queue.back()].m_size < options_.m_write_slot_size) {
+      slot_index = entry.m_queue.back();  // дописываем в ещё не отданный слот
+    } else if (free_slots_.size() > RESERVE) {
+      slot_index = free_slots_.back();
+      free_slots_.pop_back();
+      slots_[slot_index] = {ID->second, 0, 0};
+      entry.m_queue.push_back(slot_index);
+      if (entry.m_inflight == 0 && entry.m_queue.size() == 1) {
+        ready_.push_back(ID->second);
+      }
+    } else {
+      // слоты освобождаются только завершениями: отдаём очередь ядру
+      chain_writes_locked();
+      flush_sq_locked();
+      if (ON_REACTOR ||
+          slot_cv_.wait_until(lock, DEADLINE) == std::cv_status::timeout) {
+        return false;
+      }
+      continue;
+    }
+    Slot& slot = slots_[slot_index];
+    const size_t COUNT = std::min<size_t>(DATA.size() - done,
+                                          options_.m_write_slot_size - slot.m_size);
+    std::memcpy(write_memory_ +
+                    static_cast<size_t>(slot_index) * options_.m_write_slot_size +
+                    slot.m_size,
+                DATA.data() + done, COUNT);
+    slot.m_size += static_cast<uint32_t>(COUNT);
+    done += COUNT;
+  }
+  return true;
+}
+
+auto UringReactor::flush() -> bool {
+  return options_.m_submit_on_flush ? submit() : true;
+}
+
+auto UringReactor::submit() -> bool {
+  std::lock_guard lock(mtx_);
+  chain_writes_locked();
+  return flush_sq_locked();
+}
+
+auto UringReactor::size() -> size_t {
+  std::lock_guard lock(mtx_);
+  return entries_.size();
+}
+
+// current_fd_ is set in the same critical section that finds the entry,
+// so remove() either drops the entry first or waits for the handler.
+void UringReactor::handler_done() {
+  {
+    std::lock_guard lock(mtx_);
+    current_fd_ = -1;
+  }
+  idle_cv_.notify_all();
+}
+
+void UringReactor::on_read(const uint64_t ID, const int RESULT,
+                           const uint32_t FLAGS) {
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard lock(mtx_);
+    if (const auto ITER = entries_.find(ID); ITER != entries_.end()) {
+      entry = ITER->second;
+      current_fd_ = entry->m_fd;
+    }
+  }
+  if ((FLAGS & IORING_CQE_F_BUFFER) != 0) {
+    const auto BUFFER =
+        static_cast<uint16_t>(FLAGS >> IORING_CQE_BUFFER_SHIFT);
+    if (entry && RESULT > 0) {
+      entry->m_handler({read_memory_ + static_cast<size_t>(BUFFER) *
+                                           options_.m_read_buffer_size,
+                        static_cast<size_t>(RESULT)});
+    }
+    recycle(BUFFER);
+  }
+  if (!entry) {
+    return;
+  }
+
+  bool closed = false;
+  if ((FLAGS & IORING_CQE_F_MORE) == 0) {
+    std::lock_guard lock(mtx_);
+    if (entries_.count(ID) == 0) {
+      // removed, possibly by the handler above
+    } else if (RESULT > 0 || RESULT == -ENOBUFS || RESULT == -EINTR ||
+               RESULT == -EAGAIN) {
+      to_arm_.push_back(ID);
+    } else if (multishot_ && !entry->m_single_shot &&
+               (RESULT == -EINVAL || RESULT == -EBADFD ||
+                RESULT == -EOPNOTSUPP)) {
+      entry->m_single_shot = true;  // драйвер не умеет multishot
+      to_arm_.push_back(ID);
+    } else {
+      drop_entry_locked(ID);  // EOF или ошибка
+      closed = true;
+    }
+  }
+  if (closed) {
+    entry->m_handler({});
+  }
+  handler_done();
+}
+
+void UringReactor::on_write(const uint16_t SLOT, const int RESULT) {
+  std::shared_ptr<Entry> failed;
+  {
+    std::lock_guard lock(mtx_);
+    const uint64_t ID = slots_[SLOT].m_entry;
+    const auto ITER = entries_.find(ID);
+    if (ITER == entries_.end()) {
+      free_slots_.push_back(SLOT);
+    } else {
+      Entry& entry = *ITER->second;
+      --entry.m_inflight;
+      Slot& slot = slots_[SLOT];
+      if (RESULT > 0) {
+        slot.m_offset += static_cast<uint32_t>(RESULT);
+        if (slot.m_offset >= slot.m_size) {
+          entry.m_queue.pop_front();  // completions of a chain come in order
+          free_slots_.push_back(SLOT);
+        }
+      } else if (RESULT == 0 || RESULT == -EAGAIN) {
+        entry.m_wait_writable = true;  // ждём POLLOUT, а не крутим запись
+      } else if (RESULT != -ECANCELED && RESULT != -EINTR) {
+        failed = ITER->second;
+        current_fd_ = failed->m_fd;
+        drop_entry_locked(ID);
+      }
+      if (!failed && entry.m_inflight == 0 && !entry.m_queue.empty()) {
+        ready_.push_back(ID);
+      }
+    }
+  }
+  slot_cv_.notify_all();
+  if (failed) {
+    failed->m_handler({});
+    handler_done();
+  }
+}
+
+void UringReactor::reap() {
+  Queues& queues = *queues_;
+  unsigned head = *queues.m_cq_head;
+  while (head != __atomic_load_n(queues.m_cq_tail, __ATOMIC_ACQUIRE)) {
+    const io_uring_cqe CQE = queues.m_cqes[head & queues.m_cq_mask];
+    __atomic_store_n(queues.m_cq_head, ++head, __ATOMIC_RELEASE);
+    const uint64_t VALUE = CQE.user_data & VALUE_MASK;
+    switch (CQE.user_data & ~VALUE_MASK) {
+      case TAG_READ:
+        on_read(VALUE, CQE.res, CQE.flags);
+        break;
+      case TAG_WRITE:
+        on_write(static_cast<uint16_t>(VALUE), CQE.res);
+        break;
+      case TAG_WAKEUP: {
+        uint64_t count{};
+        [[maybe_unused]] const auto RESULT =
+            ::read(event_fd_, &count, sizeof(count));
+        if ((CQE.flags & IORING_CQE_F_MORE) == 0) {
+          std::lock_guard lock(mtx_);
+          arm_wakeup_locked();
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+void UringReactor::loop() {
+  {
+    std::lock_guard lock(mtx_);
+    arm_wakeup_locked();
+  }
+  while (true) {
+    unsigned pending = 0;
+    {
+      std::lock_guard lock(mtx_);
+      if (!running_) {
+        break;
+      }
+      if (!to_arm_.empty()) {
+        // reads are submitted here, never by a writer thread
+        for (const uint64_t ID : to_arm_) {
+          if (const auto ITER = entries_.find(ID); ITER != entries_.end()) {
+            arm_read_locked(*ITER->second);
+          }
+        }
+        to_arm_.clear();
+        flush_sq_locked();
+      }
+      chain_writes_locked();
+      __atomic_store_n(queues_->m_sq_tail, queues_->m_local_tail,
+                       __ATOMIC_RELEASE);
+      pending = pending_sqes_locked();
+    }
+    // submit and wait in one call
+    if (enter(pending, 1) < 0 && errno != EINTR && errno != EBUSY) {
+      break;
+    }
+    reap();
+  }
+}
+
+AutoReactor::AutoReactor(const bool PREFER_URING,
+                         const UringOptions& options) {
+  if (PREFER_URING && UringReactor::is_supported()) {
+    try {
+      uring_ = std::make_unique<UringReactor>(options);
+    } catch (const std::runtime_error&) {
+      uring_.reset();
+    }
+  }
+  if (!uring_) {
+    epoll_ = std::make_unique<EpollReactor>();
+  }
+}
+}  // namespace proto::interface
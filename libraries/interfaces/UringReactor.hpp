@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CustomSpan.hpp"
+#include "EpollReactor.hpp"
+
+namespace proto::interface {
+
+struct UringOptions {
+  unsigned m_entries{256};  //!< Submission queue size.
+  /// Provided read buffers shared by all descriptors; a power of two.
+  uint16_t m_read_buffers{256};
+  uint32_t m_read_buffer_size{4096};  //!< Largest chunk per callback.
+  uint16_t m_write_slots{256};        //!< Write buffers shared by all ports.
+  uint32_t m_write_slot_size{4096};
+  /// false: a port's flush() only queues its writes; call submit() once
+  /// after a burst over many ports.
+  bool m_submit_on_flush{true};
+};
+
+/**
+ * @brief One io_uring loop that reads from and writes to many descriptors.
+ *
+ * Unlike EpollReactor the kernel does the I/O itself:
+ * - every descriptor has a multishot read that fills buffers from a ring
+ *   provided to the kernel, so an armed read costs no syscall at all (on
+ *   kernels without multishot reads, one read is re-armed per completion);
+ * - write() copies into a registered buffer slot and queues it; small
+ *   writes share the descriptor's last slot until it is submitted. flush()
+ *   or submit() hands all queued writes to the kernel in one
+ *   io_uring_enter(). Writes of one descriptor form a linked chain and leave
+ *   in order.
+ *
+ * Handlers run on the reactor thread with the received bytes, which stay
+ * valid until the handler returns. An empty span reports EOF or an error;
+ * the descriptor is no longer watched after that.
+ *
+ * add() switches the descriptor to blocking mode: io_uring waits for
+ * readiness itself and would return EAGAIN on a non-blocking one. The
+ * previous flags come back once the descriptor is no longer watched
+ * (remove(), EOF or an error). A write that still makes no progress waits
+ * for POLLOUT before the descriptor's writes are resubmitted.
+ *
+ * @warning The reactor must outlive every interface registered with it.
+ */
+class UringReactor {
+ public:
+  using Handler = std::function<void(CustomSpan<uint8_t> data)>;
+
+  /// @throws std::runtime_error if the kernel lacks what the reactor needs.
+  explicit UringReactor(const UringOptions& options = {});
+  ~UringReactor();
+
+  UringReactor(const UringReactor&) = delete;
+  auto operator=(const UringReactor&) -> UringReactor& = delete;
+
+  /// @brief io_uring with provided buffer rings (Linux 5.19+) is usable.
+  static auto is_supported() -> bool;
+
+  /// @brief Start reading @p FD; see the class notes for @p handler.
+  auto add(int FD, Handler handler) -> bool;
+
+  /**
+   * @brief Stop watching @p FD and drop writes not yet submitted.
+   *
+   * As EpollReactor::remove(): waits for a running handler of @p FD unless
+   * called from a handler.
+   */
+  void remove(int FD);
+
+  /**
+   * @brief Queue @p data for @p FD.
+   *
+   * Waits up to @p timeout for free slots. From the reactor thread it does
+   * not wait and returns false when the slots run out; other threads leave
+   * a quarter of the slots to it, so handlers can always reply.
+   */
+  auto write(int FD, CustomSpan<uint8_t> data,
+             std::chrono::milliseconds timeout) -> bool;
+
+  /// @brief Frame boundary of a port: submit() unless deferred by options.
+  auto flush() -> bool;
+
+  /// @brief Hand every queued write to the kernel.
+  auto submit() -> bool;
+
+  /// @brief Number of descriptors currently registered.
+  [[nodiscard]] auto size() -> size_t;
+
+  /// @brief Reads are multishot (Linux 6.7+), not re-armed one by one.
+  [[nodiscard]] auto multishot() const -> bool { return multishot_; }
+
+  /// @brief io_uring_enter() calls so far, for benchmarks.
+  [[nodiscard]] auto enter_calls() const -> uint64_t {
+    return enter_calls_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Queues;
+  struct Entry;
+  struct Slot {
+    uint64_t m_entry{0};
+    uint32_t m_size{0};
+    uint32_t m_offset{0};
+  };
+
+  UringOptions options_;
+  std::unique_ptr<Queues> queues_;
+  bool multishot_{false};
+  bool fixed_writes_{false};
+  std::atomic<uint64_t> enter_calls_{0};
+
+  // Read buffers and the ring that provides them; only the reactor thread
+  // returns buffers.
+  uint8_t* read_memory_{nullptr};
+  void* buffer_ring_{nullptr};
+  size_t buffer_ring_size_{0};
+  uint16_t buffer_tail_{0};
+
+  int event_fd_{-1};
+
+  // Guarded by mtx_ together with the submission queue
+  std::mutex mtx_;
+  std::condition_variable idle_cv_;
+  std::condition_variable slot_cv_;
+  bool running_{true};
+  uint64_t next_id_{1};
+  int current_fd_{-1};  // descriptor whose handler runs now
+  std::unordered_map<uint64_t, std::shared_ptr<Entry>> entries_;
+  std::unordered_map<int, uint64_t> ids_;
+  std::vector<uint64_t> to_arm_;  // reads the reactor thread has to submit
+  std::vector<uint64_t> ready_;   // entries with writes to chain
+  uint8_t* write_memory_{nullptr};
+  std::vector<Slot> slots_;
+  std::vector<uint16_t> free_slots_;
+
+  std::thread thread_;
+
+  void setup_buffers();
+  void release_buffers();
+  auto next_sqe_locked() -> void*;
+  auto pending_sqes_locked() const -> unsigned;
+  auto enter(unsigned submit, unsigned wait) -> int;
+  auto flush_sq_locked() -> bool;
+  void arm_read_locked(const Entry& entry);
+  void arm_wakeup_locked();
+  void chain_writes_locked();
+  void drop_entry_locked(uint64_t id);
+  void wakeup() const;
+  void recycle(uint16_t buffer);
+  void handler_done();
+  void on_read(uint64_t id, int result, uint32_t flags);
+  void on_write(uint16_t slot, int result);
+  void reap();
+  void loop();
+};
+
+/**
+ * @brief io_uring when the kernel supports it, epoll otherwise.
+ *
+ * @code{.cpp}
+ * AutoReactor reactor;
+ * auto uart = reactor.make<UartLinuxInterface>();
+ * auto link = reactor.make<StreamSocketInterface>(SocketOptions{});
+ * @endcode
+ */
+class AutoReactor {
+ public:
+  /// @param prefer_uring false forces epoll, e.g. for comparison.
+  explicit AutoReactor(bool prefer_uring = true,
+                       const UringOptions& options = {});
+
+  /// @brief Construct @p Port served by the chosen reactor.
+  template <typename Port, typename... Args>
+  auto make(Args&&... args) -> std::unique_ptr<Port> {
+    if (uring_) {
+      return std::make_unique<Port>(*uring_, std::forward<Args>(args)...);
+    }
+    return std::make_unique<Port>(*epoll_, std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]] auto uring() const -> UringReactor* { return uring_.get(); }
+  [[nodiscard]] auto uses_uring() const -> bool { return uring_ != nullptr; }
+
+ private:
+  std::unique_ptr<UringReactor> uring_;
+  std::unique_ptr<EpollReactor> epoll_;
+};
+}  // namespace proto::interface
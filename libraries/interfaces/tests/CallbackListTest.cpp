@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "CallbackList.hpp"
+#include "Loopback.hpp"
+
+namespace {
+using namespace proto;
+using namespace proto::interface;
+using namespace std::chrono_literals;
+
+using IntCallback = std::function<void(int)>;
+
+TEST(CallbackListTest, NewestFirstAndExpiredPruned) {
+  CallbackList<IntCallback> list;
+  std::vector<int> order;
+  auto first = std::make_shared<IntCallback>([&](int) { order.push_back(1); });
+  auto second = std::make_shared<IntCallback>([&](int) { order.push_back(2); });
+  list.add(first);
+  list.add(second);
+  list.for_each([](IntCallback& callback) { callback(0); });
+  EXPECT_EQ(order, (std::vector<int>{2, 1}));
+
+  first.reset();
+  order.clear();
+  list.for_each([](IntCallback& callback) { callback(0); });
+  EXPECT_EQ(order, (std::vector<int>{2}));
+  EXPECT_EQ(list.size(), 1U);  // the walk published a pruned snapshot
+}
+
+TEST(CallbackListTest, AddDuringWalkTakesEffectNextWalk) {
+  CallbackList<IntCallback> list;
+  std::vector<std::shared_ptr<IntCallback>> keep;
+  int calls = 0;
+  keep.push_back(std::make_shared<IntCallback>([&](int) {
+    ++calls;
+    keep.push_back(std::make_shared<IntCallback>([&](int) { ++calls; }));
+    list.add(keep.back());
+  }));
+  list.add(keep.back());
+  list.for_each([](IntCallback& callback) { callback(0); });
+  EXPECT_EQ(calls, 1);  // the walk keeps its snapshot
+  EXPECT_EQ(list.size(), 2U);
+}
+
+/**
+ * @test Subscribers come and go while the receive thread delivers; run
+ * under ThreadSanitizer this used to report the vector race.
+ */
+TEST(CallbackListTest, SubscribeWhileReceiving) {
+  LoopbackOptions options;
+  options.m_max_chunk = 64;
+  LoopbackPair link(options);
+  std::atomic<bool> running{true};
+  std::atomic<size_t> received{0};
+  auto counter = link.m_b.add_receive_callback(
+      [&received](CustomSpan<uint8_t> data, size_t& /*read*/) {
+        received += data.size();
+      });
+
+  std::thread writer([&] {
+    const std::vector<uint8_t> DATA(1000, 0x11);
+    while (running) {
+      link.m_a.write({DATA.data(), DATA.size()}, 1s);
+    }
+  });
+  std::vector<std::thread> churn;
+  std::atomic<size_t> subscriptions{0};
+  for (int t = 0; t < 4; ++t) {
+    churn.emplace_back([&] {
+      while (running) {
+        // a walk that already holds the callback may still run it after
+        // reset(), so it owns what it touches
+        auto seen = std::make_shared<std::atomic<size_t>>(0);
+        auto delegate = link.m_b.add_receive_callback(
+            [seen](CustomSpan<uint8_t> data, size_t& /*read*/) {
+              *seen += data.size();
+            });
+        std::this_thread::sleep_for(100us);
+        delegate.reset();
+        ++subscriptions;
+      }
+    });
+  }
+  std::this_thread::sleep_for(300ms);
+  running = false;
+  for (auto& thread : churn) {
+    thread.join();
+  }
+  writer.join();
+  EXPECT_GT(received.load(), 0U);
+  EXPECT_GT(subscriptions.load(), 100U);
+}
+
+/**
+ * @test Cost of one delivery walk over 4 subscribers, with and without
+ * another thread subscribing and unsubscribing every 10 us.
+ */
+TEST(CallbackListTest, WalkBenchmark) {
+  constexpr size_t WALKS = 2'000'000;
+  CallbackList<IntCallback> list;
+  std::atomic<long> sum{0};
+  std::vector<std::shared_ptr<IntCallback>> keep;
+  for (int i = 0; i < 4; ++i) {
+    keep.push_back(std::make_shared<IntCallback>([&sum](int value) {
+      sum.fetch_add(value, std::memory_order_relaxed);
+    }));
+    list.add(keep.back());
+  }
+  std::printf("\n%-12s | %10s\n", "writers", "ns/walk");
+  for (const bool CHURN : {false, true}) {
+    std::atomic<bool> running{true};
+    std::thread writer;
+    if (CHURN) {
+      writer = std::thread([&] {
+        while (running) {
+          auto extra = std::make_shared<IntCallback>([](int) {});
+          list.add(extra);
+          std::this_thread::sleep_for(10us);
+        }
+      });
+    }
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < WALKS; ++i) {
+      list.for_each([](IntCallback& callback) { callback(1); });
+    }
+    const std::chrono::duration<double, std::nano> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    running = false;
+    if (writer.joinable()) {
+      writer.join();
+    }
+    std::printf("%-12s | %10.1f\n", CHURN ? "subscribing" : "none",
+                ELAPSED.count() / WALKS);
+  }
+  EXPECT_GE(sum.load(), static_cast<long>(4 * WALKS));
+}
+}  // namespace
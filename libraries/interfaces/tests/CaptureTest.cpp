@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Capture.hpp"
+#include "Loopback.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace proto::interface::test;
+using namespace std::chrono_literals;
+
+auto capture_path(const char* tag) -> std::string {
+  return "/tmp/protolib_" + std::string(tag) + "_" + std::to_string(getpid()) +
+         ".cap";
+}
+
+auto file_size(const std::string& path) -> size_t {
+  struct stat info {};
+  return stat(path.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size)
+                                        : 0;
+}
+
+auto bytes_of(const CaptureRecord& record) -> std::vector<uint8_t> {
+  return {record.m_data.begin(), record.m_data.end()};
+}
+
+TEST(CaptureTest, RecordsBothDirections) {
+  const std::string PATH = capture_path("both");
+  LoopbackPair link;
+  CaptureInterface capture(link.m_a, PATH);
+  ASSERT_TRUE(capture.open());
+  Collector at_board(link.m_b);
+  Collector at_host(capture);
+
+  const auto BYTES = pattern(300);
+  ASSERT_TRUE(capture.write({BYTES.data(), 100}, 1s));
+  ASSERT_TRUE(at_board.wait(100));
+  ASSERT_TRUE(link.m_b.write({BYTES.data() + 100, 200}, 1s));
+  ASSERT_TRUE(at_host.wait(200));
+  ASSERT_TRUE(capture.close());
+
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(PATH));
+  std::vector<uint8_t> tx;
+  std::vector<uint8_t> rx;
+  std::chrono::nanoseconds last{0};
+  for (const auto& RECORD : reader.records()) {
+    auto& side = RECORD.m_direction == CaptureDirection::TX ? tx : rx;
+    side.insert(side.end(), RECORD.m_data.begin(), RECORD.m_data.end());
+    EXPECT_GE(RECORD.m_time, last);
+    last = RECORD.m_time;
+  }
+  EXPECT_EQ(tx, std::vector<uint8_t>(BYTES.begin(), BYTES.begin() + 100));
+  EXPECT_EQ(rx, std::vector<uint8_t>(BYTES.begin() + 100, BYTES.end()));
+  EXPECT_EQ(at_host.m_bytes, rx);
+  EXPECT_EQ(capture.dropped(), 0U);
+  std::remove(PATH.c_str());
+}
+
+TEST(CaptureTest, FileGrowsAndIsTrimmed) {
+  const std::string PATH = capture_path("grow");
+  CaptureOptions options;
+  options.m_file_step = 4096;  // many remaps
+  LoopbackPair link;
+  CaptureInterface capture(link.m_a, PATH, options);
+  ASSERT_TRUE(capture.open());
+  Collector at_board(link.m_b);
+
+  const auto BYTES = pattern(1000);
+  constexpr size_t WRITES = 500;
+  for (size_t i = 0; i < WRITES; ++i) {
+    ASSERT_TRUE(capture.write({BYTES.data(), BYTES.size()}, 1s));
+  }
+  ASSERT_TRUE(at_board.wait(WRITES * BYTES.size()));
+  ASSERT_TRUE(capture.close());
+
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(PATH));
+  ASSERT_EQ(reader.records().size() + capture.dropped(), WRITES);
+  for (const auto& RECORD : reader.records()) {
+    ASSERT_EQ(bytes_of(RECORD), BYTES);
+  }
+  // 16-byte file header, 16-byte record headers, no slack at the end
+  EXPECT_EQ(file_size(PATH), 16 + reader.records().size() * (16 + 1000));
+  std::remove(PATH.c_str());
+}
+
+TEST(CaptureTest, CountsChunksThatDoNotFit) {
+  const std::string PATH = capture_path("drop");
+  CaptureOptions options;
+  options.m_buffer = 64;
+  LoopbackPair link;
+  CaptureInterface capture(link.m_a, PATH, options);
+  ASSERT_TRUE(capture.open());
+
+  const auto BYTES = pattern(100);
+  ASSERT_TRUE(capture.write({BYTES.data(), BYTES.size()}, 1s));  // delivered
+  ASSERT_TRUE(capture.write({BYTES.data(), 8}, 1s));
+  ASSERT_TRUE(capture.close());
+  EXPECT_EQ(capture.dropped(), 1U);
+
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(PATH));
+  ASSERT_EQ(reader.records().size(), 1U);
+  EXPECT_EQ(bytes_of(reader.records()[0]),
+            std::vector<uint8_t>(BYTES.begin(), BYTES.begin() + 8));
+  std::remove(PATH.c_str());
+}
+
+TEST(CaptureTest, UntrimmedFileKeepsItsRecords) {
+  const std::string PATH = capture_path("untrimmed");
+  LoopbackPair link;
+  CaptureInterface capture(link.m_a, PATH);
+  ASSERT_TRUE(capture.open());
+  Collector at_board(link.m_b);
+  const auto BYTES = pattern(100);
+  ASSERT_TRUE(capture.write({BYTES.data(), BYTES.size()}, 1s));
+  ASSERT_TRUE(at_board.wait(BYTES.size()));
+  ASSERT_TRUE(capture.close());
+
+  // a crash skips the trim: the pre-extended tail stays zero
+  ASSERT_EQ(truncate(PATH.c_str(), 1 << 20), 0);
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(PATH));
+  ASSERT_EQ(reader.records().size(), 1U);
+  EXPECT_EQ(reader.records()[0].m_direction, CaptureDirection::TX);
+  EXPECT_EQ(bytes_of(reader.records()[0]), BYTES);
+  std::remove(PATH.c_str());
+}
+
+TEST(CaptureTest, RejectsForeignFile) {
+  const std::string PATH = capture_path("foreign");
+  FILE* file = std::fopen(PATH.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fputs("definitely not a capture", file);
+  std::fclose(file);
+  CaptureReader reader;
+  EXPECT_FALSE(reader.open(PATH));
+  std::remove(PATH.c_str());
+}
+
+// Two RX chunks 50 ms apart.
+auto record_paced(const std::string& PATH, const std::vector<uint8_t>& BYTES)
+    -> bool {
+  LoopbackPair link;
+  CaptureInterface capture(link.m_a, PATH);
+  Collector at_host(capture);
+  capture.open();
+  link.m_b.write({BYTES.data(), 10}, 1s);
+  at_host.wait(10);
+  std::this_thread::sleep_for(50ms);
+  link.m_b.write({BYTES.data() + 10, BYTES.size() - 10}, 1s);
+  at_host.wait(BYTES.size());
+  return capture.close();
+}
+
+TEST(ReplayTest, OriginalPacingAndMaxSpeed) {
+  const std::string PATH = capture_path("replay");
+  const auto BYTES = pattern(64);
+  ASSERT_TRUE(record_paced(PATH, BYTES));
+
+  for (const auto PACING : {ReplayPacing::ORIGINAL, ReplayPacing::MAX_SPEED}) {
+    ReplayOptions options;
+    options.m_pacing = PACING;
+    options.m_repeat = 2;
+    ReplayInterface replay(options);
+    ASSERT_TRUE(replay.load(PATH));
+    Collector received(replay);
+    const auto START = std::chrono::steady_clock::now();
+    ASSERT_TRUE(replay.open());
+    ASSERT_TRUE(replay.wait_done(2s));
+    const auto ELAPSED = std::chrono::steady_clock::now() - START;
+    EXPECT_EQ(replay.delivered(), 2 * BYTES.size());
+
+    std::vector<uint8_t> twice = BYTES;
+    twice.insert(twice.end(), BYTES.begin(), BYTES.end());
+    EXPECT_EQ(received.m_bytes, twice);
+    if (PACING == ReplayPacing::ORIGINAL) {
+      EXPECT_GE(ELAPSED, 100ms);  // the 50 ms gap, once per pass
+    } else {
+      EXPECT_LT(ELAPSED, 50ms);
+    }
+  }
+  std::remove(PATH.c_str());
+}
+
+/// @test close() and load() from a receive callback stop the replay without
+/// joining the replay thread from itself.
+TEST(ReplayTest, CloseFromCallback) {
+  const std::string PATH = capture_path("replay_close");
+  const auto BYTES = pattern(64);
+  ASSERT_TRUE(record_paced(PATH, BYTES));
+
+  for (const bool LOAD : {false, true}) {
+    ReplayOptions options;
+    options.m_pacing = ReplayPacing::MAX_SPEED;
+    options.m_repeat = 100;
+    ReplayInterface replay(options);
+    ASSERT_TRUE(replay.load(PATH));
+    std::atomic<size_t> calls{0};
+    auto closer = replay.add_receive_callback(
+        [&](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+          ++calls;
+          if (LOAD) {
+            EXPECT_FALSE(replay.load(PATH));
+          } else {
+            EXPECT_TRUE(replay.close());
+          }
+        });
+    ASSERT_TRUE(replay.open());
+    ASSERT_TRUE(replay.wait_done(2s));
+    EXPECT_FALSE(replay.is_open());
+    EXPECT_EQ(calls, 1U);
+    EXPECT_TRUE(replay.load(PATH));  // joins the finished thread
+  }
+  std::remove(PATH.c_str());
+}
+}  // namespace
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Datagram.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace proto::interface::test;
+using namespace std::chrono_literals;
+
+class DatagramSuite : public testing::Test {
+ protected:
+  DatagramInterface receiver_;
+  std::array<uint8_t, 64> bytes_{};
+
+  void SetUp() override { ASSERT_TRUE(receiver_.bind()); }
+
+  void frame(DatagramInterface& sender, const size_t FIELD_SIZE) {
+    ASSERT_TRUE(sender.write({bytes_.data(), FIELD_SIZE}, 1s));
+    ASSERT_TRUE(sender.write({bytes_.data(), FIELD_SIZE}, 1s));
+    ASSERT_TRUE(sender.flush());
+  }
+};
+
+TEST_F(DatagramSuite, EachDatagramIsOneChunk) {
+  Collector chunks(receiver_);
+  DatagramInterface sender;
+  ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+  frame(sender, 3);
+  frame(sender, 5);
+  ASSERT_TRUE(chunks.wait_chunks(2));
+  EXPECT_EQ(chunks.m_chunks, (std::vector<size_t>{6, 10}));
+}
+
+TEST_F(DatagramSuite, FramesShareDatagram) {
+  Collector chunks(receiver_);
+  DatagramOptions options;
+  options.m_frames_per_datagram = 3;
+  DatagramInterface sender(options);
+  ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+  for (int i = 0; i < 4; ++i) {
+    frame(sender, 4);
+  }
+  ASSERT_TRUE(chunks.wait_chunks(1));
+  ASSERT_TRUE(sender.send_pending());
+  ASSERT_TRUE(chunks.wait_chunks(2));
+  EXPECT_EQ(chunks.m_chunks, (std::vector<size_t>{24, 8}));
+}
+
+TEST_F(DatagramSuite, SendBatchWaitsForBatch) {
+  Collector chunks(receiver_);
+  DatagramOptions options;
+  options.m_send_batch = 4;
+  DatagramInterface sender(options);
+  ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+  for (int i = 0; i < 3; ++i) {
+    frame(sender, 2);
+  }
+  std::this_thread::sleep_for(20ms);
+  EXPECT_EQ(chunks.m_count, 0U);
+  frame(sender, 2);
+  ASSERT_TRUE(chunks.wait_chunks(4));
+}
+
+TEST_F(DatagramSuite, RepliesGoToLastSender) {
+  auto echo = receiver_.add_receive_callback(
+      [this](CustomSpan<uint8_t> data, size_t& /*read*/) {
+        receiver_.write(data, 1s);
+        receiver_.flush();
+      });
+  DatagramInterface sender;
+  ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+  Collector replies(sender);
+  frame(sender, 7);
+  ASSERT_TRUE(replies.wait_chunks(1));
+  EXPECT_EQ(replies.m_chunks.front(), 14U);
+}
+
+TEST_F(DatagramSuite, OversizedWriteFails) {
+  DatagramOptions options;
+  options.m_max_datagram = 16;
+  DatagramInterface sender(options);
+  ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+  EXPECT_FALSE(sender.write({bytes_.data(), 32}, 1s));
+}
+
+/**
+ * @test A frame whose second field does not fit the open datagram moves to
+ * the next datagram whole instead of being split, with one slot per batch
+ * and with several.
+ */
+TEST_F(DatagramSuite, FrameStraddlingCapacityMovesWhole) {
+  for (const size_t BATCH : {1, 2}) {
+    Collector chunks(receiver_);
+    DatagramOptions options;
+    options.m_max_datagram = 20;
+    options.m_frames_per_datagram = 4;
+    options.m_send_batch = BATCH;
+    DatagramInterface sender(options);
+    ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+    // кадры по 8 байт: третий в 20 байт не помещается
+    for (int i = 0; i < 6; ++i) {
+      frame(sender, 4);
+    }
+    ASSERT_TRUE(sender.send_pending());
+    ASSERT_TRUE(chunks.wait_chunks(3));
+    std::lock_guard lock(chunks.m_mtx);
+    EXPECT_EQ(chunks.m_chunks, (std::vector<size_t>{16, 16, 16})) << BATCH;
+  }
+}
+
+/// @test A frame larger than a datagram fails as a whole and does not
+/// disturb the next one.
+TEST_F(DatagramSuite, OversizedFrameIsDropped) {
+  Collector chunks(receiver_);
+  DatagramOptions options;
+  options.m_max_datagram = 16;
+  DatagramInterface sender(options);
+  ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+  EXPECT_TRUE(sender.write({bytes_.data(), 10}, 1s));
+  EXPECT_FALSE(sender.write({bytes_.data(), 10}, 1s));
+  EXPECT_FALSE(sender.write({bytes_.data(), 2}, 1s));
+  EXPECT_FALSE(sender.flush());
+  frame(sender, 4);
+  ASSERT_TRUE(chunks.wait_chunks(1));
+  std::this_thread::sleep_for(20ms);
+  std::lock_guard lock(chunks.m_mtx);
+  EXPECT_EQ(chunks.m_chunks, (std::vector<size_t>{8}));
+}
+
+/// @test close() from a receive callback returns at once; the reader thread
+/// closes the socket on its way out and the interface can be bound again.
+TEST_F(DatagramSuite, CloseFromCallback) {
+  std::atomic<size_t> calls{0};
+  auto closer = receiver_.add_receive_callback(
+      [this, &calls](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+        ++calls;
+        EXPECT_TRUE(receiver_.close());
+      });
+  DatagramInterface sender;
+  ASSERT_TRUE(sender.connect("127.0.0.1", receiver_.port()));
+  frame(sender, 3);
+  const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+  while (receiver_.is_open() && std::chrono::steady_clock::now() < DEADLINE) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_FALSE(receiver_.is_open());
+  EXPECT_EQ(calls, 1U);
+  ASSERT_TRUE(receiver_.bind());  // joins the reader that ran the callback
+  EXPECT_TRUE(receiver_.is_open());
+}
+
+/**
+ * @test Datagrams per second on localhost: 200k single-frame datagrams of
+ * 32 bytes, one sendmmsg()/recvmmsg() per 32 datagrams versus one
+ * sendmsg()/recvmsg() each. Receive rate counts until the last datagram
+ * arrives; UDP may drop, so the loss is reported too.
+ */
+TEST(DatagramBenchmark, PacketsPerSecond) {
+  constexpr size_t DATAGRAMS = 200000;
+  constexpr size_t SIZE = 32;
+  std::array<uint8_t, SIZE> bytes{};
+
+  std::printf("\n%-8s | %12s %12s %8s\n", "mode", "tx pkt/s", "rx pkt/s",
+              "loss %");
+  for (const bool MMSG : {false, true}) {
+    DatagramOptions options;
+    options.m_use_mmsg = MMSG;
+    options.m_send_batch = MMSG ? 32 : 1;
+    DatagramInterface receiver(options);
+    ASSERT_TRUE(receiver.bind());
+    std::atomic<size_t> received{0};
+    auto counter = receiver.add_receive_callback(
+        [&received](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+          ++received;
+        });
+    DatagramInterface sender(options);
+    ASSERT_TRUE(sender.connect("127.0.0.1", receiver.port()));
+
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < DATAGRAMS; ++i) {
+      sender.write({bytes.data(), SIZE}, 1s);
+      sender.flush();
+    }
+    sender.send_pending();
+    const auto SENT = std::chrono::steady_clock::now();
+
+    // ждём, пока поток приёма перестанет получать датаграммы
+    auto last_change = SENT;
+    size_t last = received;
+    while (received < DATAGRAMS &&
+           std::chrono::steady_clock::now() - last_change < 100ms) {
+      std::this_thread::sleep_for(1ms);
+      if (received != last) {
+        last = received;
+        last_change = std::chrono::steady_clock::now();
+      }
+    }
+    const auto DONE = received == DATAGRAMS ? std::chrono::steady_clock::now()
+                                            : last_change;
+    const std::chrono::duration<double> TX = SENT - START;
+    const std::chrono::duration<double> RX = DONE - START;
+    std::printf("%-8s | %12.0f %12.0f %8.2f\n", MMSG ? "mmsg" : "plain",
+                DATAGRAMS / TX.count(),
+                static_cast<double>(received) / RX.count(),
+                100.0 * static_cast<double>(DATAGRAMS - received) /
+                    DATAGRAMS);
+  }
+}
+}  // namespace
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "InterfaceStats.hpp"
+#include "Loopback.hpp"
+#include "Socket.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace std::chrono_literals;
+
+auto wait_for(const std::atomic<size_t>& value, const size_t EXPECTED)
+    -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + 5s;
+  while (value < EXPECTED) {
+    if (std::chrono::steady_clock::now() > DEADLINE) {
+      return false;
+    }
+    std::this_thread::sleep_for(100us);
+  }
+  return true;
+}
+
+TEST(InterfaceStatsTest, HistogramBuckets) {
+  using H = LogLinearHistogram;
+  for (uint64_t value = 0; value < H::SUB_BUCKETS; ++value) {
+    EXPECT_EQ(H::lower_bound(H::index(value)), value);  // exact below 16
+  }
+  for (const uint64_t VALUE :
+       {16ULL, 17ULL, 100ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+    const size_t INDEX = H::index(VALUE);
+    ASSERT_LT(INDEX, H::BUCKETS);
+    EXPECT_LE(H::lower_bound(INDEX), VALUE);
+    EXPECT_LE(VALUE - H::lower_bound(INDEX), H::lower_bound(INDEX) / 16);
+    EXPECT_EQ(H::index(H::lower_bound(INDEX)), INDEX);
+  }
+
+  H histogram;
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.record(value);
+  }
+  const HistogramSnapshot SNAP{histogram.counts()};
+  EXPECT_EQ(SNAP.total(), 1000U);
+  EXPECT_EQ(SNAP.percentile(0.0), 1U);
+  EXPECT_NEAR(static_cast<double>(SNAP.percentile(0.5)), 500.0, 500 / 16.0);
+  EXPECT_NEAR(static_cast<double>(SNAP.percentile(0.99)), 990.0, 990 / 16.0);
+  EXPECT_EQ(HistogramSnapshot{}.percentile(0.5), 0U);
+}
+
+TEST(InterfaceStatsTest, LoopbackCountsBothSides) {
+  LoopbackPair link;
+  link.m_a.stats().enable_histograms();
+  link.m_b.stats().enable_histograms();
+  std::atomic<size_t> received{0};
+  auto counter = link.m_b.add_receive_callback(
+      [&received](CustomSpan<uint8_t> data, size_t& /*read*/) {
+        received += data.size();
+      });
+
+  constexpr size_t FRAMES = 100;
+  const std::vector<uint8_t> FRAME(300, 0x5A);
+  for (size_t i = 0; i < FRAMES; ++i) {
+    ASSERT_TRUE(link.m_a.write({FRAME.data(), FRAME.size()}, 1s));
+  }
+  ASSERT_TRUE(wait_for(received, FRAMES * FRAME.size()));
+
+  const auto TX = link.m_a.stats().snapshot();
+  const auto RX = link.m_b.stats().snapshot();
+  EXPECT_EQ(TX.m_bytes_out, FRAMES * FRAME.size());
+  EXPECT_GE(TX.m_write_calls, FRAMES);
+  EXPECT_EQ(TX.m_write_latency_ns.total(), FRAMES);
+  EXPECT_EQ(RX.m_bytes_in, FRAMES * FRAME.size());
+  EXPECT_EQ(RX.m_read_sizes.total(), RX.m_read_calls);
+  EXPECT_EQ(TX.m_bytes_in, 0U);
+  EXPECT_EQ(TX.m_read_sizes.m_counts.size(), LogLinearHistogram::BUCKETS);
+}
+
+/**
+ * @test A peer that never reads fills the socket buffer: the writer sees
+ * EAGAIN and gives up at the timeout; adopting a new descriptor counts as
+ * a reconnect.
+ */
+TEST(InterfaceStatsTest, SocketEagainAndReconnect) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  StreamSocketInterface socket;
+  ASSERT_TRUE(socket.adopt(fds[0]));
+  const std::vector<uint8_t> DATA(4 * 1024 * 1024, 0x33);
+  EXPECT_FALSE(socket.write({DATA.data(), DATA.size()}, 50ms));
+
+  auto snap = socket.stats().snapshot();
+  EXPECT_GT(snap.m_eagain, 0U);
+  EXPECT_GT(snap.m_bytes_out, 0U);
+  EXPECT_LT(snap.m_bytes_out, DATA.size());
+  EXPECT_EQ(snap.m_reconnects, 0U);
+
+  socket.close();
+  ::close(fds[1]);
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  ASSERT_TRUE(socket.adopt(fds[0]));
+  const uint8_t BYTE = 1;
+  ASSERT_TRUE(socket.write({&BYTE, 1}, 1s));
+  snap = socket.stats().snapshot();
+  EXPECT_EQ(snap.m_reconnects, 1U);
+  socket.close();
+  ::close(fds[1]);
+}
+
+/**
+ * @test Cost of a 64-byte loopback write with counters only and with
+ * histograms, while a monitor thread takes a snapshot every millisecond.
+ */
+TEST(InterfaceStatsTest, OverheadBenchmark) {
+  constexpr size_t WRITES = 200'000;
+  const std::vector<uint8_t> FRAME(64, 0x42);
+  std::printf("\n%-12s | %10s | %10s | %8s\n", "histograms", "ns/write",
+              "p50 ns", "p99 ns");
+  for (const bool HISTOGRAMS : {false, true}) {
+    LoopbackPair link;
+    if (HISTOGRAMS) {
+      link.m_a.stats().enable_histograms();
+    }
+    std::atomic<size_t> received{0};
+    auto counter = link.m_b.add_receive_callback(
+        [&received](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          received += data.size();
+        });
+    std::atomic<bool> running{true};
+    std::atomic<size_t> polls{0};
+    std::thread monitor([&] {
+      while (running) {
+        const auto SNAP = link.m_a.stats().snapshot();
+        EXPECT_LE(SNAP.m_bytes_out, WRITES * FRAME.size());
+        ++polls;
+        std::this_thread::sleep_for(1ms);
+      }
+    });
+
+    const auto START = std::chrono::steady_clock::now();
+    bool written = true;
+    for (size_t i = 0; i < WRITES && written; ++i) {
+      written = link.m_a.write({FRAME.data(), FRAME.size()}, 1s);
+    }
+    const std::chrono::duration<double, std::nano> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    const bool DELIVERED = wait_for(received, WRITES * FRAME.size());
+    running = false;
+    monitor.join();
+    ASSERT_TRUE(written && DELIVERED);
+
+    const auto SNAP = link.m_a.stats().snapshot();
+    EXPECT_EQ(SNAP.m_bytes_out, WRITES * FRAME.size());
+    EXPECT_GT(polls.load(), 0U);
+    std::printf("%-12s | %10.1f | %10llu | %8llu\n", HISTOGRAMS ? "on" : "off",
+                ELAPSED.count() / WRITES,
+                static_cast<unsigned long long>(
+                    SNAP.m_write_latency_ns.percentile(0.5)),
+                static_cast<unsigned long long>(
+                    SNAP.m_write_latency_ns.percentile(0.99)));
+  }
+}
+}  // namespace
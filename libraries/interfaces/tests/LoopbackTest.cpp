@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "Loopback.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace proto::interface::test;
+using namespace std::chrono_literals;
+
+TEST(ByteRingTest, WrapsAround) {
+  ByteRing ring(10);
+  EXPECT_EQ(ring.capacity(), 16U);
+  const auto DATA = pattern(12);
+  EXPECT_EQ(ring.push({DATA.data(), DATA.size()}), 12U);
+  std::vector<uint8_t> out(16);
+  EXPECT_EQ(ring.pop(out.data(), 10), 10U);
+  EXPECT_EQ(ring.push({DATA.data(), DATA.size()}), 12U);
+  EXPECT_EQ(ring.push({DATA.data(), DATA.size()}), 2U);  // full
+  EXPECT_EQ(ring.pop(out.data(), 2), 2U);
+  EXPECT_EQ(ring.pop(out.data(), 16), 14U);
+  EXPECT_EQ(std::vector<uint8_t>(out.begin(), out.begin() + 12), DATA);
+  EXPECT_EQ(ring.size(), 0U);
+}
+
+TEST(LoopbackTest, RandomChunksKeepByteOrder) {
+  LoopbackOptions options;
+  options.m_capacity = 1024;  // smaller than the data: writers must wait
+  options.m_max_chunk = 37;
+  options.m_random_chunks = true;
+  LoopbackPair link(options);
+  Collector sink(link.m_b);
+
+  const auto DATA = pattern(256 * 1024);
+  for (size_t sent = 0; sent < DATA.size(); sent += 1000) {
+    const size_t SIZE = std::min<size_t>(1000, DATA.size() - sent);
+    ASSERT_TRUE(link.m_a.write({DATA.data() + sent, SIZE}, 1s));
+  }
+  ASSERT_TRUE(sink.wait(DATA.size()));
+  EXPECT_EQ(sink.m_bytes, DATA);
+  EXPECT_LE(sink.m_largest, 37U);
+}
+
+TEST(LoopbackTest, DeliversOnReceiverThread) {
+  LoopbackPair link;
+  std::atomic<bool> other_thread{false};
+  const auto CALLER = std::this_thread::get_id();
+  auto delegate = link.m_b.add_receive_callback(
+      [&](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+        other_thread = std::this_thread::get_id() != CALLER;
+      });
+  Collector sink(link.m_b);
+  const auto DATA = pattern(8);
+  ASSERT_TRUE(link.m_a.write({DATA.data(), DATA.size()}, 1s));
+  ASSERT_TRUE(sink.wait(DATA.size()));
+  EXPECT_TRUE(other_thread);
+}
+
+TEST(LoopbackTest, WriteFailsWhenPeerClosedAndFull) {
+  LoopbackOptions options;
+  options.m_capacity = 16;
+  LoopbackPair link(options);
+  link.m_b.close();
+  const auto DATA = pattern(32);
+  EXPECT_FALSE(link.m_a.write({DATA.data(), DATA.size()}, 10ms));
+}
+
+TEST(LoopbackTest, WriteFailsWhenPeerClosed) {
+  LoopbackPair link;
+  link.m_b.close();
+  const auto DATA = pattern(8);
+  EXPECT_FALSE(link.m_a.write({DATA.data(), DATA.size()}, 10ms));
+  link.m_b.open();
+  Collector sink(link.m_b);
+  ASSERT_TRUE(link.m_a.write({DATA.data(), DATA.size()}, 1s));
+  ASSERT_TRUE(sink.wait(DATA.size()));
+  EXPECT_EQ(sink.m_bytes, DATA);  // the rejected write left nothing behind
+}
+
+auto thread_cpu_time() -> std::chrono::nanoseconds {
+  timespec time{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return std::chrono::seconds(time.tv_sec) +
+         std::chrono::nanoseconds(time.tv_nsec);
+}
+
+// A writer facing a full ring sleeps until the receiver makes room.
+TEST(LoopbackTest, WriterSleepsWhileRingIsFull) {
+  LoopbackOptions options;
+  options.m_capacity = 16;
+  LoopbackPair link(options);
+  auto delegate = link.m_b.add_receive_callback(
+      [](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+        std::this_thread::sleep_for(20ms);
+      });
+  Collector sink(link.m_b);
+
+  const auto DATA = pattern(64);
+  const auto START = std::chrono::steady_clock::now();
+  const auto CPU = thread_cpu_time();
+  ASSERT_TRUE(link.m_a.write({DATA.data(), DATA.size()}, 1s));
+  const auto WALL = std::chrono::steady_clock::now() - START;
+  EXPECT_GE(WALL, 40ms);
+  EXPECT_LT(thread_cpu_time() - CPU, WALL / 4);
+  ASSERT_TRUE(sink.wait(DATA.size()));
+  EXPECT_EQ(sink.m_bytes, DATA);
+}
+}  // namespace
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Loopback.hpp"
+#include "Mux.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace proto::interface::test;
+using namespace std::chrono_literals;
+
+/**
+ * @test Three channels written concurrently, in frames of odd sizes, come
+ * out intact and separated although the link cuts the stream at random.
+ */
+TEST(MuxTest, RoutesChannelsOverRandomChunks) {
+  LoopbackOptions options;
+  options.m_max_chunk = 7;
+  options.m_random_chunks = true;
+  LoopbackPair link(options);
+  MuxOptions mux_options;
+  mux_options.m_max_segment = 100;
+  ChannelMux near_end(link.m_a, mux_options);
+  ChannelMux far_end(link.m_b, mux_options);
+
+  constexpr size_t SIZE = 50'000;
+  std::vector<std::unique_ptr<Collector>> collectors;
+  std::vector<std::vector<uint8_t>> data;
+  for (uint8_t id = 1; id <= 3; ++id) {
+    collectors.push_back(std::make_unique<Collector>(far_end.channel(id)));
+    data.push_back(pattern(SIZE, id));
+  }
+  std::vector<std::thread> writers;
+  for (uint8_t id = 1; id <= 3; ++id) {
+    writers.emplace_back([&, id] {
+      auto& channel = near_end.channel(id);
+      const auto& bytes = data[id - 1];
+      size_t done = 0;
+      for (size_t frame = 1; done < SIZE; frame = frame * 7 % 311 + 1) {
+        const size_t COUNT = std::min(frame, SIZE - done);
+        ASSERT_TRUE(channel.write({bytes.data() + done, COUNT}, 1s));
+        ASSERT_TRUE(channel.flush());
+        done += COUNT;
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  for (size_t i = 0; i < collectors.size(); ++i) {
+    ASSERT_TRUE(collectors[i]->wait(SIZE));
+    std::lock_guard lock(collectors[i]->m_mtx);
+    EXPECT_EQ(collectors[i]->m_bytes, data[i]) << "channel " << i + 1;
+  }
+  EXPECT_EQ(far_end.resyncs(), 0U);
+  EXPECT_EQ(far_end.channel(2).stats().snapshot().m_bytes_in, SIZE);
+}
+
+TEST(MuxTest, SkipsGarbageAndUnknownChannels) {
+  LoopbackPair link;
+  ChannelMux near_end(link.m_a);
+  ChannelMux far_end(link.m_b);
+  Collector collector(far_end.channel(5));
+
+  const std::vector<uint8_t> GARBAGE(37, 0xFF);
+  const auto DATA = pattern(500, 5);
+  ASSERT_TRUE(link.m_a.write({GARBAGE.data(), GARBAGE.size()}, 1s));
+  ASSERT_TRUE(near_end.channel(9).write({DATA.data(), 10}, 1s));  // no reader
+  ASSERT_TRUE(near_end.channel(9).flush());
+  ASSERT_TRUE(near_end.channel(5).write({DATA.data(), DATA.size()}, 1s));
+  ASSERT_TRUE(near_end.channel(5).flush());
+
+  ASSERT_TRUE(collector.wait(DATA.size()));
+  std::lock_guard lock(collector.m_mtx);
+  EXPECT_EQ(collector.m_bytes, DATA);
+  EXPECT_EQ(far_end.resyncs(), GARBAGE.size());
+  EXPECT_EQ(far_end.dropped(), 10U);
+}
+
+/**
+ * @test Bytes dropped or flipped on the wire cost the segments they hit,
+ * but a channel never receives another channel's bytes or a header: every
+ * payload byte carries its channel id in the top two bits.
+ */
+TEST(MuxTest, CorruptionNeverCrossesChannels) {
+  constexpr size_t SIZE = 20'000;
+  MuxOptions mux_options;
+  mux_options.m_max_segment = 50;
+
+  // поток с провода записываем целиком, чтобы испортить его и проиграть
+  std::vector<uint8_t> wire;
+  {
+    LoopbackPair link;
+    ChannelMux near_end(link.m_a, mux_options);
+    ChannelMux far_end(link.m_b, mux_options);
+    Collector end(far_end.channel(4));
+    Collector tap(link.m_b);  // вызывается раньше far_end: он новее
+    for (size_t done = 0; done < SIZE; done += 100) {
+      for (uint8_t id = 1; id <= 3; ++id) {
+        auto bytes = pattern(100, id);
+        for (auto& byte : bytes) {
+          byte = static_cast<uint8_t>((byte & 0x3FU) | (id << 6U));
+        }
+        ASSERT_TRUE(near_end.channel(id).write({bytes.data(), 100}, 1s));
+        ASSERT_TRUE(near_end.channel(id).flush());
+      }
+    }
+    const uint8_t END = 0xEE;
+    ASSERT_TRUE(near_end.channel(4).write({&END, 1}, 1s));
+    ASSERT_TRUE(near_end.channel(4).flush());
+    ASSERT_TRUE(end.wait(1));
+    std::lock_guard lock(tap.m_mtx);
+    wire = tap.m_bytes;
+  }
+  // выпавшие байты сдвигают всё, что за ними; переворот портит на месте
+  for (size_t at = 1'000; at + 1'000 < wire.size(); at += 3'001) {
+    wire.erase(wire.begin() + static_cast<std::ptrdiff_t>(at));
+    wire[at + 1'500] ^= 0x41;
+  }
+
+  LoopbackOptions options;
+  options.m_max_chunk = 64;
+  options.m_random_chunks = true;
+  LoopbackPair link(options);
+  ChannelMux far_end(link.m_b, mux_options);
+  std::vector<std::unique_ptr<Collector>> collectors;
+  for (uint8_t id = 1; id <= 4; ++id) {
+    collectors.push_back(std::make_unique<Collector>(far_end.channel(id)));
+  }
+  ASSERT_TRUE(link.m_a.write({wire.data(), wire.size()}, 1s));
+  ASSERT_TRUE(collectors[3]->wait(1));
+
+  for (uint8_t id = 1; id <= 3; ++id) {
+    std::lock_guard lock(collectors[id - 1]->m_mtx);
+    const auto& bytes = collectors[id - 1]->m_bytes;
+    EXPECT_GT(bytes.size(), SIZE / 2) << "channel " << int{id};
+    EXPECT_LT(bytes.size(), SIZE) << "channel " << int{id};
+    EXPECT_TRUE(std::all_of(bytes.begin(), bytes.end(), [&](uint8_t byte) {
+      return byte >> 6U == id;
+    })) << "channel " << int{id};
+  }
+  EXPECT_GT(far_end.resyncs(), 0U);
+}
+
+/// @test The mux shares the caller's interface and never closes it.
+TEST(MuxTest, LeavesInnerInterfaceOpen) {
+  LoopbackPair link;
+  {
+    ChannelMux mux(link.m_a);
+    EXPECT_TRUE(mux.close());
+    EXPECT_FALSE(mux.is_open());
+    EXPECT_FALSE(mux.channel(1).write({nullptr, 0}, 1s));
+    EXPECT_TRUE(link.m_a.is_open());
+    EXPECT_TRUE(mux.open());
+    EXPECT_TRUE(mux.channel(1).is_open());
+  }
+  EXPECT_TRUE(link.m_a.is_open());
+}
+
+/**
+ * @test Latency of small control frames while another sender streams 1 MiB
+ * blocks: straight over the link each control frame waits behind a whole
+ * block, through the mux only behind one segment per busy channel.
+ */
+TEST(MuxTest, FairnessBenchmark) {
+  constexpr size_t BLOCK = 1U << 20U;
+  constexpr size_t CONTROLS = 50;
+  const auto BULK = pattern(BLOCK, 1);
+
+  std::printf("\n%-6s | %12s | %12s\n", "link", "mean us", "max us");
+  for (const bool MUX : {false, true}) {
+    LoopbackPair link;
+    std::optional<ChannelMux> near_end;
+    std::optional<ChannelMux> far_end;
+    std::atomic<size_t> control_bytes{0};
+    Delegate sink;
+    Delegate control;
+    if (MUX) {
+      near_end.emplace(link.m_a);
+      far_end.emplace(link.m_b);
+      sink = far_end->channel(1).add_receive_callback(
+          [](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {});
+      control = far_end->channel(2).add_receive_callback(
+          [&](CustomSpan<uint8_t> data, size_t& /*read*/) {
+            control_bytes += data.size();
+          });
+    } else {
+      // без мультиплексора нет заголовков: контрольные байты узнаём по
+      // маркеру, которого нет в объёмных данных
+      control = link.m_b.add_receive_callback(
+          [&](CustomSpan<uint8_t> data, size_t& /*read*/) {
+            control_bytes += std::count(data.begin(), data.end(), 0xEE);
+          });
+    }
+    IInterface& bulk_out = MUX ? static_cast<IInterface&>(near_end->channel(1))
+                               : link.m_a;
+    IInterface& control_out =
+        MUX ? static_cast<IInterface&>(near_end->channel(2)) : link.m_a;
+
+    std::atomic<bool> running{true};
+    std::thread bulk([&] {
+      // 0xEE — маркер контрольных кадров, в объёмных данных его нет
+      std::vector<uint8_t> bytes = BULK;
+      std::replace(bytes.begin(), bytes.end(), uint8_t{0xEE}, uint8_t{0});
+      while (running) {
+        bulk_out.write({bytes.data(), bytes.size()}, 1s);
+        bulk_out.flush();
+      }
+    });
+    std::this_thread::sleep_for(5ms);
+    const std::vector<uint8_t> MARK(16, 0xEE);
+    double total_us = 0;
+    double max_us = 0;
+    for (size_t i = 0; i < CONTROLS; ++i) {
+      const size_t EXPECTED = control_bytes + MARK.size();
+      const auto START = std::chrono::steady_clock::now();
+      EXPECT_TRUE(control_out.write({MARK.data(), MARK.size()}, 10s));
+      control_out.flush();
+      while (control_bytes < EXPECTED &&
+             std::chrono::steady_clock::now() - START < 10s) {
+        std::this_thread::yield();
+      }
+      const std::chrono::duration<double, std::micro> ELAPSED =
+          std::chrono::steady_clock::now() - START;
+      total_us += ELAPSED.count();
+      max_us = std::max(max_us, ELAPSED.count());
+    }
+    running = false;
+    bulk.join();
+    EXPECT_EQ(control_bytes.load(), CONTROLS * MARK.size());
+    std::printf("%-6s | %12.1f | %12.1f\n", MUX ? "mux" : "direct",
+                total_us / CONTROLS, max_us);
+  }
+}
+}  // namespace
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SharedMemory.hpp"
+#include "Socket.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace proto::interface::test;
+using namespace std::chrono_literals;
+
+auto wait_closed(IInterface& port) -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+  while (port.is_open()) {
+    if (std::chrono::steady_clock::now() > DEADLINE) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+TEST(SharedMemoryTest, WrapsAndBlocksOnFullRing) {
+  SharedMemoryInterface first;
+  const int FD = first.create(4096);
+  ASSERT_GE(FD, 0);
+  SharedMemoryInterface second;
+  ASSERT_TRUE(second.attach(FD));
+  ::close(FD);
+
+  Collector to_second(second);
+  Collector to_first(first);
+  const auto BYTES = pattern(100000);  // в 24 раза больше кольца
+  ASSERT_TRUE(first.write({BYTES.data(), BYTES.size()}, 2s));
+  ASSERT_TRUE(second.write({BYTES.data(), 100}, 1s));
+  ASSERT_TRUE(to_second.wait(BYTES.size()));
+  ASSERT_TRUE(to_first.wait(100));
+  EXPECT_EQ(to_second.m_bytes, BYTES);
+  EXPECT_EQ(to_first.m_bytes, std::vector<uint8_t>(BYTES.begin(),
+                                                   BYTES.begin() + 100));
+}
+
+TEST(SharedMemoryTest, NamedSegment) {
+  const std::string NAME = "protolib_shm_" + std::to_string(getpid());
+  SharedMemoryInterface first;
+  ASSERT_TRUE(first.create(NAME, 1024));
+  SharedMemoryInterface second;
+  ASSERT_TRUE(second.attach(NAME));
+  Collector received(second);
+  const auto BYTES = pattern(64);
+  ASSERT_TRUE(first.write({BYTES.data(), BYTES.size()}, 1s));
+  ASSERT_TRUE(received.wait(BYTES.size()));
+  EXPECT_EQ(received.m_bytes, BYTES);
+
+  first.close();
+  SharedMemoryInterface late;
+  EXPECT_FALSE(late.attach(NAME));  // создатель удалил сегмент
+}
+
+TEST(SharedMemoryTest, PeerCloseClosesOtherSide) {
+  SharedMemoryInterface first;
+  const int FD = first.create(1024);
+  ASSERT_GE(FD, 0);
+  SharedMemoryInterface second;
+  ASSERT_TRUE(second.attach(FD));
+  ::close(FD);
+  ASSERT_TRUE(first.is_open());
+  second.close();
+  EXPECT_TRUE(wait_closed(first));
+  EXPECT_FALSE(first.write({reinterpret_cast<const uint8_t*>("x"), 1}, 10ms));
+}
+
+/// @test close() from a receive callback returns at once and leaves the
+/// unmapping to the reader thread, which still touches the ring afterwards.
+TEST(SharedMemoryTest, CloseFromCallback) {
+  SharedMemoryInterface first;
+  const int FD = first.create(1024);
+  ASSERT_GE(FD, 0);
+  SharedMemoryInterface second;
+  ASSERT_TRUE(second.attach(FD));
+  ::close(FD);
+  std::atomic<size_t> calls{0};
+  auto closer = second.add_receive_callback(
+      [&](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+        ++calls;
+        EXPECT_TRUE(second.close());
+      });
+  const auto BYTES = pattern(512);
+  ASSERT_TRUE(first.write({BYTES.data(), BYTES.size()}, 1s));
+  EXPECT_TRUE(wait_closed(second));
+  EXPECT_TRUE(wait_closed(first));
+  EXPECT_EQ(calls, 1U);
+  EXPECT_TRUE(second.close());  // joins the reader, which has unmapped
+}
+
+TEST(SharedMemoryTest, WriteTimesOutWithoutReader) {
+  SharedMemoryInterface first;
+  const int FD = first.create(64);
+  ASSERT_GE(FD, 0);
+  ::close(FD);
+  const auto BYTES = pattern(128);
+  const auto START = std::chrono::steady_clock::now();
+  EXPECT_FALSE(first.write({BYTES.data(), BYTES.size()}, 50ms));
+  EXPECT_GE(std::chrono::steady_clock::now() - START, 50ms);
+}
+
+// Runs @p attach_and_echo in a forked child that echoes every byte back and
+// exits once the parent closes its side.
+auto fork_echo(const std::function<bool(IInterface*&)>& attach_and_echo)
+    -> pid_t {
+  const pid_t PID = fork();
+  if (PID == 0) {
+    IInterface* port = nullptr;
+    if (!attach_and_echo(port)) {
+      _exit(1);
+    }
+    auto echo = port->add_receive_callback(
+        [port](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          port->write(data, 5s);
+        });
+    while (port->is_open()) {
+      std::this_thread::sleep_for(10ms);
+    }
+    port->close();
+    _exit(0);
+  }
+  return PID;
+}
+
+/**
+ * @test Cross-process round trip of 64-byte messages and echoed throughput
+ * of 64 MiB in 4 KiB writes: a Unix socketpair against the shared-memory
+ * ring, both with a forked echo process on the other end.
+ */
+TEST(SharedMemoryBenchmark, CrossProcess) {
+  constexpr size_t ROUND_TRIPS = 10000;
+  constexpr size_t CHUNK = 4096;
+  constexpr size_t TOTAL = 64U << 20U;
+  const auto BYTES = pattern(CHUNK);
+
+  std::printf("\n%-8s | %10s | %10s\n", "link", "rtt us", "MiB/s");
+  for (const bool SHM : {false, true}) {
+    std::unique_ptr<IInterface> port;
+    pid_t child = -1;
+    if (SHM) {
+      auto ring = std::make_unique<SharedMemoryInterface>();
+      const int FD = ring->create(1U << 20U);
+      ASSERT_GE(FD, 0);
+      child = fork_echo([FD](IInterface*& peer) {
+        static SharedMemoryInterface shared;
+        peer = &shared;
+        return shared.attach(FD);
+      });
+      ::close(FD);
+      port = std::move(ring);
+    } else {
+      int pair[2];
+      ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair), 0);
+      child = fork_echo([&pair](IInterface*& peer) {
+        static StreamSocketInterface socket;
+        ::close(pair[0]);
+        peer = &socket;
+        return socket.adopt(pair[1]);
+      });
+      ::close(pair[1]);
+      auto socket = std::make_unique<StreamSocketInterface>();
+      ASSERT_TRUE(socket->adopt(pair[0]));
+      port = std::move(socket);
+    }
+    ASSERT_GT(child, 0);
+
+    std::atomic<size_t> received{0};
+    auto counter = port->add_receive_callback(
+        [&received](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          received += data.size();
+        });
+    // ожидание вращением: сон исказил бы задержку
+    auto wait_for = [&received](const size_t EXPECTED) {
+      const auto DEADLINE = std::chrono::steady_clock::now() + 10s;
+      while (received < EXPECTED) {
+        if (std::chrono::steady_clock::now() > DEADLINE) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    const auto RTT_START = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ROUND_TRIPS; ++i) {
+      ASSERT_TRUE(port->write({BYTES.data(), 64}, 1s));
+      ASSERT_TRUE(wait_for((i + 1) * 64));
+    }
+    const std::chrono::duration<double, std::micro> RTT =
+        std::chrono::steady_clock::now() - RTT_START;
+
+    received = 0;
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t sent = 0; sent < TOTAL; sent += CHUNK) {
+      ASSERT_TRUE(port->write({BYTES.data(), CHUNK}, 5s));
+    }
+    ASSERT_TRUE(wait_for(TOTAL));
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    std::printf("%-8s | %10.2f | %10.0f\n", SHM ? "shm" : "unix",
+                RTT.count() / ROUND_TRIPS,
+                static_cast<double>(TOTAL) / (1U << 20U) / ELAPSED.count());
+
+    port->close();
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+}
+}  // namespace
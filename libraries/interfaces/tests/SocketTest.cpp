@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Socket.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace proto::interface::test;
+using namespace std::chrono_literals;
+
+auto unix_path() -> std::string {
+  return "/tmp/protolib_socket_test_" + std::to_string(getpid());
+}
+
+// Sends 1 MiB each way through a connected pair and compares the bytes.
+void exchange(StreamSocketInterface& client, StreamSocketInterface& server) {
+  Collector at_server(server);
+  Collector at_client(client);
+  const auto DATA = pattern(1024 * 1024);
+  ASSERT_TRUE(client.write({DATA.data(), DATA.size()}, 5s));
+  ASSERT_TRUE(server.write({DATA.data(), DATA.size()}, 5s));
+  ASSERT_TRUE(at_server.wait(DATA.size()));
+  ASSERT_TRUE(at_client.wait(DATA.size()));
+  EXPECT_EQ(at_server.m_bytes, DATA);
+  EXPECT_EQ(at_client.m_bytes, DATA);
+}
+
+TEST(SocketTest, TcpExchange) {
+  StreamListener listener;
+  ASSERT_TRUE(listener.listen_tcp());
+  StreamSocketInterface client;
+  ASSERT_TRUE(client.connect_tcp("127.0.0.1", listener.port()));
+  StreamSocketInterface server;
+  ASSERT_TRUE(server.adopt(listener.accept(1s)));
+  exchange(client, server);
+}
+
+TEST(SocketTest, UnixExchange) {
+  StreamListener listener;
+  ASSERT_TRUE(listener.listen_unix(unix_path()));
+  StreamSocketInterface client;
+  ASSERT_TRUE(client.connect_unix(unix_path()));
+  StreamSocketInterface server;
+  ASSERT_TRUE(server.adopt(listener.accept(1s)));
+  exchange(client, server);
+}
+
+TEST(SocketTest, ReactorExchange) {
+  EpollReactor reactor;
+  StreamListener listener;
+  ASSERT_TRUE(listener.listen_tcp());
+  StreamSocketInterface client(reactor);
+  ASSERT_TRUE(client.connect_tcp("localhost", listener.port()));
+  StreamSocketInterface server(reactor);
+  ASSERT_TRUE(server.adopt(listener.accept(1s)));
+  exchange(client, server);
+}
+
+TEST(SocketTest, PeerCloseClosesInterface) {
+  for (const bool REACTOR : {false, true}) {
+    EpollReactor reactor;
+    StreamListener listener;
+    ASSERT_TRUE(listener.listen_tcp());
+    auto client = REACTOR ? std::make_unique<StreamSocketInterface>(reactor)
+                          : std::make_unique<StreamSocketInterface>();
+    ASSERT_TRUE(client->connect_tcp("127.0.0.1", listener.port()));
+    ::close(listener.accept(1s));
+
+    const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+    while (client->is_open() && std::chrono::steady_clock::now() < DEADLINE) {
+      std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_FALSE(client->is_open());
+  }
+}
+
+// The reactor closes the socket on EOF while the owner closes it too; only
+// one of them may release the descriptor.
+TEST(SocketTest, PeerCloseRacesOwnerClose) {
+  EpollReactor reactor;
+  StreamListener listener;
+  ASSERT_TRUE(listener.listen_tcp());
+  for (int i = 0; i < 200; ++i) {
+    StreamSocketInterface client(reactor);
+    ASSERT_TRUE(client.connect_tcp("127.0.0.1", listener.port()));
+    ::close(listener.accept(1s));
+    std::this_thread::sleep_for(std::chrono::microseconds(i % 50));
+    EXPECT_TRUE(client.close());
+    EXPECT_FALSE(client.is_open());
+  }
+  EXPECT_EQ(reactor.size(), 0U);
+}
+
+// close() from a receive callback returns at once; the destructor joins the
+// reader thread that ran it.
+TEST(SocketTest, CloseFromCallback) {
+  for (const bool REACTOR : {false, true}) {
+    EpollReactor reactor;
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+    std::atomic<size_t> calls{0};
+    {
+      auto socket = REACTOR ? std::make_unique<StreamSocketInterface>(reactor)
+                            : std::make_unique<StreamSocketInterface>();
+      auto& port = *socket;
+      auto closer = port.add_receive_callback(
+          [&](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+            ++calls;
+            EXPECT_TRUE(port.close());
+          });
+      ASSERT_TRUE(port.adopt(fds[0]));
+      const uint8_t BYTE = 0x42;
+      ASSERT_EQ(::write(fds[1], &BYTE, 1), 1);
+      const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+      while (port.is_open() && std::chrono::steady_clock::now() < DEADLINE) {
+        std::this_thread::sleep_for(1ms);
+      }
+      EXPECT_FALSE(port.is_open());
+    }
+    EXPECT_EQ(calls, 1U);
+    EXPECT_EQ(reactor.size(), 0U);
+    ::close(fds[1]);
+  }
+}
+
+TEST(SocketTest, ConnectFailsWithoutListener) {
+  StreamSocketInterface client;
+  EXPECT_FALSE(client.connect_unix(unix_path() + "_missing"));
+  EXPECT_FALSE(client.is_open());
+}
+}  // namespace
@@ -0,0 +1,80 @@
+/**
+ * @file TestHelpers.hpp
+ * @brief Receive collector and test data shared by the interface tests.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Interface.hpp"
+
+namespace proto::interface::test {
+
+/// @brief Records every chunk an interface hands to its receive callbacks.
+struct Collector {
+  std::mutex m_mtx;
+  std::vector<uint8_t> m_bytes;      //!< Received bytes in order.
+  std::vector<size_t> m_chunks;      //!< Size of every delivered chunk.
+  std::atomic<size_t> m_size{0};     //!< Bytes received so far.
+  std::atomic<size_t> m_count{0};    //!< Chunks received so far.
+  std::atomic<size_t> m_largest{0};  //!< Largest chunk so far.
+  Delegate m_delegate;
+
+  explicit Collector(IInterface& port) {
+    m_delegate = port.add_receive_callback(
+        [this](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          std::lock_guard lock(m_mtx);
+          m_bytes.insert(m_bytes.end(), data.begin(), data.end());
+          m_chunks.push_back(data.size());
+          m_largest = std::max(m_largest.load(), data.size());
+          m_size += data.size();
+          ++m_count;
+        });
+  }
+
+  /// @brief Wait until @p expected bytes arrived; false on timeout.
+  auto wait(const size_t EXPECTED,
+            const std::chrono::milliseconds TIMEOUT = std::chrono::seconds(5))
+      const -> bool {
+    return wait_for(m_size, EXPECTED, TIMEOUT);
+  }
+
+  /// @brief Wait until @p expected chunks arrived; false on timeout.
+  auto wait_chunks(const size_t EXPECTED,
+                   const std::chrono::milliseconds TIMEOUT =
+                       std::chrono::seconds(5)) const -> bool {
+    return wait_for(m_count, EXPECTED, TIMEOUT);
+  }
+
+ private:
+  static auto wait_for(const std::atomic<size_t>& value, const size_t EXPECTED,
+                       const std::chrono::milliseconds TIMEOUT) -> bool {
+    const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+    while (value < EXPECTED) {
+      if (std::chrono::steady_clock::now() > DEADLINE) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+  }
+};
+
+/// @brief @p size bytes that do not repeat with a short period; @p seed
+/// gives each stream its own content.
+inline auto pattern(const size_t SIZE, const uint8_t SEED = 0)
+    -> std::vector<uint8_t> {
+  std::vector<uint8_t> bytes(SIZE);
+  for (size_t i = 0; i < SIZE; ++i) {
+    bytes[i] = static_cast<uint8_t>(i * 7 + SEED + i / 251);
+  }
+  return bytes;
+}
+}  // namespace proto::interface::test
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <termios.h>
+
+#include <string>
+
+#include "Pty.hpp"
+#include "Termios2.hpp"
+#include "UartLinux.hpp"
+
+namespace {
+using namespace proto::interface;
+
+// Pseudo terminals accept any speed and report it back, which is enough to
+// check that the right termios call reached the driver.
+class UartBaudSuite : public testing::Test {
+ protected:
+  PtyMasterInterface pty_;
+  const std::string& slave_ = pty_.slave_path();
+  UartLinuxInterface uart_;
+
+  void TearDown() override { uart_.close(); }
+};
+
+TEST_F(UartBaudSuite, StandardHighRateUsesBconstant) {
+  const int FD = uart_.open_uart(slave_, 921600);
+  ASSERT_GE(FD, 0);
+  termios tty{};
+  ASSERT_EQ(tcgetattr(FD, &tty), 0);
+  EXPECT_EQ(cfgetospeed(&tty), B921600);
+  EXPECT_EQ(termios2::get_baudrate(FD), 921600);
+}
+
+TEST_F(UartBaudSuite, FourMegabaud) {
+  const int FD = uart_.open_uart(slave_, 4000000);
+  ASSERT_GE(FD, 0);
+  EXPECT_EQ(termios2::get_baudrate(FD), 4000000);
+}
+
+TEST_F(UartBaudSuite, ArbitraryRateUsesBother) {
+  const int FD = uart_.open_uart(slave_, 250000);
+  ASSERT_GE(FD, 0);
+  EXPECT_EQ(termios2::get_baudrate(FD), 250000);
+  termios tty{};
+  ASSERT_EQ(tcgetattr(FD, &tty), 0);
+  // raw mode set before the speed switch is kept
+  EXPECT_EQ(tty.c_lflag & ICANON, 0U);
+}
+
+TEST_F(UartBaudSuite, RejectsInvalidRate) {
+  EXPECT_LT(uart_.open_uart(slave_, 0), 0);
+  EXPECT_LT(uart_.open_uart(slave_, -9600), 0);
+  EXPECT_FALSE(uart_.is_open());
+}
+}  // namespace
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "EpollReactor.hpp"
+#include "Pty.hpp"
+#include "UartLinux.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace std::chrono_literals;
+
+// The pty master stands in for the device; the test writes into it.
+struct Port {
+  PtyMasterInterface m_pty;
+  std::unique_ptr<UartLinuxInterface> m_uart;
+  std::atomic<size_t> m_bytes{0};
+  std::atomic<size_t> m_reads{0};
+  Delegate m_delegate;
+
+  explicit Port(EpollReactor* reactor) {
+    m_uart = reactor != nullptr ? std::make_unique<UartLinuxInterface>(*reactor)
+                                : std::make_unique<UartLinuxInterface>();
+    m_delegate = m_uart->add_receive_callback(
+        [this](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          m_bytes += data.size();
+          ++m_reads;
+        });
+  }
+  auto open() -> bool {
+    return m_uart->open_uart(m_pty.slave_path(), 115200) >= 0;
+  }
+  void send(const std::vector<uint8_t>& data) {
+    ASSERT_TRUE(m_pty.write({data.data(), data.size()}, 10s));
+  }
+};
+
+auto wait_bytes(const std::vector<std::unique_ptr<Port>>& ports,
+                const size_t EXPECTED) -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + 10s;
+  for (const auto& port : ports) {
+    while (port->m_bytes < EXPECTED) {
+      if (std::chrono::steady_clock::now() > DEADLINE) {
+        return false;
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+  return true;
+}
+
+TEST(UartReactorTest, ServesManyPortsFromOneThread) {
+  EpollReactor reactor;
+  std::vector<std::unique_ptr<Port>> ports;
+  for (int i = 0; i < 8; ++i) {
+    ports.push_back(std::make_unique<Port>(&reactor));
+    ASSERT_TRUE(ports.back()->open());
+  }
+  EXPECT_EQ(reactor.size(), 8U);
+
+  const std::vector<uint8_t> DATA(4096, 0x5A);
+  for (auto& port : ports) {
+    port->send(DATA);
+  }
+  EXPECT_TRUE(wait_bytes(ports, DATA.size()));
+
+  for (auto& port : ports) {
+    port->m_uart->close();
+  }
+  EXPECT_EQ(reactor.size(), 0U);
+}
+
+TEST(UartReactorTest, HangUpClosesPort) {
+  EpollReactor reactor;
+  Port port(&reactor);
+  ASSERT_TRUE(port.open());
+  ASSERT_TRUE(port.m_uart->is_open());
+
+  port.m_pty.hang_up();
+  const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+  while (port.m_uart->is_open() &&
+         std::chrono::steady_clock::now() < DEADLINE) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_FALSE(port.m_uart->is_open());
+  EXPECT_EQ(reactor.size(), 0U);
+}
+
+TEST(UartReactorTest, RemoveWaitsForSelfRemovingHandler) {
+  EpollReactor reactor;
+  const int FD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  ASSERT_GE(FD, 0);
+  std::atomic<bool> entered{false};
+  std::atomic<bool> finished{false};
+  ASSERT_TRUE(reactor.add(FD, [&] {
+    reactor.remove(FD);  // as a port closing itself on hang-up
+    entered = true;
+    std::this_thread::sleep_for(100ms);
+    finished = true;
+  }));
+  const uint64_t ONE = 1;
+  ASSERT_EQ(::write(FD, &ONE, sizeof(ONE)), sizeof(ONE));
+  while (!entered) {
+    std::this_thread::sleep_for(1ms);
+  }
+  reactor.remove(FD);
+  EXPECT_TRUE(finished);
+  ::close(FD);
+}
+
+TEST(UartReactorTest, ThreadedModeStillWorks) {
+  std::vector<std::unique_ptr<Port>> ports;
+  ports.push_back(std::make_unique<Port>(nullptr));
+  ASSERT_TRUE(ports.back()->open());
+  const std::vector<uint8_t> DATA(1024, 0xA5);
+  ports.back()->send(DATA);
+  EXPECT_TRUE(wait_bytes(ports, DATA.size()));
+}
+
+struct Usage {
+  double m_cpu_ms;
+  long m_switches;
+};
+
+auto usage() -> Usage {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  const auto TO_MS = [](const timeval& VAL) {
+    return static_cast<double>(VAL.tv_sec) * 1e3 +
+           static_cast<double>(VAL.tv_usec) / 1e3;
+  };
+  return {TO_MS(usage.ru_utime) + TO_MS(usage.ru_stime),
+          usage.ru_nvcsw + usage.ru_nivcsw};
+}
+
+// Receive-side syscalls so far; see IdleAndLoadBenchmark.
+auto syscalls(const std::vector<std::unique_ptr<Port>>& ports,
+              const EpollReactor* reactor) -> uint64_t {
+  uint64_t calls = 0;
+  for (const auto& port : ports) {
+    const auto SNAP = port->m_uart->stats().snapshot();
+    calls += SNAP.m_read_calls + SNAP.m_write_calls;
+    if (reactor == nullptr) {
+      calls += SNAP.m_read_calls;  // poll() before every read
+    }
+  }
+  if (reactor != nullptr) {
+    calls += reactor->wait_calls() + reactor->eventfd_calls();
+  }
+  return calls;
+}
+
+/**
+ * @test 32 ports served by 32 reader threads versus one reactor. Reports CPU
+ * time and context switches for one idle second, then callbacks, receive
+ * syscalls and context switches per KiB while every port receives 64 KiB.
+ *
+ * Receive syscalls are the ports' read() and write() calls (EAGAIN
+ * included) plus, for the reactor, its epoll_wait() and eventfd calls. A
+ * reader thread polls once before every read, so its poll() calls are
+ * counted as one per read; poll timeouts are left out.
+ */
+TEST(UartReactorTest, IdleAndLoadBenchmark) {
+  constexpr size_t PORTS = 32;
+  constexpr size_t BYTES = 64 * 1024;
+  constexpr size_t CHUNK = 64;
+  std::printf("\n%-8s | %12s %12s | %10s %13s %12s %10s\n", "mode",
+              "idle cpu ms", "idle ctxsw", "reads/KiB", "syscalls/KiB",
+              "ctxsw/KiB", "load cpu ms");
+
+  for (const bool REACTOR : {false, true}) {
+    std::unique_ptr<EpollReactor> reactor;
+    if (REACTOR) {
+      reactor = std::make_unique<EpollReactor>();
+    }
+    std::vector<std::unique_ptr<Port>> ports;
+    for (size_t i = 0; i < PORTS; ++i) {
+      ports.push_back(std::make_unique<Port>(reactor.get()));
+      ASSERT_TRUE(ports.back()->open());
+    }
+    std::this_thread::sleep_for(100ms);
+
+    const auto IDLE_START = usage();
+    std::this_thread::sleep_for(1s);
+    const auto IDLE_END = usage();
+
+    const std::vector<uint8_t> DATA(CHUNK, 0x42);
+    const auto CALLS_START = syscalls(ports, reactor.get());
+    const auto LOAD_START = usage();
+    std::vector<std::thread> writers;
+    for (auto& port : ports) {
+      writers.emplace_back([&port, &DATA] {
+        for (size_t sent = 0; sent < BYTES; sent += DATA.size()) {
+          port->send(DATA);
+        }
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    ASSERT_TRUE(wait_bytes(ports, BYTES));
+    const auto LOAD_END = usage();
+    const auto CALLS = syscalls(ports, reactor.get()) - CALLS_START;
+
+    size_t reads = 0;
+    for (auto& port : ports) {
+      reads += port->m_reads;
+    }
+    const double KIB = static_cast<double>(PORTS * BYTES) / 1024.0;
+    std::printf("%-8s | %12.1f %12ld | %10.2f %13.2f %12.2f %10.1f\n",
+                REACTOR ? "reactor" : "threads",
+                IDLE_END.m_cpu_ms - IDLE_START.m_cpu_ms,
+                IDLE_END.m_switches - IDLE_START.m_switches,
+                static_cast<double>(reads) / KIB,
+                static_cast<double>(CALLS) / KIB,
+                static_cast<double>(LOAD_END.m_switches -
+                                    LOAD_START.m_switches) /
+                    KIB,
+                LOAD_END.m_cpu_ms - LOAD_START.m_cpu_ms);
+    for (auto& port : ports) {
+      port->m_uart->close();
+    }
+  }
+}
+}  // namespace
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Pty.hpp"
+#include "UartLinux.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace std::chrono_literals;
+
+// Port opened on the slave side of a pty; the master side plays the device.
+struct Reader {
+  PtyMasterInterface m_pty;
+  UartLinuxInterface m_uart;
+  std::atomic<size_t> m_bytes{0};
+  std::atomic<size_t> m_reads{0};
+  std::atomic<size_t> m_largest{0};
+  Delegate m_delegate;
+
+  Reader() {
+    m_delegate = m_uart.add_receive_callback(
+        [this](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          m_bytes += data.size();
+          ++m_reads;
+          m_largest = std::max<size_t>(m_largest, data.size());
+        });
+  }
+  ~Reader() { m_uart.close(); }
+  Reader(const Reader&) = delete;
+  auto operator=(const Reader&) -> Reader& = delete;
+
+  auto open(const UartReadProfile& profile) -> bool {
+    m_uart.set_read_profile(profile);
+    return m_uart.open_uart(m_pty.slave_path(), 115200) >= 0;
+  }
+  void send(const uint8_t* data, const size_t SIZE) {
+    ASSERT_TRUE(m_pty.write({data, SIZE}, 5s));
+  }
+  auto wait_bytes(const size_t EXPECTED) const -> bool {
+    const auto DEADLINE = std::chrono::steady_clock::now() + 5s;
+    while (m_bytes < EXPECTED) {
+      if (std::chrono::steady_clock::now() > DEADLINE) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+};
+
+TEST(UartReadTest, BufferSizeLimitsChunk) {
+  Reader reader;
+  ASSERT_TRUE(reader.open(UartReadProfile::low_latency()));
+  const std::vector<uint8_t> DATA(1000, 0x11);
+  reader.send(DATA.data(), DATA.size());
+  ASSERT_TRUE(reader.wait_bytes(DATA.size()));
+  EXPECT_LE(reader.m_largest, 64U);
+}
+
+TEST(UartReadTest, ThroughputDeliversPartialBatch) {
+  Reader reader;
+  ASSERT_TRUE(reader.open(UartReadProfile::throughput()));
+  const std::array<uint8_t, 16> FRAME{};
+  reader.send(FRAME.data(), FRAME.size());
+  ASSERT_TRUE(reader.wait_bytes(FRAME.size()));
+  EXPECT_EQ(reader.m_reads, 1U);
+}
+
+TEST(UartReadTest, OverridesApply) {
+  auto profile = UartReadProfile::throughput();
+  profile.m_buffer_size = 100;
+  Reader reader;
+  ASSERT_TRUE(reader.open(profile));
+  const std::vector<uint8_t> DATA(1000, 0x22);
+  reader.send(DATA.data(), DATA.size());
+  ASSERT_TRUE(reader.wait_bytes(DATA.size()));
+  EXPECT_LE(reader.m_largest, 100U);
+}
+
+/**
+ * @test Per-frame latency (16-byte frames sent one at a time, each waited
+ * for) and bulk throughput (4 MiB in 256-byte writes) for every profile on a
+ * pty pair. On a pty ASYNC_LOW_LATENCY is unsupported, so low-latency differs
+ * from the default only by its smaller buffer and VTIME.
+ */
+TEST(UartReadTest, ProfileBenchmark) {
+  constexpr size_t FRAMES = 500;
+  constexpr size_t FRAME = 16;
+  constexpr size_t BULK = 4 * 1024 * 1024;
+  constexpr size_t CHUNK = 256;
+  struct Mode {
+    const char* m_name;
+    UartReadProfile m_profile;
+  };
+  const std::array<Mode, 3> MODES{{
+      {"default", UartReadProfile{}},
+      {"low-latency", UartReadProfile::low_latency()},
+      {"throughput", UartReadProfile::throughput()},
+  }};
+
+  std::printf("\n%-12s | %14s | %10s %12s\n", "profile", "frame lat us",
+              "MiB/s", "reads/MiB");
+  for (const auto& MODE : MODES) {
+    Reader run;
+    ASSERT_TRUE(run.open(MODE.m_profile));
+
+    const std::array<uint8_t, FRAME> DATA{};
+    const auto LAT_START = std::chrono::steady_clock::now();
+    for (size_t i = 1; i <= FRAMES; ++i) {
+      run.send(DATA.data(), DATA.size());
+      ASSERT_TRUE(run.wait_bytes(i * FRAME));
+    }
+    const std::chrono::duration<double, std::micro> LATENCY =
+        std::chrono::steady_clock::now() - LAT_START;
+
+    const size_t BASE = run.m_bytes;
+    const size_t BASE_READS = run.m_reads;
+    const std::vector<uint8_t> CHUNK_DATA(CHUNK, 0x33);
+    const auto BULK_START = std::chrono::steady_clock::now();
+    for (size_t sent = 0; sent < BULK; sent += CHUNK) {
+      run.send(CHUNK_DATA.data(), CHUNK_DATA.size());
+    }
+    ASSERT_TRUE(run.wait_bytes(BASE + BULK));
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - BULK_START;
+    constexpr double MIB = static_cast<double>(BULK) / (1024.0 * 1024.0);
+    std::printf("%-12s | %14.1f | %10.1f %12.1f\n", MODE.m_name,
+                LATENCY.count() / FRAMES, MIB / ELAPSED.count(),
+                static_cast<double>(run.m_reads - BASE_READS) / MIB);
+  }
+}
+}  // namespace
@@ -0,0 +1,362 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <pty.h>
+#include <sys/resource.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Pty.hpp"
+#include "Socket.hpp"
+#include "UartLinux.hpp"
+#include "UringReactor.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace std::chrono_literals;
+
+// The pty master stands in for the device, as in UartReactorTest.
+struct Port {
+  PtyMasterInterface m_pty;
+  std::unique_ptr<UartLinuxInterface> m_uart;
+  std::atomic<size_t> m_bytes{0};
+  std::atomic<size_t> m_reads{0};
+  Delegate m_delegate;
+
+  template <typename Reactor>
+  explicit Port(Reactor* reactor) {
+    m_uart = reactor != nullptr ? std::make_unique<UartLinuxInterface>(*reactor)
+                                : std::make_unique<UartLinuxInterface>();
+    subscribe();
+  }
+  explicit Port(std::unique_ptr<UartLinuxInterface> uart)
+      : m_uart(std::move(uart)) {
+    subscribe();
+  }
+  void subscribe() {
+    m_delegate = m_uart->add_receive_callback(
+        [this](CustomSpan<uint8_t> data, size_t& /*read*/) {
+          m_bytes += data.size();
+          ++m_reads;
+        });
+  }
+  auto open() -> bool {
+    return m_uart->open_uart(m_pty.slave_path(), 115200) >= 0;
+  }
+  void send(const std::vector<uint8_t>& data) {
+    ASSERT_TRUE(m_pty.write({data.data(), data.size()}, 10s));
+  }
+};
+
+auto wait_for(const std::atomic<size_t>& value, const size_t EXPECTED)
+    -> bool {
+  const auto DEADLINE = std::chrono::steady_clock::now() + 10s;
+  while (value < EXPECTED) {
+    if (std::chrono::steady_clock::now() > DEADLINE) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+auto wait_bytes(const std::vector<std::unique_ptr<Port>>& ports,
+                const size_t EXPECTED) -> bool {
+  for (const auto& port : ports) {
+    if (!wait_for(port->m_bytes, EXPECTED)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#define SKIP_WITHOUT_URING()                                   \
+  if (!UringReactor::is_supported()) {                         \
+    GTEST_SKIP() << "io_uring is not available on this kernel"; \
+  }
+
+TEST(UartUringTest, ServesManyPortsFromOneRing) {
+  SKIP_WITHOUT_URING();
+  UringReactor reactor;
+  std::vector<std::unique_ptr<Port>> ports;
+  for (int i = 0; i < 8; ++i) {
+    ports.push_back(std::make_unique<Port>(&reactor));
+    ASSERT_TRUE(ports.back()->open());
+  }
+  EXPECT_EQ(reactor.size(), 8U);
+
+  const std::vector<uint8_t> DATA(4096, 0x5A);
+  for (auto& port : ports) {
+    port->send(DATA);
+  }
+  EXPECT_TRUE(wait_bytes(ports, DATA.size()));
+
+  for (auto& port : ports) {
+    port->m_uart->close();
+  }
+  EXPECT_EQ(reactor.size(), 0U);
+}
+
+TEST(UartUringTest, WritesLeaveAtFlushInOrder) {
+  SKIP_WITHOUT_URING();
+  UringReactor reactor;
+  Port port(&reactor);
+  ASSERT_TRUE(port.open());
+
+  std::mutex mtx;
+  std::vector<uint8_t> seen;
+  std::atomic<size_t> count{0};
+  auto device = port.m_pty.add_receive_callback(
+      [&](CustomSpan<uint8_t> data, size_t& /*read*/) {
+        std::lock_guard lock(mtx);
+        seen.insert(seen.end(), data.begin(), data.end());
+        count += data.size();
+      });
+  ASSERT_TRUE(port.m_pty.open());
+
+  // more than one slot per write, several writes per flush
+  std::vector<uint8_t> sent;
+  for (int frame = 0; frame < 16; ++frame) {
+    std::vector<uint8_t> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<uint8_t>(frame * 31 + i);
+    }
+    ASSERT_TRUE(port.m_uart->write({data.data(), data.size()}, 1s));
+    sent.insert(sent.end(), data.begin(), data.end());
+    if (frame % 4 == 3) {
+      ASSERT_TRUE(port.m_uart->flush());
+    }
+  }
+  ASSERT_TRUE(wait_for(count, sent.size()));
+  std::lock_guard lock(mtx);
+  EXPECT_EQ(seen, sent);
+}
+
+TEST(UartUringTest, HangUpClosesPort) {
+  SKIP_WITHOUT_URING();
+  UringReactor reactor;
+  Port port(&reactor);
+  ASSERT_TRUE(port.open());
+  ASSERT_TRUE(port.m_uart->is_open());
+
+  port.m_pty.hang_up();
+  const auto DEADLINE = std::chrono::steady_clock::now() + 2s;
+  while (port.m_uart->is_open() &&
+         std::chrono::steady_clock::now() < DEADLINE) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_FALSE(port.m_uart->is_open());
+  EXPECT_EQ(reactor.size(), 0U);
+}
+
+TEST(UartUringTest, SocketExchange) {
+  SKIP_WITHOUT_URING();
+  UringReactor reactor;
+  StreamListener listener;
+  ASSERT_TRUE(listener.listen_tcp());
+  StreamSocketInterface client(reactor);
+  ASSERT_TRUE(client.connect_tcp("127.0.0.1", listener.port()));
+  StreamSocketInterface server(reactor);
+  ASSERT_TRUE(server.adopt(listener.accept(1s)));
+
+  std::mutex mtx;
+  std::vector<uint8_t> echoed;
+  std::atomic<size_t> count{0};
+  auto echo = server.add_receive_callback(
+      [&server](CustomSpan<uint8_t> data, size_t& /*read*/) {
+        server.write(data, 0ms);  // из обработчика: без ожидания слотов
+        server.flush();
+      });
+  auto sink = client.add_receive_callback(
+      [&](CustomSpan<uint8_t> data, size_t& /*read*/) {
+        std::lock_guard lock(mtx);
+        echoed.insert(echoed.end(), data.begin(), data.end());
+        count += data.size();
+      });
+
+  std::vector<uint8_t> data(256 * 1024);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + i / 251);
+  }
+  for (size_t sent = 0; sent < data.size(); sent += 16 * 1024) {
+    ASSERT_TRUE(client.write({data.data() + sent, 16 * 1024}, 5s));
+    ASSERT_TRUE(client.flush());
+    ASSERT_TRUE(wait_for(count, sent + 16 * 1024));
+  }
+  std::lock_guard lock(mtx);
+  EXPECT_EQ(echoed, data);
+}
+
+TEST(UartUringTest, RemoveRestoresDescriptorFlags) {
+  SKIP_WITHOUT_URING();
+  UringReactor reactor;
+  PtyMasterInterface pty;
+  const int FLAGS = fcntl(pty.fd(), F_GETFL);
+  ASSERT_NE(FLAGS & O_NONBLOCK, 0);
+
+  ASSERT_TRUE(reactor.add(pty.fd(), [](CustomSpan<uint8_t> /*data*/) {}));
+  EXPECT_EQ(fcntl(pty.fd(), F_GETFL) & O_NONBLOCK, 0);
+  reactor.remove(pty.fd());
+  EXPECT_EQ(fcntl(pty.fd(), F_GETFL), FLAGS);
+}
+
+/**
+ * @test While nobody reads the other side of a port the reactor stays idle,
+ * even with the descriptor switched back to non-blocking, and every byte
+ * arrives in order once the reader catches up.
+ */
+TEST(UartUringTest, StalledWriteWaitsForSpace) {
+  SKIP_WITHOUT_URING();
+  UringReactor reactor;
+  termios raw{};
+  cfmakeraw(&raw);
+  int master = -1;
+  int slave = -1;
+  ASSERT_EQ(openpty(&master, &slave, nullptr, &raw, nullptr), 0);
+  ASSERT_TRUE(reactor.add(master, [](CustomSpan<uint8_t> /*data*/) {}));
+  // as if the owner made the descriptor non-blocking behind the reactor
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+  std::vector<uint8_t> data(256 * 1024);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + i / 251);
+  }
+  ASSERT_TRUE(reactor.write(master, {data.data(), data.size()}, 1s));
+  ASSERT_TRUE(reactor.submit());
+  std::this_thread::sleep_for(100ms);
+  const uint64_t BEFORE = reactor.enter_calls();
+  std::this_thread::sleep_for(200ms);
+  EXPECT_LT(reactor.enter_calls() - BEFORE, 10U);
+
+  std::vector<uint8_t> received;
+  std::vector<uint8_t> chunk(4096);
+  while (received.size() < data.size()) {
+    const ssize_t COUNT = ::read(slave, chunk.data(), chunk.size());
+    ASSERT_GT(COUNT, 0);
+    received.insert(received.end(), chunk.begin(), chunk.begin() + COUNT);
+  }
+  EXPECT_EQ(received, data);
+  reactor.remove(master);
+  ::close(slave);
+  ::close(master);
+}
+
+TEST(UartUringTest, AutoReactorPicksBackend) {
+  AutoReactor preferred;
+  EXPECT_EQ(preferred.uses_uring(), UringReactor::is_supported());
+  AutoReactor forced(false);
+  EXPECT_FALSE(forced.uses_uring());
+
+  for (AutoReactor* reactor : {&preferred, &forced}) {
+    Port port(reactor->make<UartLinuxInterface>());
+    ASSERT_TRUE(port.open());
+    port.send(std::vector<uint8_t>(512, 0x33));
+    EXPECT_TRUE(wait_for(port.m_bytes, 512));
+  }
+}
+
+struct Usage {
+  double m_cpu_ms;
+  long m_switches;
+};
+
+auto usage() -> Usage {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  const auto TO_MS = [](const timeval& VAL) {
+    return static_cast<double>(VAL.tv_sec) * 1e3 +
+           static_cast<double>(VAL.tv_usec) / 1e3;
+  };
+  return {TO_MS(usage.ru_utime) + TO_MS(usage.ru_stime),
+          usage.ru_nvcsw + usage.ru_nivcsw};
+}
+
+/**
+ * @test 32 ports receiving 64 KiB each and sending a 64-byte frame per
+ * received chunk, served by reader threads, by EpollReactor and by
+ * UringReactor. Reports callbacks and context switches per KiB, CPU time
+ * and, for io_uring, io_uring_enter() calls per KiB.
+ */
+TEST(UartUringTest, ThreadsEpollUringBenchmark) {
+  constexpr size_t PORTS = 32;
+  constexpr size_t BYTES = 64 * 1024;
+  constexpr size_t CHUNK = 64;
+  std::printf("\n%-8s | %10s %12s %10s %12s\n", "mode", "reads/KiB",
+              "ctxsw/KiB", "cpu ms", "enter/KiB");
+
+  enum class Mode { THREADS, EPOLL, URING };
+  for (const auto MODE : {Mode::THREADS, Mode::EPOLL, Mode::URING}) {
+    if (MODE == Mode::URING && !UringReactor::is_supported()) {
+      continue;
+    }
+    auto epoll =
+        MODE == Mode::EPOLL ? std::make_unique<EpollReactor>() : nullptr;
+    auto uring =
+        MODE == Mode::URING ? std::make_unique<UringReactor>() : nullptr;
+    std::vector<std::unique_ptr<Port>> ports;
+    for (size_t i = 0; i < PORTS; ++i) {
+      if (uring) {
+        ports.push_back(std::make_unique<Port>(uring.get()));
+      } else {
+        ports.push_back(std::make_unique<Port>(epoll.get()));
+      }
+      ASSERT_TRUE(ports.back()->open());
+      ASSERT_TRUE(ports.back()->m_pty.open());  // устройство вычитывает ответы
+    }
+    // ответ на каждый принятый кусок: проверяет и путь записи
+    const std::vector<uint8_t> REPLY(CHUNK, 0x24);
+    std::vector<Delegate> replies;
+    for (auto& port : ports) {
+      auto* uart = port->m_uart.get();
+      replies.push_back(uart->add_receive_callback(
+          [uart, &REPLY](CustomSpan<uint8_t> /*data*/, size_t& /*read*/) {
+            uart->write({REPLY.data(), REPLY.size()}, 0ms);
+            uart->flush();
+          }));
+    }
+    std::this_thread::sleep_for(100ms);
+
+    const std::vector<uint8_t> DATA(CHUNK, 0x42);
+    const auto START = usage();
+    const uint64_t ENTERS = uring ? uring->enter_calls() : 0;
+    std::vector<std::thread> writers;
+    for (auto& port : ports) {
+      writers.emplace_back([&port, &DATA] {
+        for (size_t sent = 0; sent < BYTES; sent += DATA.size()) {
+          port->send(DATA);
+        }
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    ASSERT_TRUE(wait_bytes(ports, BYTES));
+    const auto END = usage();
+
+    size_t reads = 0;
+    for (auto& port : ports) {
+      reads += port->m_reads;
+    }
+    const double KIB = static_cast<double>(PORTS * BYTES) / 1024.0;
+    const char* NAME = MODE == Mode::THREADS ? "threads"
+                       : MODE == Mode::EPOLL ? "epoll"
+                                             : "uring";
+    std::printf("%-8s | %10.2f %12.2f %10.1f %12.2f\n", NAME,
+                static_cast<double>(reads) / KIB,
+                static_cast<double>(END.m_switches - START.m_switches) / KIB,
+                END.m_cpu_ms - START.m_cpu_ms,
+                uring ? static_cast<double>(uring->enter_calls() - ENTERS) / KIB
+                      : 0.0);
+    for (auto& port : ports) {
+      port->m_uart->close();
+    }
+  }
+}
+}  // namespace
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Pty.hpp"
+#include "UartLinux.hpp"
+
+namespace {
+using namespace proto::interface;
+using namespace std::chrono_literals;
+
+class UartWriteSuite : public testing::Test {
+ protected:
+  // Closed, so the test reads the master descriptor itself.
+  PtyMasterInterface pty_;
+  const int master_ = pty_.fd();
+  UartLinuxInterface uart_;
+
+  void SetUp() override {
+    ASSERT_GE(uart_.open_uart(pty_.slave_path(), 115200), 0);
+  }
+  void TearDown() override { uart_.close(); }
+
+  // Bytes that reached the master side within @p TIMEOUT.
+  auto drain_master(const std::chrono::milliseconds TIMEOUT) const -> size_t {
+    size_t total = 0;
+    std::array<uint8_t, 256> buffer{};
+    pollfd pfd{master_, POLLIN, 0};
+    while (poll(&pfd, 1, static_cast<int>(TIMEOUT.count())) > 0) {
+      const ssize_t COUNT = ::read(master_, buffer.data(), buffer.size());
+      if (COUNT <= 0) {
+        break;
+      }
+      total += static_cast<size_t>(COUNT);
+    }
+    return total;
+  }
+};
+
+TEST_F(UartWriteSuite, CoalescedBytesWaitForFlush) {
+  uart_.set_coalescing(64);
+  std::array<uint8_t, 4> field{1, 2, 3, 4};
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(uart_.write({field.data(), field.size()}, 10ms));
+  }
+  EXPECT_EQ(drain_master(20ms), 0U);
+  ASSERT_TRUE(uart_.flush());
+  EXPECT_EQ(drain_master(100ms), 20U);
+}
+
+TEST_F(UartWriteSuite, FullBufferIsWrittenOut) {
+  uart_.set_coalescing(8);
+  std::array<uint8_t, 6> field{};
+  ASSERT_TRUE(uart_.write({field.data(), field.size()}, 10ms));
+  ASSERT_TRUE(uart_.write({field.data(), field.size()}, 10ms));
+  EXPECT_EQ(drain_master(100ms), 6U);
+
+  // larger than the buffer: goes straight to the descriptor
+  std::array<uint8_t, 32> large{};
+  ASSERT_TRUE(uart_.write({large.data(), large.size()}, 10ms));
+  EXPECT_EQ(drain_master(100ms), 38U);
+}
+
+/**
+ * @test With the tty's output queue full, a write that needs room fails
+ * within its own timeout, and the buffered bytes are neither lost nor sent
+ * twice: once the reader catches up, flush() delivers exactly them.
+ */
+TEST_F(UartWriteSuite, UnsentBytesStayBuffered) {
+  uart_.set_drain_policy(DrainPolicy::NEVER);
+  uart_.set_coalescing(64);
+  // второй дескриптор забивает очередь tty, пока никто не читает master
+  const int FILLER = ::open(pty_.slave_path().c_str(), O_WRONLY | O_NONBLOCK);
+  ASSERT_GE(FILLER, 0);
+  std::array<uint8_t, 1024> chunk{};
+  size_t filled = 0;
+  ssize_t count = 0;
+  while ((count = ::write(FILLER, chunk.data(), chunk.size())) > 0) {
+    filled += static_cast<size_t>(count);
+  }
+  ::close(FILLER);
+
+  std::array<uint8_t, 40> field{};
+  ASSERT_TRUE(uart_.write({field.data(), field.size()}, 10ms));
+  const auto START = std::chrono::steady_clock::now();
+  EXPECT_FALSE(uart_.write({field.data(), field.size()}, 10ms));
+  EXPECT_LT(std::chrono::steady_clock::now() - START, 500ms);
+
+  const size_t BEFORE_FLUSH = drain_master(100ms);
+  ASSERT_TRUE(uart_.flush());
+  EXPECT_EQ(BEFORE_FLUSH + drain_master(100ms), filled + field.size());
+}
+
+TEST_F(UartWriteSuite, DeadlineFlushesWithoutFlushCall) {
+  uart_.set_coalescing(64, 2ms);
+  std::array<uint8_t, 10> field{};
+  ASSERT_TRUE(uart_.write({field.data(), field.size()}, 10ms));
+  EXPECT_EQ(drain_master(500ms), 10U);
+}
+
+TEST_F(UartWriteSuite, CloseWritesPendingBytes) {
+  uart_.set_coalescing(64);
+  std::array<uint8_t, 12> field{};
+  ASSERT_TRUE(uart_.write({field.data(), field.size()}, 10ms));
+  uart_.close();
+  EXPECT_EQ(drain_master(100ms), 12U);
+}
+
+TEST_F(UartWriteSuite, EveryDrainPolicyDeliversBytes) {
+  std::array<uint8_t, 16> field{};
+  for (const auto POLICY :
+       {DrainPolicy::NEVER, DrainPolicy::PER_FRAME, DrainPolicy::PER_WRITE}) {
+    uart_.set_drain_policy(POLICY);
+    ASSERT_TRUE(uart_.write({field.data(), field.size()}, 10ms));
+    ASSERT_TRUE(uart_.flush());
+    EXPECT_EQ(drain_master(100ms), field.size());
+  }
+}
+
+/**
+ * @test Frames per second over a pty loopback. A frame is five field writes
+ * followed by flush(), the way TxContainer emits a packet; a reader thread
+ * keeps the master side empty.
+ */
+TEST_F(UartWriteSuite, FrameRateBenchmark) {
+  constexpr size_t FRAMES = 20000;
+  struct Mode {
+    const char* m_name;
+    DrainPolicy m_policy;
+    size_t m_capacity;
+  };
+  constexpr std::array<Mode, 4> MODES{{
+      {"per-write", DrainPolicy::PER_WRITE, 0},
+      {"per-frame", DrainPolicy::PER_FRAME, 0},
+      {"never", DrainPolicy::NEVER, 0},
+      {"coalesced", DrainPolicy::NEVER, 256},
+  }};
+  const std::array<size_t, 5> FIELDS{1, 1, 2, 16, 2};
+  std::array<uint8_t, 16> bytes{};
+
+  std::printf("\n%-10s | %12s\n", "mode", "frames/s");
+  for (const auto& MODE : MODES) {
+    uart_.set_drain_policy(MODE.m_policy);
+    uart_.set_coalescing(MODE.m_capacity);
+
+    std::atomic<bool> done{false};
+    std::thread reader([this, &done] {
+      while (!done) {
+        drain_master(1ms);
+      }
+    });
+    const auto START = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < FRAMES; ++frame) {
+      for (const auto SIZE : FIELDS) {
+        uart_.write({bytes.data(), SIZE}, 100ms);
+      }
+      uart_.flush();
+    }
+    const std::chrono::duration<double> ELAPSED =
+        std::chrono::steady_clock::now() - START;
+    done = true;
+    reader.join();
+    std::printf("%-10s | %12.0f\n", MODE.m_name,
+                static_cast<double>(FRAMES) / ELAPSED.count());
+  }
+}
+}  // namespace
@@ -0,0 +1,107 @@
+#include "Pty.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <stdexcept>
+
+namespace proto::interface {
+
+PtyMasterInterface::PtyMasterInterface() : IInterface("pty master interface") {
+  char name[64]{};
+  if (openpty(&master_, &slave_, name, nullptr, nullptr) != 0) {
+    throw std::runtime_error("PtyMasterInterface: openpty failed");
+  }
+  slave_path_ = name;
+  fcntl(master_, F_SETFL, fcntl(master_, F_GETFL) | O_NONBLOCK);
+}
+
+PtyMasterInterface::~PtyMasterInterface() {
+  hang_up();
+  ::close(slave_);
+}
+
+void PtyMasterInterface::hang_up() {
+  close();
+  std::lock_guard lock(write_mtx_);
+  if (master_ >= 0) {
+    ::close(master_);
+    master_ = -1;
+  }
+}
+
+auto PtyMasterInterface::write(const CustomSpan<uint8_t> BUFFER,
+                               const std::chrono::milliseconds TIMEOUT)
+    -> bool {
+  std::lock_guard lock(write_mtx_);
+  const auto DEADLINE = std::chrono::steady_clock::now() + TIMEOUT;
+  size_t done = 0;
+  while (done < BUFFER.size()) {
+    const ssize_t WRITTEN =
+        ::write(master_, BUFFER.data() + done, BUFFER.size() - done);
+    if (WRITTEN > 0) {
+      done += static_cast<size_t>(WRITTEN);
+      continue;
+    }
+    if (WRITTEN < 0 && errno == EINTR) {
+      continue;
+    }
+    if (WRITTEN < 0 && errno != EAGAIN) {
+      return false;
+    }
+    // очередь ввода tty заполнена: ждём, пока порт её вычитает
+    const auto LEFT = std::chrono::duration_cast<std::chrono::milliseconds>(
+        DEADLINE - std::chrono::steady_clock::now());
+    pollfd pfd{master_, POLLOUT, 0};
+    if (LEFT.count() <= 0 ||
+        poll(&pfd, 1, static_cast<int>(LEFT.count())) <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto PtyMasterInterface::is_open() -> bool { return is_open_; }
+
+auto PtyMasterInterface::open() -> bool {
+  if (master_ < 0) {
+    return false;
+  }
+  if (!is_open_.exchange(true)) {
+    receive_thread_ = std::thread([this] { reader_loop(); });
+  }
+  return true;
+}
+
+auto PtyMasterInterface::close() -> bool {
+  if (is_open_.exchange(false) && receive_thread_.joinable()) {
+    receive_thread_.join();
+  }
+  return true;
+}
+
+void PtyMasterInterface::reader_loop() {
+  while (is_open_) {
+    const int COUNT = read(receive_buffer_.data(), receive_buffer_.size());
+    if (COUNT <= 0) {
+      continue;
+    }
+    size_t read = 0;
+    m_callbacks.for_each([&](CallbackType& callback) {
+      callback({receive_buffer_.data(), static_cast<size_t>(COUNT)}, read);
+    });
+  }
+}
+
+auto PtyMasterInterface::read(uint8_t* buffer, const size_t COUNT) -> int {
+  pollfd pfd{master_, POLLIN, 0};
+  if (poll(&pfd, 1, 100) <= 0 || (pfd.revents & POLLIN) == 0) {
+    return 0;  // таймаут: заодно проверяем is_open_
+  }
+  const ssize_t READ = ::read(master_, buffer, COUNT);
+  return READ > 0 ? static_cast<int>(READ) : 0;
+}
+}  // namespace proto::interface
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CustomSpan.hpp"
+#include "Interface.hpp"
+#include "UartLinux.hpp"
+
+namespace proto::interface {
+/**
+ * @brief Master side of a pseudo terminal, acting as the device at the far
+ * end of a serial line.
+ *
+ * The slave side (slave_path()) is a real tty: open it with
+ * UartLinuxInterface::open_uart() and every byte goes through termios and the
+ * line discipline, as with a USB-serial adapter, but without hardware.
+ *
+ * open() starts a reader thread that feeds the receive callbacks. Tests that
+ * want to read the master descriptor themselves use fd() and leave the
+ * interface closed.
+ */
+class PtyMasterInterface final : public IInterface {
+ public:
+  /// @throws std::runtime_error if no pseudo terminal is available.
+  PtyMasterInterface();
+  ~PtyMasterInterface() override;
+
+  PtyMasterInterface(const PtyMasterInterface&) = delete;
+  auto operator=(const PtyMasterInterface&) -> PtyMasterInterface& = delete;
+
+  auto write(CustomSpan<uint8_t> buffer, std::chrono::milliseconds timeout)
+      -> bool override;
+
+  auto is_open() -> bool override;
+
+  /// @brief Start the reader thread.
+  auto open() -> bool override;
+
+  /// @brief Stop the reader thread; the pseudo terminal stays allocated.
+  auto close() -> bool override;
+
+  /// @brief Stop reading and close the master: the slave side sees a hang-up.
+  void hang_up();
+
+  [[nodiscard]] auto fd() const -> int { return master_; }
+  [[nodiscard]] auto slave_path() const -> const std::string& {
+    return slave_path_;
+  }
+
+ private:
+  int master_{-1};
+  // Kept open so the master never reports a hang-up while the port under
+  // test is closed or reopening.
+  int slave_{-1};
+  std::string slave_path_;
+  std::atomic_bool is_open_{false};
+  std::mutex write_mtx_;
+  std::thread receive_thread_;
+  std::vector<uint8_t> receive_buffer_ = std::vector<uint8_t>(4096);
+
+  void reader_loop();
+  auto read(uint8_t* buffer, size_t count) -> int override;
+};
+
+/**
+ * @brief A pseudo terminal with UartLinuxInterface opened on the slave side.
+ *
+ * @code{.cpp}
+ * PtyPair pty;
+ * host.set_interfaces(pty.m_uart, pty.m_uart);       // code under test
+ * board.set_interfaces(pty.m_device, pty.m_device);  // simulated device
+ * @endcode
+ */
+struct PtyPair {
+  PtyMasterInterface m_device;
+  UartLinuxInterface m_uart;
+
+  /// @param BAUDRATE Only stored by the pty; it does not throttle the link.
+  explicit PtyPair(const int BAUDRATE = 115200,
+                   const UartReadProfile& profile = {}) {
+    m_uart.set_read_profile(profile);
+    m_uart.open_uart(m_device.slave_path(), BAUDRATE);
+    m_device.open();
+  }
+  /// @brief Same, with the port served by @p reactor.
+  explicit PtyPair(EpollReactor& reactor, const int BAUDRATE = 115200)
+      : m_uart(reactor) {
+    m_uart.open_uart(m_device.slave_path(), BAUDRATE);
+    m_device.open();
+  }
+  /// @brief Same, with the port served by an io_uring reactor.
+  explicit PtyPair(UringReactor& reactor, const int BAUDRATE = 115200)
+      : m_uart(reactor) {
+    m_uart.open_uart(m_device.slave_path(), BAUDRATE);
+    m_device.open();
+  }
+  ~PtyPair() {
+    m_uart.close();
+    m_device.close();
+  }
+  PtyPair(const PtyPair&) = delete;
+  auto operator=(const PtyPair&) -> PtyPair& = delete;
+};
+}  // namespace proto::interface
@@ -92,9 +92,11 @@ class VirtualBoard {
     m_rfid_data.m_timeCounter = VAL;
   }
 
-  LacteBoardProtocol<RX_BASE, TX_BASE> m_board_proto;
+  // Interfaces come first so they outlive m_board_proto: its dispatcher
+  // thread may still be answering through them while the board is destroyed.
   interface::EchoInterface m_from_host_interface;
   interface::EchoInterface m_from_board_interface;
+  LacteBoardProtocol<RX_BASE, TX_BASE> m_board_proto;
   interface::Delegate m_host_interface_send_delegate;
 
   interface::Delegate m_board_interface_send_delegate;
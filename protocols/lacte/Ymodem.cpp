@@ -9,6 +9,7 @@
 #include <iostream>
 #include <mutex>
 
+#include "CrcEngine.hpp"
 #include "Ymodem.hpp"
 using namespace std::chrono_literals;
 
@@ -26,14 +27,7 @@ YmodemPrerelease::YmodemPrerelease(proto::interface::IInterface& interface)
 
 auto YmodemPrerelease::crc16(const uint8_t* data, const size_t LENGTH)
     -> uint16_t {
-  uint16_t crc = 0x0000;
-  for (size_t i = 0; i < LENGTH; ++i) {
-    crc ^= static_cast<uint16_t>(data[i]) << CHAR_BIT;
-    for (int j = 0; j < CHAR_BIT; ++j) {
-      crc = (crc & 0x8000) != 0 ? crc << 1 ^ 0x1021 : crc << 1;
-    }
-  }
-  return crc;
+  return static_cast<uint16_t>(Crc16Xmodem::compute(data, LENGTH));
 }
 
 void YmodemPrerelease::send_block(const uint8_t BLOCK_NUMBER,
@@ -36,7 +36,8 @@ class YmodemPrerelease {
   auto wait(uint8_t VAL, size_t) -> bool;
 
   /**
-   * Вычисление CRC-16 (Modbus/CCITT) для блока данных.
+   * Вычисление CRC-16/XMODEM (полином 0x1021, начальное значение 0) для
+   * блока данных.
    */
   static auto crc16(const uint8_t* data, std::size_t LENGTH) -> uint16_t;
 